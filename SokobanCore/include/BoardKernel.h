@@ -0,0 +1,163 @@
+#ifndef SOKOBANGAME_BOARDKERNEL_H
+#define SOKOBANGAME_BOARDKERNEL_H
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "GameMap.h"
+#include "Position.h"
+#include "enums/EFacing.h"
+
+// Fixed-size bitset over the cells of a BoardKernel.
+template <int Bits>
+struct Bitboard {
+    static constexpr int WordCount = (Bits + 63) / 64;
+
+    std::array<uint64_t, WordCount> words{};
+
+    bool test(int bit) const { return (words[bit >> 6] >> (bit & 63)) & 1u; }
+    void set(int bit) { words[bit >> 6] |= uint64_t(1) << (bit & 63); }
+    void reset(int bit) { words[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+};
+
+// The move rules of Game for boards of at most MaxW x MaxH cells, with the
+// walls, targets and boxes held in bitboards. The map is stored one cell in
+// from the top-left corner with walls all around it, so every direction is
+// a constant index offset and no bounds checks are needed. A move is two
+// bit tests, a push two more plus a reset and a set. Nothing is virtual and
+// no observers are notified; it is meant for simulations that replay many
+// moves, not for driving the UI.
+template <int MaxW, int MaxH>
+class BoardKernel {
+public:
+    static constexpr int Stride = MaxW;
+    static constexpr int CellCount = MaxW * MaxH;
+    using Board = Bitboard<CellCount>;
+
+    static_assert(static_cast<int>(EFacing::LEFT) == 0 && static_cast<int>(EFacing::UP) == 1 &&
+                  static_cast<int>(EFacing::DOWN) == 2 && static_cast<int>(EFacing::RIGHT) == 3,
+                  "Offsets are indexed by EFacing");
+    static constexpr std::array<int, 4> Offsets = {-1, -Stride, Stride, 1};
+
+    // The map plus its wall border fits in the kernel.
+    static bool fits(const GameMap& map) {
+        return map.getWidth() + 2 <= MaxW && map.getHeight() + 2 <= MaxH;
+    }
+
+    explicit BoardKernel(const GameMap& map)
+        : _player(0),
+          _startPlayer(0)
+    {
+        if (!fits(map)) {
+            throw std::runtime_error("Level does not fit in the board kernel");
+        }
+        for (int cell = 0; cell < CellCount; ++cell) {
+            _walls.set(cell);
+        }
+        for (int row = 0; row < map.getHeight(); ++row) {
+            for (int col = 0; col < map.getWidth(); ++col) {
+                int cell = toCell(Position(row, col));
+                ETileType tile = map.getTileAt(row, col);
+                if (tile != ETileType::WALL) {
+                    _walls.reset(cell);
+                }
+                if (tile == ETileType::TARGET) {
+                    _targets.set(cell);
+                }
+            }
+        }
+        auto checkBounds = [&map](const Position& pos) {
+            if (pos.getRow() < 0 || pos.getRow() >= map.getHeight() || pos.getCol() < 0 ||
+                pos.getCol() >= map.getWidth()) {
+                throw std::runtime_error("Level position out of bounds");
+            }
+        };
+        checkBounds(map.getPlayerStart());
+        _startPlayer = toCell(map.getPlayerStart());
+        for (const auto& box : map.getBoxPositions()) {
+            checkBounds(box);
+            _startBoxes.set(toCell(box));
+        }
+        reset();
+    }
+
+    void reset() {
+        _player = _startPlayer;
+        _boxes = _startBoxes;
+    }
+
+    // Same rules as Game::applyMove; false if the move is blocked.
+    bool move(EFacing direction, bool& pushed) {
+        const int offset = Offsets[static_cast<int>(direction)];
+        const int next = _player + offset;
+        pushed = false;
+        if (_walls.test(next)) {
+            return false;
+        }
+        if (_boxes.test(next)) {
+            const int beyond = next + offset;
+            if (_walls.test(beyond) || _boxes.test(beyond)) {
+                return false;
+            }
+            _boxes.reset(next);
+            _boxes.set(beyond);
+            pushed = true;
+        }
+        _player = next;
+        return true;
+    }
+
+    // Every box is on a target; only a push can change this.
+    bool isSolved() const {
+        for (int i = 0; i < Board::WordCount; ++i) {
+            if (_boxes.words[i] & ~_targets.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int toCell(const Position& pos) const { return (pos.getRow() + 1) * Stride + pos.getCol() + 1; }
+    Position toPosition(int cell) const { return Position(cell / Stride - 1, cell % Stride - 1); }
+
+    Position getPlayerPosition() const { return toPosition(_player); }
+    // Boxes in row-major order.
+    std::vector<Position> getBoxPositions() const {
+        std::vector<Position> boxes;
+        for (int cell = 0; cell < CellCount; ++cell) {
+            if (_boxes.test(cell)) {
+                boxes.push_back(toPosition(cell));
+            }
+        }
+        return boxes;
+    }
+
+private:
+    int _player;
+    int _startPlayer;
+    Board _walls;
+    Board _targets;
+    Board _boxes;
+    Board _startBoxes;
+};
+
+// Calls fn with the smallest kernel the map fits in. The size is checked
+// once here, so everything fn does with the kernel is compiled for that size.
+template <typename Fn>
+auto withBoardKernel(const GameMap& map, Fn&& fn) {
+    if (BoardKernel<16, 16>::fits(map)) {
+        BoardKernel<16, 16> kernel(map);
+        return fn(kernel);
+    }
+    if (BoardKernel<32, 32>::fits(map)) {
+        BoardKernel<32, 32> kernel(map);
+        return fn(kernel);
+    }
+    if (BoardKernel<64, 64>::fits(map)) {
+        BoardKernel<64, 64> kernel(map);
+        return fn(kernel);
+    }
+    throw std::runtime_error("Level is too large for the board kernel");
+}
+
+#endif
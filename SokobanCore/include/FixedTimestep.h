@@ -0,0 +1,24 @@
+#ifndef SOKOBANGAME_FIXEDTIMESTEP_H
+#define SOKOBANGAME_FIXEDTIMESTEP_H
+
+// Accumulates variable frame times into a whole number of fixed logic
+// ticks, so game logic runs at the same rate whatever the frame rate.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double tickSeconds = 1.0 / 20.0, int maxTicksPerFrame = 8);
+
+    // Adds the time since the last frame and returns how many ticks are due.
+    // A long stall is capped at maxTicksPerFrame instead of being replayed.
+    int advance(double elapsedSeconds);
+    // How far the next tick has progressed, in [0, 1), for interpolation.
+    float getAlpha() const;
+    double getTickSeconds() const { return _tickSeconds; }
+    void reset() { _accumulator = 0.0; }
+
+private:
+    double _tickSeconds;
+    int _maxTicksPerFrame;
+    double _accumulator;
+};
+
+#endif
@@ -2,17 +2,23 @@
 #define ISPROJECT_GAME_H
 #include "interfaces/IGame.h"
 #include "GameMap.h"
+#include <cstdint>
 #include <vector>
 #include "interfaces/IGameObserver.h"
 #include "Box.h"
+#include "MoveHistory.h"
 #include "Player.h"
 
+class TelemetryRecorder;
+
 class Game: public IGame{
 public:
     Game();
     void loadLevel(int levelNumber) override;
+    void loadLevel(const GameMap& map);
     void movePlayer(EFacing direction) override;
     void restartLevel() override;
+    int getLevelId() override;
     void addObserver(IGameObserver *observer) override;
     void removeObserver(IGameObserver *observer) override;
     void notify(EGameEvent event) override;
@@ -24,8 +30,18 @@ public:
     Position getPlayerPosition() override;
     const std::vector<Position> & getBoxPositions() override;
     int getMoveCount() override;
+    // Moves made after moveIndex stay available until a new move is made.
+    void seekMove(int moveIndex) override;
+    int getHistoryLength() override;
+    void checkLevelSource() override;
+    const MoveHistory& getHistory() const { return _history; }
+    // Every notified event is also recorded here when set.
+    void setTelemetry(TelemetryRecorder* telemetry) { _telemetry = telemetry; }
     
 private:
+    void resetToMapStart();
+    // Core move rules without notifications or history; false if blocked.
+    bool applyMove(EFacing direction, bool& pushed);
     bool isPositionWalkable(const Position& pos) const;
     bool isBoxAt(const Position& pos) const;
     Box* getBoxAt(const Position& pos);
@@ -35,8 +51,16 @@ private:
     GameMap _currentMap;
     Player _player;
     std::vector<Box> _boxes;
+    std::vector<Position> _boxPositions;
+    MoveHistory _history;
+    Position _lastPushedBox;
+    TelemetryRecorder* _telemetry;
     int _moveCount;
     int _currentLevel;
+    // Revision in LevelIndex::shared() of the loaded level; only levels
+    // loaded by number are checked.
+    bool _fromLevelIndex;
+    uint64_t _levelRevision;
     EGameState _gameState;
 };
 
@@ -1,15 +1,26 @@
 #ifndef ISPROJECT_GAMEMAP_H
 #define ISPROJECT_GAMEMAP_H
 #include <vector>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
 #include "Tile.h"
 #include "Position.h"
 #include "interfaces/IGameMap.h"
+#include "interfaces/IGame.h"
 
 class GameMap: public IGameMap{
 public:
     GameMap();
+    GameMap(int id, const std::string& name, std::vector<std::vector<Tile>> grid,
+            Position playerStart, std::vector<Position> boxPositions);
+    // Current state of a running game as a level whose start is that state.
+    static GameMap capture(IGame& game);
+
     void load(int levelNumber) override;
+    void loadFromJson(const nlohmann::json& level);
     
+    int getId() const;
+    const std::string& getName() const;
     int getWidth() const;
     int getHeight() const;
     ETileType getTileAt(int row, int col) const;
@@ -20,6 +31,8 @@ private:
     std::vector<std::vector<Tile>> _grid;
     Position _playerStart;
     std::vector<Position> _boxPositions;
+    int _id;
+    std::string _name;
     int _width;
     int _height;
 };
@@ -0,0 +1,32 @@
+#ifndef SOKOBANGAME_INPUTQUEUE_H
+#define SOKOBANGAME_INPUTQUEUE_H
+#include <array>
+#include <cstddef>
+#include "enums/EFacing.h"
+#include "enums/EInputCommand.h"
+
+// Fixed-size FIFO between input polling, which runs every frame, and the
+// logic tick that drains it. Keys pressed between two ticks wait here and
+// are applied in order on the next one.
+class InputQueue {
+public:
+    static constexpr size_t Capacity = 64;
+
+    InputQueue();
+
+    // Returns false and drops the command when the queue is full.
+    bool push(EInputCommand command);
+    bool pop(EInputCommand& command);
+    void clear();
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+    static bool toFacing(EInputCommand command, EFacing& direction);
+
+private:
+    std::array<EInputCommand, Capacity> _commands;
+    size_t _head;
+    size_t _count;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SOKOBANGAME_LEVELINDEX_H
+#define SOKOBANGAME_LEVELINDEX_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "GameMap.h"
+
+// Lazy view of a level pack. The file is read and split into one slice per
+// level on first use, but a level is only parsed when it is asked for, and
+// parsed levels are kept. The file is re-read when it changes on disk; only
+// levels whose text changed are parsed again, everything else is kept as
+// it was. Thread-safe, so levels can be prefetched in the background.
+class LevelIndex {
+public:
+    explicit LevelIndex(const std::string& path);
+    ~LevelIndex();
+    LevelIndex(const LevelIndex&) = delete;
+    LevelIndex& operator=(const LevelIndex&) = delete;
+
+    // Index over levels.json in the working directory, used by GameMap::load.
+    static LevelIndex& shared();
+
+    GameMap get(int levelId);
+    // Parses the level now so a later get() is a copy; errors are ignored.
+    void prefetch(int levelId);
+    size_t count();
+    const std::string& getPath() const { return _path; }
+
+    // Re-reads the file if it changed on disk and returns the ids of the
+    // levels that were edited, added or removed. A file that cannot be
+    // split into levels, e.g. one caught halfway through a save, is ignored
+    // until it changes again.
+    std::vector<int> reload();
+    // Grows every time a reload changes the level; 0 if it never changed.
+    uint64_t getRevision(int levelId);
+
+    // Reloads in the background as soon as the file is written: inotify on
+    // Linux, a modification time check twice a second elsewhere.
+    void startWatching();
+    void stopWatching();
+
+private:
+    struct Slice {
+        size_t begin;
+        size_t end;
+        uint64_t hash;
+        bool parsed;
+    };
+
+    std::vector<int> refresh();
+    std::vector<Slice> split(const std::string& contents) const;
+    std::vector<int> merge(std::string contents, std::vector<Slice> slices);
+    bool parseNext();
+    int parseSlice(size_t index);
+    void watch();
+
+    std::string _path;
+    std::mutex _mutex;
+    bool _scanned;
+    std::filesystem::file_time_type _modified;
+    std::uintmax_t _size;
+    std::string _contents;
+    std::vector<Slice> _slices;
+    size_t _nextSlice;
+    std::unordered_map<int, GameMap> _levels;
+    std::unordered_map<int, std::string> _errors;
+    // Slice hash of every parsed level, good or malformed.
+    std::unordered_map<int, uint64_t> _hashes;
+    std::unordered_map<int, uint64_t> _revisions;
+    uint64_t _revision;
+    std::atomic<bool> _watching;
+    std::thread _watcher;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SOKOBANGAME_MOVEHISTORY_H
+#define SOKOBANGAME_MOVEHISTORY_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+#include "enums/EFacing.h"
+
+// Every move of a session as a one-byte delta, plus a full snapshot of the
+// player and boxes every checkpointInterval moves. Any move index can be
+// rebuilt from the closest snapshot before it by replaying at most
+// checkpointInterval deltas. Positions are stored as row * width + col.
+class MoveHistory {
+public:
+    explicit MoveHistory(int checkpointInterval = 256);
+
+    // Starts a new session whose move 0 is the given position.
+    void reset(int width, const Position& player, const std::vector<Position>& boxes);
+    // Appends the move that led to the current position. When it returns
+    // true a checkpoint is due and must be added before the next record.
+    bool record(EFacing direction, bool pushed);
+    void addCheckpoint(const Position& player, const std::vector<Position>& boxes);
+    // Forgets every move after length, e.g. when playing on from the past.
+    void truncate(int length);
+
+    // Loads the latest checkpoint at or before moveIndex and returns its index.
+    int restore(int moveIndex, Position& player, std::vector<Position>& boxes) const;
+
+    int size() const { return static_cast<int>(_moves.size()); }
+    EFacing getDirection(int move) const { return static_cast<EFacing>(_moves[move] & DirectionMask); }
+    bool isPush(int move) const { return (_moves[move] & PushFlag) != 0; }
+    int getCheckpointInterval() const { return _checkpointInterval; }
+    size_t getCheckpointCount() const { return _checkpointMoves.size(); }
+    size_t getMemoryBytes() const;
+
+private:
+    static constexpr uint8_t DirectionMask = 0x03;
+    static constexpr uint8_t PushFlag = 0x04;
+
+    uint32_t toCell(const Position& pos) const;
+    Position toPosition(uint32_t cell) const;
+
+    int _checkpointInterval;
+    int _width;
+    size_t _boxCount;
+    std::vector<uint8_t> _moves;
+    // Sorted move indices, and the snapshot of each: player then boxes.
+    std::vector<int> _checkpointMoves;
+    std::vector<uint32_t> _checkpointCells;
+};
+
+#endif
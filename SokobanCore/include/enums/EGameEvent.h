@@ -5,5 +5,7 @@ enum class EGameEvent {
     BOX_MOVED,
     LEVEL_RELOADED,
     LEVEL_WON,
+    HISTORY_SEEKED,
+    LEVEL_SOURCE_CHANGED,
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef SOKOBANGAME_EINPUTCOMMAND_H
+#define SOKOBANGAME_EINPUTCOMMAND_H
+enum class EInputCommand {
+    MOVE_LEFT,
+    MOVE_UP,
+    MOVE_DOWN,
+    MOVE_RIGHT,
+    RESTART,
+    NEXT_LEVEL,
+    TOGGLE_HINT,
+};
+#endif
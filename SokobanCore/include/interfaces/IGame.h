@@ -16,6 +16,8 @@ public:
     virtual void loadLevel(int levelNumber) = 0;
     virtual void movePlayer(EFacing direction) = 0;
     virtual void restartLevel() = 0;
+    // Id of the loaded level, as in the level pack.
+    virtual int getLevelId() = 0;
     virtual EGameState getCurrentState() = 0;
     virtual int getLevelWidth() = 0;
     virtual int getLevelLength() = 0;
@@ -23,6 +25,12 @@ public:
     virtual Position getPlayerPosition() = 0;
     virtual const std::vector<Position>& getBoxPositions() = 0;
     virtual int getMoveCount() = 0;
+    // Jumps to the position after moveIndex moves of the current session.
+    virtual void seekMove(int moveIndex) = 0;
+    virtual int getHistoryLength() = 0;
+    // Notifies LEVEL_SOURCE_CHANGED once when the current level was edited
+    // in the level pack since it was loaded.
+    virtual void checkLevelSource() = 0;
 };
 
 #endif
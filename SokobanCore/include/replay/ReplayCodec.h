@@ -0,0 +1,67 @@
+#ifndef SOKOBANGAME_REPLAYCODEC_H
+#define SOKOBANGAME_REPLAYCODEC_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameMap.h"
+
+// File layout shared by ReplayWriter and ReplayReader, little-endian:
+// the magic, the version and reserved flags, then the records back to back,
+// then the index and a fixed-size footer. A record is a varint holding the
+// level slot and the encoding, varints for the move and push counts, the
+// payload size unless the payload is Packed, and the payload. The index lists the
+// content hash and id of every level slot and the offset of every
+// RecordsPerBlock-th record; the footer points at the index.
+namespace ReplayFormat {
+    constexpr char Magic[8] = {'S', 'K', 'B', 'R', 'E', 'P', 'L', 'Y'};
+    constexpr uint32_t Version = 1;
+    constexpr char IndexMagic[4] = {'S', 'K', 'B', 'I'};
+    constexpr size_t HeaderSize = 16;
+    // Index offset, record count, records per block and IndexMagic.
+    constexpr size_t FooterSize = 24;
+    constexpr uint32_t RecordsPerBlock = 64;
+
+    enum Encoding : uint8_t {
+        // Four moves per byte, two bits each, first move in the low bits.
+        Packed = 0,
+        // One byte per run of equal moves: the direction in the low two bits,
+        // the run length minus one in the upper six.
+        RunLength = 1,
+        // The same with one nibble per run of at most four moves, the low
+        // nibble first; suits the short walks that most sessions are made of.
+        ShortRuns = 2,
+    };
+}
+
+struct ReplayInfo {
+    uint64_t levelHash = 0;
+    int levelId = 0;
+    uint32_t moves = 0;
+    uint32_t pushes = 0;
+    uint8_t encoding = ReplayFormat::Packed;
+    // Points into the reader's copy of the file.
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
+};
+
+// Move streams of replays. Only directions are stored: which moves are
+// pushes follows from the level, so it is recovered by replaying the moves
+// on it instead of costing a bit per move.
+class ReplayCodec {
+public:
+    // Takes l/u/r/d in either case and picks the smallest encoding. False if
+    // the solution has any other character.
+    static bool encode(const std::string& lurd, std::vector<uint8_t>& payload, uint8_t& encoding);
+
+    // Writes exactly moves lowercase steps to out. False if the payload does
+    // not hold exactly that many moves.
+    static bool decode(const uint8_t* payload, size_t size, uint8_t encoding, uint32_t moves, char* out);
+
+    // Uppercases the steps that push a box on map. False if a step is
+    // blocked or follows the solving push, in which case lurd is left partly
+    // marked.
+    static bool restorePushes(const GameMap& map, std::string& lurd);
+};
+
+#endif
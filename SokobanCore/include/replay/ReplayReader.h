@@ -0,0 +1,58 @@
+#ifndef SOKOBANGAME_REPLAYREADER_H
+#define SOKOBANGAME_REPLAYREADER_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "replay/ReplayCodec.h"
+
+// Reads archives written by ReplayWriter. The file is memory-mapped, and
+// the block index in its footer lets any record be reached by skipping at
+// most RecordsPerBlock - 1 record headers, so ranges of an archive can be
+// decoded on separate threads. Reading is thread-safe.
+class ReplayReader {
+public:
+    // Throws std::runtime_error if the file is not a complete archive.
+    explicit ReplayReader(const std::string& path);
+    ~ReplayReader();
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    size_t size() const { return _count; }
+    size_t getFileSize() const { return _mappedSize; }
+
+    ReplayInfo get(size_t index) const;
+    // Lowercase steps; use ReplayCodec::restorePushes for the push case.
+    std::string decode(const ReplayInfo& info) const;
+
+    // Calls fn(index, info) for the records in [first, last), seeking only
+    // once.
+    template <typename Fn>
+    void forEach(size_t first, size_t last, Fn&& fn) const {
+        size_t offset = seek(first);
+        for (size_t index = first; index < last && index < _count; ++index) {
+            ReplayInfo info;
+            offset = parse(offset, info);
+            fn(index, info);
+        }
+    }
+
+private:
+    void mapFile();
+    void readIndex();
+    size_t seek(size_t index) const;
+    // Returns the offset of the next record. Throws on a corrupt record.
+    size_t parse(size_t offset, ReplayInfo& info) const;
+
+    std::string _path;
+    const uint8_t* _mapped;
+    size_t _mappedSize;
+    std::vector<uint8_t> _buffer;
+    size_t _count;
+    size_t _recordsEnd;
+    std::vector<uint64_t> _blocks;
+    std::vector<uint64_t> _levelHashes;
+    std::vector<int> _levelIds;
+};
+
+#endif
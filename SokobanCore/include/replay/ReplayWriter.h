@@ -0,0 +1,50 @@
+#ifndef SOKOBANGAME_REPLAYWRITER_H
+#define SOKOBANGAME_REPLAYWRITER_H
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "replay/ReplayCodec.h"
+
+// Writes a replay archive record by record; nothing but the block index is
+// kept in memory, so archives of any size can be streamed out. The file is
+// only readable once finish() has written the index.
+class ReplayWriter {
+public:
+    explicit ReplayWriter(const std::string& path);
+    // Finishes the file if finish() was not called, ignoring errors.
+    ~ReplayWriter();
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    // levelHash is SolutionCache::contentHash of the level the session was
+    // played on. Throws std::runtime_error if lurd is not a LURD string.
+    void add(uint64_t levelHash, int levelId, const std::string& lurd);
+    // Appends an encoded record as is, e.g. when merging archives.
+    void add(const ReplayInfo& info);
+
+    void finish();
+
+    uint64_t getCount() const { return _count; }
+    uint64_t getBytesWritten() const { return _offset; }
+
+private:
+    uint32_t getSlot(uint64_t levelHash, int levelId);
+    void flushBuffer();
+
+    std::string _path;
+    std::ofstream _file;
+    std::vector<uint8_t> _buffer;
+    std::vector<uint8_t> _payload;
+    uint64_t _offset;
+    uint64_t _count;
+    bool _finished;
+    // Offset of every RecordsPerBlock-th record.
+    std::vector<uint64_t> _blocks;
+    std::vector<std::pair<uint64_t, int>> _levels;
+    std::unordered_map<uint64_t, uint32_t> _slots;
+};
+
+#endif
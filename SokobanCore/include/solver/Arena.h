@@ -0,0 +1,90 @@
+#ifndef SOKOBANGAME_ARENA_H
+#define SOKOBANGAME_ARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bump allocator for search data. Individual allocations are never freed;
+// everything is returned to the system at once by release().
+class BumpArena {
+public:
+    explicit BumpArena(size_t blockSize = 1 << 20);
+    ~BumpArena();
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void release();
+
+    size_t getBytesReserved() const { return _bytesReserved; }
+    size_t getPeakBytesReserved() const { return _peakBytesReserved; }
+    uint64_t getAllocationCount() const { return _allocationCount; }
+    uint64_t getSystemAllocationCount() const { return _systemAllocationCount; }
+
+private:
+    void addBlock(size_t minimumSize);
+
+    std::vector<char*> _blocks;
+    size_t _blockSize;
+    char* _cursor;
+    char* _end;
+    size_t _bytesReserved;
+    size_t _peakBytesReserved;
+    uint64_t _allocationCount;
+    uint64_t _systemAllocationCount;
+};
+
+// Fixed-size slots carved out of a BumpArena in chunks. The slot size is
+// chosen at runtime so records can carry inline arrays sized per level.
+class NodePool {
+public:
+    NodePool(BumpArena& arena, size_t slotSize, size_t slotsPerChunk = 4096);
+
+    void* allocate();
+    void free(void* slot);
+    uint64_t getLiveCount() const { return _liveCount; }
+    uint64_t getPeakLiveCount() const { return _peakLiveCount; }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    BumpArena& _arena;
+    size_t _slotSize;
+    size_t _slotsPerChunk;
+    char* _cursor;
+    char* _end;
+    FreeSlot* _freeList;
+    uint64_t _liveCount;
+    uint64_t _peakLiveCount;
+};
+
+// Standard allocator adapter so containers used during a search draw from
+// the same arena. deallocate() is a no-op, memory goes back on release().
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(BumpArena& arena) : _arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.getArena()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+
+    BumpArena* getArena() const { return _arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return _arena == other.getArena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return _arena != other.getArena(); }
+
+private:
+    BumpArena* _arena;
+};
+
+#endif
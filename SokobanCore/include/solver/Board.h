@@ -0,0 +1,76 @@
+#ifndef SOKOBANGAME_BOARD_H
+#define SOKOBANGAME_BOARD_H
+#include <cstdint>
+#include <vector>
+#include "GameMap.h"
+#include "Position.h"
+#include "enums/EFacing.h"
+
+// Static, search-friendly view of a GameMap. Cells are flattened to
+// row * width + col; every cell the player cannot reach from the start is
+// treated as a wall so searches never leave the playable area.
+class Board {
+public:
+    static constexpr int DirectionCount = 4;
+    static constexpr int Unreachable = -1;
+
+    explicit Board(const GameMap& map);
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+    int getCellCount() const { return _width * _height; }
+
+    int toCell(const Position& pos) const { return pos.getRow() * _width + pos.getCol(); }
+    Position toPosition(int cell) const { return Position(cell / _width, cell % _width); }
+
+    bool isFloor(int cell) const { return _floor[cell] != 0; }
+    bool isTarget(int cell) const { return _target[cell] != 0; }
+    bool isDead(int cell) const { return _dead[cell] != 0; }
+
+    // Neighbouring cell in the given direction, or -1 when it would leave the grid.
+    int neighbor(int cell, int direction) const;
+    // Minimum number of pushes needed to bring a box on this cell to any target.
+    int goalDistance(int cell) const { return _goalDistance[cell]; }
+
+    // Corridor cell along the direction's axis: floor in front and behind,
+    // no floor on either side.
+    bool isTunnel(int cell, int direction) const;
+    // Removing this cell splits the floor into disconnected parts.
+    bool isArticulation(int cell) const { return _articulation[cell] != 0; }
+
+    int getFloorCount() const { return _floorCount; }
+    int getDeadCount() const { return _deadCount; }
+    int getTunnelCount() const { return _tunnelCount; }
+    int getArticulationCount() const { return _articulationCount; }
+    const std::vector<int>& getTargets() const { return _targets; }
+    const std::vector<int>& getInitialBoxes() const { return _initialBoxes; }
+    int getPlayerStart() const { return _playerStart; }
+
+    static EFacing toFacing(int direction);
+    static int toDirection(EFacing facing);
+    static int opposite(int direction) { return DirectionCount - 1 - direction; }
+
+private:
+    void computeFloor();
+    void computeGoalDistances();
+    void computeTunnels();
+    void computeArticulationPoints();
+
+    int _width;
+    int _height;
+    std::vector<uint8_t> _floor;
+    std::vector<uint8_t> _target;
+    std::vector<uint8_t> _dead;
+    std::vector<uint8_t> _tunnel;
+    std::vector<uint8_t> _articulation;
+    std::vector<int> _goalDistance;
+    std::vector<int> _targets;
+    std::vector<int> _initialBoxes;
+    int _playerStart;
+    int _floorCount;
+    int _deadCount;
+    int _tunnelCount;
+    int _articulationCount;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SOKOBANGAME_HINTENGINE_H
+#define SOKOBANGAME_HINTENGINE_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "GameMap.h"
+#include "Position.h"
+#include "enums/EFacing.h"
+#include "solver/Board.h"
+#include "solver/SearchContext.h"
+#include "solver/SolutionCache.h"
+
+struct Hint {
+    // A push is suggested: stand behind box and push it towards direction.
+    bool available = false;
+    // The position can no longer be solved, whatever the player does.
+    bool deadlocked = false;
+    Position box = Position(0, 0);
+    EFacing direction = EFacing::UP;
+    int pushesLeft = 0;
+};
+
+// Searches for the next push on a background thread. Every solution found
+// is remembered push by push, so as long as the player follows the hints
+// the next one is a table lookup instead of a new search. A new request or
+// cancel() aborts whatever search is running.
+class HintEngine {
+public:
+    HintEngine();
+    ~HintEngine();
+    HintEngine(const HintEngine&) = delete;
+    HintEngine& operator=(const HintEngine&) = delete;
+
+    // Non-blocking; both may be called every frame. Only a search from the
+    // level's start is stored in the cache: every other state is a new key
+    // that would never be looked up again.
+    void request(const GameMap& state, bool atLevelStart = false);
+    void cancel();
+    bool getHint(Hint& hint) const;
+    bool isSearching() const { return _searching; }
+    // Optional; must outlive the engine. Looked up before every search.
+    void setCache(SolutionCache* cache);
+
+private:
+    struct PlannedPush {
+        int box;
+        int direction;
+        int pushesLeft;
+    };
+
+    void run();
+    bool compute(const GameMap& state, SolutionCache* cache, bool atLevelStart, Hint& hint);
+    void prepareLevel(const GameMap& state);
+    std::string stateKey(const std::vector<int>& boxes, int player);
+    void rememberSolution(const GameMap& state, const std::string& solution);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    GameMap _pending;
+    bool _pendingAtStart;
+    bool _hasRequest;
+    bool _shutdown;
+    uint64_t _generation;
+    Hint _hint;
+    bool _hintReady;
+    std::atomic<bool> _cancel;
+    std::atomic<bool> _searching;
+    SolutionCache* _cache;
+
+    // Owned by the worker thread.
+    std::vector<ETileType> _levelTiles;
+    std::unique_ptr<Board> _board;
+    std::unique_ptr<SearchContext> _context;
+    std::unordered_map<std::string, PlannedPush> _plan;
+
+    std::thread _worker;
+};
+
+#endif
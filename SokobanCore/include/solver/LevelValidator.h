@@ -0,0 +1,21 @@
+#ifndef SOKOBANGAME_LEVELVALIDATOR_H
+#define SOKOBANGAME_LEVELVALIDATOR_H
+#include <string>
+#include <vector>
+#include "GameMap.h"
+#include "solver/SolutionCache.h"
+
+struct ValidationReport {
+    std::vector<std::string> errors;
+    bool isValid() const { return errors.empty(); }
+};
+
+// Structural checks GameMap::load does not perform. Solvability is left to
+// the Solver since it can be arbitrarily expensive. With a cache, levels
+// that passed before are not checked again.
+class LevelValidator {
+public:
+    static ValidationReport validate(const GameMap& map, SolutionCache* cache = nullptr);
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef SOKOBANGAME_LURD_H
+#define SOKOBANGAME_LURD_H
+#include <string>
+#include "GameMap.h"
+#include "enums/EFacing.h"
+
+// Standard Sokoban solution notation: one character per step, l/u/r/d for
+// walks and L/U/R/D for pushes.
+class Lurd {
+public:
+    static char toChar(EFacing direction, bool push);
+    static bool toFacing(char step, EFacing& direction);
+    static bool isPush(char step) { return step >= 'A' && step <= 'Z'; }
+    static int countPushes(const std::string& solution);
+
+    // Replays the solution through Game and reports whether it wins the level
+    // with every push written in uppercase and every walk in lowercase.
+    static bool verify(const GameMap& map, const std::string& solution);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SOKOBANGAME_PLAYOUTENGINE_H
+#define SOKOBANGAME_PLAYOUTENGINE_H
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "GameMap.h"
+#include "solver/Board.h"
+
+struct PlayoutOptions {
+    // Total number of playouts, shared between all threads.
+    uint64_t playouts = 1000000;
+    // Worker threads; 0 uses every hardware thread.
+    unsigned threads = 0;
+    // A playout gives up after this many pushes; 0 derives a limit from the floor size.
+    int maxPushes = 0;
+    // Pick pushes with a per-thread UCT tree instead of uniformly at random.
+    bool mcts = false;
+    // UCB1 exploration constant of the tree policy.
+    double exploration = 1.4;
+    // Nodes each thread's tree may grow to before it stops expanding.
+    size_t maxTreeNodes = 1 << 18;
+    uint64_t seed = 1;
+};
+
+struct PlayoutResult {
+    uint64_t playouts = 0;
+    uint64_t solved = 0;
+    // Playouts that ran out of legal pushes before solving the level.
+    uint64_t stuck = 0;
+    // reachedTargets[k] counts the playouts that had k or more boxes on
+    // targets at some point; entry 0 equals playouts.
+    std::vector<uint64_t> reachedTargets;
+    uint64_t totalPushes = 0;
+    int bestOnTarget = 0;
+    double elapsedMs = 0.0;
+
+    double reachedFraction(int boxes) const;
+    double meanPushes() const;
+    double playoutsPerSecond() const;
+};
+
+// Estimates how hard a level is by playing it many times with random,
+// deadlock-pruned pushes instead of solving it. Pushes onto dead squares
+// and into frozen 2x2 blocks are never chosen, so a playout ends when the
+// level is solved, no push is left or the push limit is hit. Each thread
+// has its own RNG, search scratch and optional UCT tree; the counters are
+// merged with atomic adds once per batch.
+class PlayoutEngine {
+public:
+    static constexpr int MaxBoxes = 64;
+
+    explicit PlayoutEngine(const GameMap& map);
+
+    PlayoutResult run(const PlayoutOptions& options = PlayoutOptions()) const;
+
+    const Board& getBoard() const { return _board; }
+    int getBoxCount() const { return _boxCount; }
+
+private:
+    class Worker;
+
+    // Fixed-size so copying a playout state never allocates. Boxes keep
+    // their index for the whole playout; a move is box * 4 + direction.
+    struct State {
+        uint16_t player;
+        uint16_t onTarget;
+        std::array<uint16_t, MaxBoxes> boxes;
+    };
+
+    Board _board;
+    int _boxCount;
+    State _start;
+    // Board::neighbor for every cell and direction, looked up instead of
+    // recomputed from row and column on every step of a playout.
+    std::vector<int16_t> _neighbors;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef SOKOBANGAME_SEARCHCONTEXT_H
+#define SOKOBANGAME_SEARCHCONTEXT_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "solver/Board.h"
+
+// Per-thread scratch buffers for searches over one Board: box occupancy,
+// player reachability and the BFS queue. Not safe to share between threads.
+class SearchContext {
+public:
+    SearchContext(const Board& board, int boxCount);
+
+    void setOccupied(const uint16_t* boxes, uint8_t value);
+    void setOccupied(int cell, uint8_t value) { _occupied[cell] = value; }
+    bool isOccupied(int cell) const { return _occupied[cell] != 0; }
+    bool isFree(int cell) const { return cell >= 0 && _board.isFloor(cell) && !_occupied[cell]; }
+
+    // Flood-fills the player's reachable cells; returns the smallest one so
+    // states that differ only by a walk share a key.
+    int computeReach(int start);
+    bool isReachable(int cell) const { return _reach[cell] != 0; }
+
+    bool createsFrozenSquare(int cell) const;
+    std::string walkPath(const uint16_t* boxes, int from, int to);
+
+    bool isSolved(const uint16_t* boxes) const;
+    int getBoxCount() const { return _boxCount; }
+    const Board& getBoard() const { return _board; }
+
+private:
+    const Board& _board;
+    int _boxCount;
+    std::vector<uint8_t> _occupied;
+    std::vector<uint8_t> _reach;
+    std::vector<int> _queue;
+    std::vector<int> _cameFrom;
+};
+
+#endif
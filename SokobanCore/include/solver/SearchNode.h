@@ -0,0 +1,44 @@
+#ifndef SOKOBANGAME_SEARCHNODE_H
+#define SOKOBANGAME_SEARCHNODE_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// One state of a push search, allocated from a NodePool. The node is
+// followed in memory by its sorted box cells, boxCount entries.
+struct SearchNode {
+    SearchNode* parent;
+    uint32_t pushes;
+    uint16_t player;
+    uint16_t normalizedPlayer;
+    uint16_t pushedFrom;
+    uint16_t pushLength;
+    uint8_t direction;
+
+    uint16_t* boxes() { return reinterpret_cast<uint16_t*>(this + 1); }
+    const uint16_t* boxes() const { return reinterpret_cast<const uint16_t*>(this + 1); }
+
+    static size_t slotSize(int boxCount) { return sizeof(SearchNode) + boxCount * sizeof(uint16_t); }
+};
+
+struct SearchNodeHash {
+    int boxCount;
+    size_t operator()(const SearchNode* node) const {
+        size_t hash = node->normalizedPlayer;
+        const uint16_t* boxes = node->boxes();
+        for (int i = 0; i < boxCount; ++i) {
+            hash = hash * 31 + boxes[i];
+        }
+        return hash;
+    }
+};
+
+struct SearchNodeEqual {
+    int boxCount;
+    bool operator()(const SearchNode* lhs, const SearchNode* rhs) const {
+        return lhs->normalizedPlayer == rhs->normalizedPlayer &&
+               std::equal(lhs->boxes(), lhs->boxes() + boxCount, rhs->boxes());
+    }
+};
+
+#endif
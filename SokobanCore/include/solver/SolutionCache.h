@@ -0,0 +1,74 @@
+#ifndef SOKOBANGAME_SOLUTIONCACHE_H
+#define SOKOBANGAME_SOLUTIONCACHE_H
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GameMap.h"
+
+struct CacheEntry {
+    enum Flags : uint8_t {
+        Validated = 1,
+        Solved = 2,
+        Unsolvable = 4,
+        // The stored solution uses the fewest possible pushes.
+        Optimal = 8
+    };
+
+    uint8_t flags = 0;
+    // Pushes needed at least; exact when the entry is Optimal.
+    int lowerBound = 0;
+    std::string solution;
+    // One byte per cell, row-major, non-zero for dead squares. Empty if unknown.
+    std::vector<uint8_t> deadSquares;
+    // Search effort of the run that found the result, so a cache hit still
+    // tells hard levels from easy ones.
+    uint64_t nodesExpanded = 0;
+    uint64_t nodesGenerated = 0;
+
+    bool has(uint8_t flag) const { return (flags & flag) != 0; }
+};
+
+// Persistent results keyed by a hash of the level content (grid, player
+// start and boxes, not the id), so an edited level simply misses. The file
+// is append-only: existing records are memory-mapped when the cache is
+// opened and a newer record for the same level supersedes older ones. A
+// record cut short by a crash is dropped on the next open. A cache written
+// in an older format is started afresh. Thread-safe.
+class SolutionCache {
+public:
+    explicit SolutionCache(const std::string& path);
+    ~SolutionCache();
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    static uint64_t contentHash(const GameMap& map);
+
+    bool lookup(uint64_t hash, CacheEntry& entry) const;
+    // Merges with any existing entry and appends the result to the file.
+    void store(uint64_t hash, const CacheEntry& entry);
+
+    size_t size() const;
+    const std::string& getPath() const { return _path; }
+
+private:
+    void mapFile();
+    void unmapFile();
+    size_t indexRecords();
+    bool decode(size_t offset, CacheEntry& entry) const;
+    std::string encode(uint64_t hash, const CacheEntry& entry) const;
+
+    std::string _path;
+    mutable std::mutex _mutex;
+    const uint8_t* _mapped;
+    size_t _mappedSize;
+    std::vector<uint8_t> _buffer;
+    // Records present when the file was opened, by offset into the mapping.
+    std::unordered_map<uint64_t, size_t> _index;
+    // Records written since, which take precedence.
+    std::unordered_map<uint64_t, CacheEntry> _appended;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SOKOBANGAME_SOLUTIONOPTIMIZER_H
+#define SOKOBANGAME_SOLUTIONOPTIMIZER_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameMap.h"
+#include "solver/Board.h"
+#include "solver/SearchContext.h"
+
+struct OptimizerOptions {
+    // Push sequences of this length are re-searched for a shorter equivalent.
+    int windowPushes = 10;
+    // Node budget of a single window search.
+    uint64_t windowNodes = 20000;
+    // Cycle removal and window re-search repeat until nothing improves.
+    int maxPasses = 3;
+};
+
+struct OptimizationResult {
+    // The input replays to a win; nothing else is meaningful otherwise.
+    bool valid = false;
+    std::string solution;
+    int originalMoves = 0;
+    int originalPushes = 0;
+    int moves = 0;
+    int pushes = 0;
+    int cyclesRemoved = 0;
+    int windowsImproved = 0;
+    double optimizeTimeMs = 0.0;
+};
+
+// Shortens an existing LURD solution without solving the level again.
+// Walks between pushes are replaced by BFS shortest paths, push sequences
+// that return to an earlier position are cut out, and short windows of the
+// push sequence are re-searched for fewer pushes. Every candidate is
+// replayed through Game before it is accepted.
+class SolutionOptimizer {
+public:
+    explicit SolutionOptimizer(const GameMap& map);
+
+    OptimizationResult optimize(const std::string& solution, const OptimizerOptions& options = OptimizerOptions());
+
+private:
+    struct Push {
+        int box;
+        int direction;
+    };
+
+    // Boxes are kept sorted so equal positions compare equal.
+    struct State {
+        int player;
+        std::vector<uint16_t> boxes;
+    };
+
+    bool parse(const std::string& solution, std::vector<Push>& pushes) const;
+    std::vector<State> replay(const std::vector<Push>& pushes) const;
+    std::string build(const std::vector<Push>& pushes);
+    bool accept(const std::vector<Push>& candidate, std::vector<Push>& pushes, std::string& solution);
+
+    std::string stateKey(const State& state);
+    int removeCycles(std::vector<Push>& pushes, std::string& solution);
+    int improveWindows(std::vector<Push>& pushes, std::string& solution, const OptimizerOptions& options);
+    bool searchWindow(const State& from, const State& to, int maxPushes, uint64_t maxNodes,
+                      bool finalWindow, std::vector<Push>& replacement);
+
+    GameMap _map;
+    Board _board;
+    SearchContext _context;
+    int _boxCount;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SOKOBANGAME_SOLVER_H
+#define SOKOBANGAME_SOLVER_H
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+#include "GameMap.h"
+#include "solver/Arena.h"
+#include "solver/Board.h"
+#include "solver/SearchContext.h"
+#include "solver/SearchNode.h"
+
+class SolutionCache;
+
+struct SolverOptions {
+    uint64_t maxNodes = 2000000;
+    double timeLimitMs = 0.0;
+    // Collapse pushes through one-way tunnels into a single search step.
+    bool useTunnelMacros = true;
+    // Run a forward push search and a backward pull search from the solved
+    // position on two threads until they meet. Solutions are not optimal.
+    // Ignored on levels with spare targets, which are searched forward only.
+    bool bidirectional = false;
+    // When set, run a breadth-first search over push layers that keeps its
+    // frontier on disk in this directory and resumes from its checkpoint.
+    std::string spillDirectory;
+    size_t memoryBudgetBytes = 256 * 1024 * 1024;
+    // Polled during the search; setting it from another thread stops the
+    // solve early as if a limit had been hit.
+    const std::atomic<bool>* cancel = nullptr;
+    // Consulted before searching and updated with every conclusive result.
+    SolutionCache* cache = nullptr;
+
+    bool isCancelled() const { return cancel != nullptr && cancel->load(std::memory_order_relaxed); }
+};
+
+struct SolverResult {
+    bool solved = false;
+    // True when the whole reachable state space was explored without a solution.
+    bool exhausted = false;
+    std::string solution;
+    int pushes = 0;
+    int moves = 0;
+    uint64_t nodesExpanded = 0;
+    uint64_t nodesGenerated = 0;
+    uint64_t macroPushes = 0;
+    double solveTimeMs = 0.0;
+    double branchingFactor = 0.0;
+    size_t peakMemoryBytes = 0;
+    uint64_t arenaAllocations = 0;
+    uint64_t systemAllocations = 0;
+    uint64_t bytesSpilled = 0;
+    bool fromCache = false;
+};
+
+// Push-optimal A* search over box configurations. The player position is
+// normalised to its reachable region so walks never create new states.
+// All search memory comes from arenas that are dropped after each solve.
+class Solver {
+public:
+    explicit Solver(const GameMap& map);
+    SolverResult solve(const SolverOptions& options = SolverOptions());
+    const Board& getBoard() const { return _board; }
+
+private:
+    struct OpenEntry {
+        int f;
+        int h;
+        SearchNode* node;
+        bool operator>(const OpenEntry& other) const {
+            return f != other.f ? f > other.f : h > other.h;
+        }
+    };
+    using OpenList = std::priority_queue<OpenEntry, std::vector<OpenEntry, ArenaAllocator<OpenEntry>>,
+                                         std::greater<OpenEntry>>;
+
+    class SharedStateTable;
+    struct SideResult;
+
+    SolverResult solveForward(const SolverOptions& options);
+    SolverResult solveBidirectional(const SolverOptions& options);
+    SolverResult solveExternal(const SolverOptions& options);
+    void runSide(bool forward, const SolverOptions& options, SharedStateTable& table, SideResult& side);
+
+    SearchNode* createRoot(NodePool& pool, const std::vector<int>& boxes, int player) const;
+    // Both expect the context to hold the current node's boxes and reach.
+    void generatePushes(SearchContext& context, NodePool& pool, SearchNode* current, bool useMacros,
+                        std::vector<SearchNode*>& children) const;
+    void generatePulls(SearchContext& context, NodePool& pool, SearchNode* current,
+                       std::vector<SearchNode*>& children) const;
+    int followTunnel(const SearchContext& context, int cell, int direction, int& length) const;
+    int heuristic(const uint16_t* boxes) const;
+    int backwardHeuristic(const uint16_t* boxes) const;
+    std::string reconstruct(SearchContext& context, const SearchNode* goal) const;
+    std::string reconstructBackward(SearchContext& context, const SearchNode* meeting, int player) const;
+    bool loadCached(const SolverOptions& options, SolverResult& result) const;
+    void storeCached(const SolverOptions& options, const SolverResult& result) const;
+
+    Board _board;
+    int _boxCount;
+    uint64_t _levelHash;
+};
+
+#endif
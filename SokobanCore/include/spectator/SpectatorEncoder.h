@@ -0,0 +1,52 @@
+#ifndef SOKOBANGAME_SPECTATORENCODER_H
+#define SOKOBANGAME_SPECTATORENCODER_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+#include "enums/EGameEvent.h"
+#include "interfaces/IGame.h"
+
+// Stream layout shared by the encoder and SpectatorGame. A keyframe is
+// the tag, the length of the rest as a 32-bit little-endian number, then
+// the level id, move count, width, height, player position, box count, one
+// byte per tile and the box positions. A move is a single byte: the delta
+// flag, the pushed flag and the EFacing value.
+namespace SpectatorFormat {
+    constexpr uint8_t KeyframeTag = 'K';
+    constexpr uint8_t DeltaFlag = 0x80;
+    constexpr uint8_t PushedFlag = 0x04;
+    constexpr uint8_t DirectionMask = 0x03;
+    constexpr size_t KeyframeHeaderSize = 5;
+    constexpr size_t KeyframeFixedSize = 20;
+    // Larger keyframes are rejected as corrupt.
+    constexpr uint32_t MaxKeyframeSize = 1u << 24;
+}
+
+// Turns the events of a game into the spectator stream: a keyframe
+// whenever the level is loaded, restarted or seeked, and one byte per move
+// in between. The direction of a move comes from the player's position
+// change and the pushed flag from a BOX_MOVED before it. Once the moves
+// since the last keyframe outgrow it, a fresh keyframe follows, so a
+// viewer never needs more than twice the keyframe size to catch up.
+class SpectatorEncoder {
+public:
+    explicit SpectatorEncoder(IGame* game);
+
+    // Appends the packets for event to out and returns true when one of
+    // them is a keyframe.
+    bool encode(EGameEvent event, std::vector<uint8_t>& out);
+    // Appends a keyframe of the current state of the game.
+    void encodeKeyframe(std::vector<uint8_t>& out);
+
+private:
+    bool encodeMove(std::vector<uint8_t>& out);
+
+    IGame* _game;
+    Position _lastPlayer;
+    bool _pushed;
+    size_t _keyframeSize;
+    size_t _movesSinceKeyframe;
+};
+
+#endif
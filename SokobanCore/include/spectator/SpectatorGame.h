@@ -0,0 +1,80 @@
+#ifndef SOKOBANGAME_SPECTATORGAME_H
+#define SOKOBANGAME_SPECTATORGAME_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "interfaces/IGame.h"
+#include "interfaces/IGameObserver.h"
+
+// Read-only game rebuilt from a SpectatorPublisher stream, so any front end
+// can watch a session as if it were playing it. Keyframes are notified as
+// LEVEL_RELOADED and moves as BOX_MOVED/PLAYER_MOVED, followed by LEVEL_WON
+// when the last box reaches a target. The controls of IGame do nothing.
+class SpectatorGame : public IGame {
+public:
+    SpectatorGame();
+    ~SpectatorGame();
+    SpectatorGame(const SpectatorGame&) = delete;
+    SpectatorGame& operator=(const SpectatorGame&) = delete;
+
+    // Connects to a publisher's socket; the stream starts with its latest
+    // keyframe.
+    void connect(const std::string& socketPath);
+    // For waiting on the stream together with other input.
+    int getSocket() const { return _socket; }
+    // Applies everything that already arrived without waiting; false once
+    // the publisher has closed the stream.
+    bool receive();
+
+    // Applies stream bytes, which may end in the middle of a packet.
+    // Throws std::runtime_error on a corrupt stream.
+    void feed(const uint8_t* data, size_t size);
+
+    bool hasKeyframe() const { return _loaded; }
+
+    void loadLevel(int) override {}
+    void movePlayer(EFacing) override {}
+    void restartLevel() override {}
+    int getLevelId() override { return _levelId; }
+    EGameState getCurrentState() override;
+    int getLevelWidth() override { return _width; }
+    int getLevelLength() override { return _height; }
+    ETileType getTileAt(Position position) override;
+    Position getPlayerPosition() override { return _player; }
+    const std::vector<Position>& getBoxPositions() override { return _boxes; }
+    int getMoveCount() override { return _moveCount; }
+    void seekMove(int) override {}
+    int getHistoryLength() override { return _moveCount; }
+    void checkLevelSource() override {}
+
+    void addObserver(IGameObserver* observer) override;
+    void removeObserver(IGameObserver* observer) override;
+    void notify(EGameEvent event) override;
+
+private:
+    void applyKeyframe(const uint8_t* data, size_t size);
+    void applyMove(uint8_t packet);
+    bool isInside(int row, int col) const;
+
+    int _socket;
+    std::vector<IGameObserver*> _observers;
+    // Bytes of a packet that has not fully arrived yet.
+    std::vector<uint8_t> _partial;
+
+    bool _loaded;
+    int _levelId;
+    int _moveCount;
+    int _width;
+    int _height;
+    std::vector<uint8_t> _tiles;
+    Position _player;
+    std::vector<Position> _boxes;
+    // Index into _boxes per tile, -1 where there is none, so a push finds
+    // its box directly.
+    std::vector<int> _boxAt;
+    int _boxesOnTarget;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SOKOBANGAME_SPECTATORPUBLISHER_H
+#define SOKOBANGAME_SPECTATORPUBLISHER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "interfaces/IGame.h"
+#include "interfaces/IGameObserver.h"
+#include "spectator/SpectatorEncoder.h"
+
+// Observer that broadcasts the game to any number of local viewers over a
+// Unix socket, as encoded by SpectatorEncoder. Events are only encoded into
+// a buffer on the game thread; a sender thread swaps it out and does all
+// the socket work, so a slow or stuck viewer never holds up the game. A
+// viewer that connects late first gets the latest keyframe and the moves
+// since, and one that falls more than maxBacklog bytes behind is
+// disconnected.
+class SpectatorPublisher : public IGameObserver {
+public:
+    SpectatorPublisher(IGame* game, const std::string& socketPath, size_t maxBacklog = 1 << 20, int sendIntervalMs = 5);
+    ~SpectatorPublisher();
+    SpectatorPublisher(const SpectatorPublisher&) = delete;
+    SpectatorPublisher& operator=(const SpectatorPublisher&) = delete;
+
+    void onNotify(EGameEvent event) override;
+
+    size_t getSubscriberCount() const { return _subscribers.load(std::memory_order_relaxed); }
+    uint64_t getDisconnectedCount() const { return _disconnected.load(std::memory_order_relaxed); }
+    const std::string& getSocketPath() const { return _socketPath; }
+
+private:
+    struct Client {
+        int socket;
+        std::vector<uint8_t> backlog;
+        size_t sent;
+    };
+
+    void publish(bool wake);
+    void run();
+    void acceptClients();
+    void fanOut(const std::vector<uint8_t>& batch);
+    bool sendBacklog(Client& client);
+
+    IGame* _game;
+    std::string _socketPath;
+    size_t _maxBacklog;
+    int _sendIntervalMs;
+    int _listenSocket;
+
+    // Game thread only.
+    SpectatorEncoder _encoder;
+    std::vector<uint8_t> _packets;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    // Encoded packets not yet taken by the sender.
+    std::vector<uint8_t> _outgoing;
+    bool _stopping;
+
+    // Sender thread only: the latest keyframe followed by every move since,
+    // which is what a new viewer is sent first.
+    std::vector<uint8_t> _sync;
+    std::vector<Client> _clients;
+    std::atomic<size_t> _subscribers;
+    std::atomic<uint64_t> _disconnected;
+    std::thread _sender;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SOKOBANGAME_TELEMETRYREADER_H
+#define SOKOBANGAME_TELEMETRYREADER_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "telemetry/TelemetryRecorder.h"
+
+struct TelemetryLog {
+    // Wall-clock time of the first timestamp, in nanoseconds since the Unix epoch.
+    uint64_t startEpochNs = 0;
+    std::vector<TelemetryEvent> events;
+    // A record cut short at the end of the file, e.g. by a crash.
+    bool truncated = false;
+};
+
+// Decodes files written by TelemetryRecorder.
+class TelemetryReader {
+public:
+    static TelemetryLog read(const std::string& path);
+    static const char* eventName(uint8_t type);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef SOKOBANGAME_TELEMETRYRECORDER_H
+#define SOKOBANGAME_TELEMETRYRECORDER_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Position.h"
+#include "enums/EGameEvent.h"
+
+struct TelemetryEvent {
+    // Nanoseconds since the recorder was created.
+    uint64_t timestampNs;
+    uint32_t moveCount;
+    uint16_t level;
+    uint8_t type;
+    uint8_t reserved;
+    int16_t playerRow;
+    int16_t playerCol;
+    // Box moved by the event, -1 when no box moved.
+    int16_t boxRow;
+    int16_t boxCol;
+};
+
+// File layout shared by the recorder and TelemetryReader: the magic, the
+// version and the start time in nanoseconds since the Unix epoch, then one
+// varint-encoded record per event with fields stored as deltas.
+namespace TelemetryFormat {
+    constexpr char Magic[8] = {'S', 'K', 'B', 'T', 'E', 'L', 'E', 'M'};
+    constexpr uint32_t Version = 1;
+}
+
+// Game events go into a preallocated single-producer ring that a background
+// thread drains to disk. record() never allocates, locks or blocks: when the
+// flusher falls behind the event is counted as dropped instead.
+class TelemetryRecorder {
+public:
+    explicit TelemetryRecorder(const std::string& path, size_t capacity = 1 << 16, int flushIntervalMs = 100);
+    ~TelemetryRecorder();
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    // Only one thread may record.
+    void record(EGameEvent type, int level, int moveCount, const Position& player, const Position& box) noexcept;
+
+    // Wakes the flusher now instead of at the next interval.
+    void flush();
+
+    uint64_t getRecordedCount() const { return _recorded.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+    uint64_t getWrittenCount() const { return _written.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void drain();
+    void encode(const TelemetryEvent& event);
+
+    std::vector<TelemetryEvent> _ring;
+    size_t _mask;
+    // Padded apart so producer and flusher do not share a cache line.
+    alignas(64) std::atomic<uint64_t> _head;
+    alignas(64) std::atomic<uint64_t> _tail;
+    // Producer-side copy of _head, refreshed only when the ring looks full.
+    uint64_t _cachedHead;
+    std::atomic<uint64_t> _recorded;
+    std::atomic<uint64_t> _dropped;
+    std::atomic<uint64_t> _written;
+
+    std::chrono::steady_clock::time_point _start;
+    int _flushIntervalMs;
+    std::ofstream _file;
+    std::string _buffer;
+    TelemetryEvent _previous;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stopping;
+    std::thread _flusher;
+};
+
+#endif
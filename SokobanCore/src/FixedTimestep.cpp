@@ -0,0 +1,31 @@
+#include "FixedTimestep.h"
+#include <stdexcept>
+
+FixedTimestep::FixedTimestep(double tickSeconds, int maxTicksPerFrame)
+    : _tickSeconds(tickSeconds),
+      _maxTicksPerFrame(maxTicksPerFrame),
+      _accumulator(0.0)
+{
+    if (tickSeconds <= 0.0 || maxTicksPerFrame <= 0) {
+        throw std::runtime_error("Tick length and tick limit must be positive");
+    }
+}
+
+int FixedTimestep::advance(double elapsedSeconds) {
+    if (elapsedSeconds > 0.0) {
+        _accumulator += elapsedSeconds;
+    }
+    int ticks = 0;
+    while (_accumulator >= _tickSeconds && ticks < _maxTicksPerFrame) {
+        _accumulator -= _tickSeconds;
+        ++ticks;
+    }
+    if (ticks == _maxTicksPerFrame && _accumulator >= _tickSeconds) {
+        _accumulator = 0.0;
+    }
+    return ticks;
+}
+
+float FixedTimestep::getAlpha() const {
+    return static_cast<float>(_accumulator / _tickSeconds);
+}
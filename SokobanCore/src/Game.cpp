@@ -1,12 +1,43 @@
 #include "Game.h"
+#include "LevelIndex.h"
+#include "telemetry/TelemetryRecorder.h"
 #include <algorithm>
 
-Game::Game() : _player(Position(0, 0)), _moveCount(0), _currentLevel(0), _gameState(EGameState::LOADING) {}
+Game::Game()
+    : _player(Position(0, 0)),
+      _lastPushedBox(-1, -1),
+      _telemetry(nullptr),
+      _moveCount(0),
+      _currentLevel(0),
+      _fromLevelIndex(false),
+      _levelRevision(0),
+      _gameState(EGameState::LOADING) {}
 
 void Game::loadLevel(int levelNumber) {
+    // Read before loading, so an edit that lands in between is seen by the
+    // next checkLevelSource(). A level that fails to load leaves the current
+    // game untouched.
+    uint64_t revision = LevelIndex::shared().getRevision(levelNumber);
+    GameMap map;
+    map.load(levelNumber);
+
     _gameState = EGameState::LOADING;
     _currentLevel = levelNumber;
-    _currentMap.load(levelNumber);
+    _currentMap = map;
+    _fromLevelIndex = true;
+    _levelRevision = revision;
+    resetToMapStart();
+}
+
+void Game::loadLevel(const GameMap& map) {
+    _gameState = EGameState::LOADING;
+    _currentLevel = map.getId();
+    _currentMap = map;
+    _fromLevelIndex = false;
+    resetToMapStart();
+}
+
+void Game::resetToMapStart() {
     _player.setPosition(_currentMap.getPlayerStart());
     _boxes.clear();
     std::vector<Position> boxPositions = _currentMap.getBoxPositions();
@@ -14,6 +45,7 @@ void Game::loadLevel(int levelNumber) {
         _boxes.emplace_back(pos);
     }
     
+    _history.reset(_currentMap.getWidth(), _player.getPosition(), boxPositions);
     _moveCount = 0;
     _gameState = EGameState::PLAYING;
     
@@ -25,33 +57,95 @@ void Game::movePlayer(EFacing direction) {
         return;
     }
     
+    bool pushed = false;
+    if (!applyMove(direction, pushed)) {
+        return;
+    }
+    if (pushed) {
+        notify(EGameEvent::BOX_MOVED);
+    }
+
+    // A move made after seeking back starts a new branch of the session.
+    _history.truncate(_moveCount);
+    _moveCount++;
+    if (_history.record(direction, pushed)) {
+        _history.addCheckpoint(_player.getPosition(), getBoxPositions());
+    }
+    notify(EGameEvent::PLAYER_MOVED);
+    if (checkWinCondition()) {
+        _gameState = EGameState::LEVEL_COMPLETED;
+        notify(EGameEvent::LEVEL_WON);
+    }
+}
+
+bool Game::applyMove(EFacing direction, bool& pushed) {
+    pushed = false;
     Position currentPos = _player.getPosition();
     Position nextPos = getNextPosition(currentPos, direction);
     if (!isPositionWalkable(nextPos)) {
-        return;
+        return false;
     }
     if (isBoxAt(nextPos)) {
         Position boxNextPos = getNextPosition(nextPos, direction);
         if (!isPositionWalkable(boxNextPos) || isBoxAt(boxNextPos)) {
-            return;
+            return false;
         }
         Box* box = getBoxAt(nextPos);
         if (box) {
             box->setPosition(boxNextPos);
-            notify(EGameEvent::BOX_MOVED);
+            _lastPushedBox = boxNextPos;
+            pushed = true;
         }
     }
     _player.setPosition(nextPos);
-    _moveCount++;
-    notify(EGameEvent::PLAYER_MOVED);
-    if (checkWinCondition()) {
-        _gameState = EGameState::LEVEL_COMPLETED;
-        notify(EGameEvent::LEVEL_WON);
+    return true;
+}
+
+void Game::seekMove(int moveIndex) {
+    if (_gameState == EGameState::LOADING) {
+        return;
+    }
+    moveIndex = std::max(0, std::min(moveIndex, _history.size()));
+
+    Position player(0, 0);
+    std::vector<Position> boxes;
+    int move = _history.restore(moveIndex, player, boxes);
+    _player.setPosition(player);
+    for (size_t i = 0; i < _boxes.size() && i < boxes.size(); ++i) {
+        _boxes[i].setPosition(boxes[i]);
+    }
+    bool pushed;
+    for (; move < moveIndex; ++move) {
+        applyMove(_history.getDirection(move), pushed);
+    }
+
+    _moveCount = moveIndex;
+    _gameState = checkWinCondition() ? EGameState::LEVEL_COMPLETED : EGameState::PLAYING;
+    notify(EGameEvent::HISTORY_SEEKED);
+}
+
+int Game::getHistoryLength() {
+    return _history.size();
+}
+
+void Game::checkLevelSource() {
+    if (!_fromLevelIndex) {
+        return;
+    }
+    uint64_t revision = LevelIndex::shared().getRevision(_currentLevel);
+    if (revision != _levelRevision) {
+        _levelRevision = revision;
+        notify(EGameEvent::LEVEL_SOURCE_CHANGED);
     }
 }
 
 void Game::restartLevel() {
-    loadLevel(_currentLevel);
+    _gameState = EGameState::LOADING;
+    resetToMapStart();
+}
+
+int Game::getLevelId() {
+    return _currentLevel;
 }
 
 void Game::addObserver(IGameObserver *observer) {
@@ -68,6 +162,14 @@ void Game::removeObserver(IGameObserver *observer) {
 }
 
 void Game::notify(EGameEvent event) {
+    if (_telemetry) {
+        bool pushed = event == EGameEvent::BOX_MOVED;
+        Position box = pushed ? _lastPushedBox : Position(-1, -1);
+        // A push is announced before its move is counted; it belongs to the
+        // move whose PLAYER_MOVED follows.
+        int moveCount = pushed ? _moveCount + 1 : _moveCount;
+        _telemetry->record(event, _currentLevel, moveCount, _player.getPosition(), box);
+    }
     for (auto* observer : _observers) {
         if (observer) {
             observer->onNotify(event);
@@ -108,14 +210,13 @@ Position Game::getPlayerPosition() {
 }
 
 const std::vector<Position>& Game::getBoxPositions() {
-    static std::vector<Position> positions;
-    positions.clear();
+    _boxPositions.clear();
     
     for (const auto& box : _boxes) {
-        positions.push_back(box.getPosition());
+        _boxPositions.push_back(box.getPosition());
     }
     
-    return positions;
+    return _boxPositions;
 }
 
 int Game::getMoveCount() {
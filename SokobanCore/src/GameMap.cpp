@@ -1,56 +1,76 @@
 #include "GameMap.h"
+#include "LevelIndex.h"
 #include <nlohmann/json.hpp>
-#include <fstream>
 #include <stdexcept>
 
 using json = nlohmann::json;
 
-GameMap::GameMap() : _playerStart(0, 0), _width(0), _height(0) {}
+GameMap::GameMap() : _playerStart(0, 0), _id(0), _width(0), _height(0) {}
+
+GameMap::GameMap(int id, const std::string& name, std::vector<std::vector<Tile>> grid,
+                 Position playerStart, std::vector<Position> boxPositions)
+    : _grid(std::move(grid)),
+      _playerStart(playerStart),
+      _boxPositions(std::move(boxPositions)),
+      _id(id),
+      _name(name),
+      _width(_grid.empty() ? 0 : static_cast<int>(_grid[0].size())),
+      _height(static_cast<int>(_grid.size())) {}
+
+GameMap GameMap::capture(IGame& game) {
+    int width = game.getLevelWidth();
+    int height = game.getLevelLength();
+    std::vector<std::vector<Tile>> grid(height);
+    for (int row = 0; row < height; ++row) {
+        grid[row].reserve(width);
+        for (int col = 0; col < width; ++col) {
+            grid[row].emplace_back(game.getTileAt(Position(row, col)));
+        }
+    }
+    return GameMap(0, "", std::move(grid), game.getPlayerPosition(), game.getBoxPositions());
+}
 
 void GameMap::load(int levelNumber) {
-    std::ifstream file("levels.json");
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open levels.json");
+    *this = LevelIndex::shared().get(levelNumber);
+}
+
+void GameMap::loadFromJson(const nlohmann::json& level) {
+    _id = level.at("id");
+    _name = level.value("name", "");
+    _width = level.at("width");
+    _height = level.at("height");
+    if (_width <= 0 || _height <= 0) {
+        throw std::runtime_error("Level " + std::to_string(_id) + " has invalid dimensions");
     }
+    _grid.clear();
+    _grid.resize(_height);
     
-    json data;
-    file >> data;
-    file.close();
-    bool levelFound = false;
-    for (const auto& level : data["levels"]) {
-        if (level["id"] == levelNumber) {
-            levelFound = true;
-            _width = level["width"];
-            _height = level["height"];
-            _grid.clear();
-            _grid.resize(_height);
-            
-            const auto& gridData = level["grid"];
-            for (int row = 0; row < _height; ++row) {
-                _grid[row].clear();
-                for (int col = 0; col < _width; ++col) {
-                    int tileValue = gridData[row][col];
-                    _grid[row].emplace_back(static_cast<ETileType>(tileValue));
-                }
-            }
-            const auto& playerStartData = level["playerStart"];
-            _playerStart.setRow(playerStartData["row"]);
-            _playerStart.setCol(playerStartData["col"]);
-            _boxPositions.clear();
-            const auto& boxPositionsData = level["boxPositions"];
-            for (const auto& boxPos : boxPositionsData) {
-                _boxPositions.emplace_back(boxPos["row"], boxPos["col"]);
-            }
-            
-            break;
+    const auto& gridData = level.at("grid");
+    for (int row = 0; row < _height; ++row) {
+        _grid[row].clear();
+        for (int col = 0; col < _width; ++col) {
+            int tileValue = gridData.at(row).at(col);
+            _grid[row].emplace_back(static_cast<ETileType>(tileValue));
         }
     }
-    
-    if (!levelFound) {
-        throw std::runtime_error("Level " + std::to_string(levelNumber) + " not found");
+    const auto& playerStartData = level.at("playerStart");
+    _playerStart.setRow(playerStartData.at("row"));
+    _playerStart.setCol(playerStartData.at("col"));
+    _boxPositions.clear();
+    const auto& boxPositionsData = level.at("boxPositions");
+    for (const auto& boxPos : boxPositionsData) {
+        _boxPositions.emplace_back(boxPos.at("row"), boxPos.at("col"));
     }
 }
 
+int GameMap::getId() const {
+    return _id;
+}
+
+const std::string& GameMap::getName() const {
+    return _name;
+}
+
 int GameMap::getWidth() const {
     return _width;
 }
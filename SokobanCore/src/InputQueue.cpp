@@ -0,0 +1,46 @@
+#include "InputQueue.h"
+
+InputQueue::InputQueue() : _commands(), _head(0), _count(0) {}
+
+bool InputQueue::push(EInputCommand command) {
+    if (_count == Capacity) {
+        return false;
+    }
+    _commands[(_head + _count) % Capacity] = command;
+    ++_count;
+    return true;
+}
+
+bool InputQueue::pop(EInputCommand& command) {
+    if (_count == 0) {
+        return false;
+    }
+    command = _commands[_head];
+    _head = (_head + 1) % Capacity;
+    --_count;
+    return true;
+}
+
+void InputQueue::clear() {
+    _head = 0;
+    _count = 0;
+}
+
+bool InputQueue::toFacing(EInputCommand command, EFacing& direction) {
+    switch (command) {
+        case EInputCommand::MOVE_LEFT:
+            direction = EFacing::LEFT;
+            return true;
+        case EInputCommand::MOVE_UP:
+            direction = EFacing::UP;
+            return true;
+        case EInputCommand::MOVE_DOWN:
+            direction = EFacing::DOWN;
+            return true;
+        case EInputCommand::MOVE_RIGHT:
+            direction = EFacing::RIGHT;
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,352 @@
+#include "LevelIndex.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    uint64_t hashText(const std::string& text, size_t begin, size_t end) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = begin; i < end; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(text[i])) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
+
+LevelIndex::LevelIndex(const std::string& path)
+    : _path(path),
+      _scanned(false),
+      _size(0),
+      _nextSlice(0),
+      _revision(0),
+      _watching(false) {}
+
+LevelIndex::~LevelIndex() {
+    stopWatching();
+}
+
+LevelIndex& LevelIndex::shared() {
+    static LevelIndex index("levels.json");
+    return index;
+}
+
+GameMap LevelIndex::get(int levelId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    refresh();
+    while (_levels.find(levelId) == _levels.end() && _errors.find(levelId) == _errors.end() && parseNext()) {
+    }
+
+    auto level = _levels.find(levelId);
+    if (level != _levels.end()) {
+        return level->second;
+    }
+    auto error = _errors.find(levelId);
+    if (error != _errors.end()) {
+        throw std::runtime_error(error->second);
+    }
+    throw std::runtime_error("Level " + std::to_string(levelId) + " not found");
+}
+
+void LevelIndex::prefetch(int levelId) {
+    try {
+        get(levelId);
+    } catch (const std::exception&) {
+        // Reported again by the get() that actually needs the level.
+    }
+}
+
+size_t LevelIndex::count() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    refresh();
+    return _slices.size();
+}
+
+std::vector<int> LevelIndex::reload() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return refresh();
+}
+
+uint64_t LevelIndex::getRevision(int levelId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto revision = _revisions.find(levelId);
+    return revision != _revisions.end() ? revision->second : 0;
+}
+
+void LevelIndex::startWatching() {
+    if (!_watching.exchange(true)) {
+        _watcher = std::thread(&LevelIndex::watch, this);
+    }
+}
+
+void LevelIndex::stopWatching() {
+    _watching = false;
+    if (_watcher.joinable()) {
+        _watcher.join();
+    }
+}
+
+std::vector<int> LevelIndex::refresh() {
+    std::error_code error;
+    fs::file_time_type modified = fs::last_write_time(_path, error);
+    std::uintmax_t size = error ? 0 : fs::file_size(_path, error);
+    if (error) {
+        throw std::runtime_error("Failed to open " + _path);
+    }
+    if (_scanned && modified == _modified && size == _size) {
+        return {};
+    }
+
+    std::ifstream file(_path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + _path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    _modified = modified;
+    _size = size;
+
+    if (!_scanned) {
+        _contents = contents.str();
+        _slices = split(_contents);
+        _scanned = true;
+        return {};
+    }
+    std::string text = contents.str();
+    std::vector<Slice> slices;
+    try {
+        slices = split(text);
+    } catch (const std::exception&) {
+        // Keep serving the last good version.
+        return {};
+    }
+    return merge(std::move(text), std::move(slices));
+}
+
+std::vector<LevelIndex::Slice> LevelIndex::split(const std::string& contents) const {
+    std::vector<Slice> slices;
+
+    // Bracket matching only: find the objects directly inside the top-level
+    // "levels" array without building a DOM for the whole pack.
+    int depth = 0;
+    int arrayDepth = -1;
+    bool inString = false;
+    size_t stringStart = 0;
+    std::string lastKey;
+    size_t levelStart = 0;
+    for (size_t i = 0; i < contents.size(); ++i) {
+        char c = contents[i];
+        if (inString) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                inString = false;
+                if (depth == 1) {
+                    lastKey = contents.substr(stringStart, i - stringStart);
+                }
+            }
+            continue;
+        }
+        switch (c) {
+            case '"':
+                inString = true;
+                stringStart = i + 1;
+                break;
+            case '[':
+                if (depth == 1 && lastKey == "levels" && arrayDepth < 0) {
+                    arrayDepth = depth + 1;
+                }
+                ++depth;
+                break;
+            case '{':
+                if (depth == arrayDepth) {
+                    levelStart = i;
+                }
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                --depth;
+                if (c == '}' && depth == arrayDepth) {
+                    slices.push_back({levelStart, i + 1, hashText(contents, levelStart, i + 1), false});
+                } else if (c == ']' && depth + 1 == arrayDepth) {
+                    arrayDepth = -2;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (arrayDepth == -1) {
+        throw std::runtime_error(_path + " has no levels array");
+    }
+    if (depth != 0 || inString) {
+        throw std::runtime_error(_path + " is incomplete");
+    }
+    return slices;
+}
+
+std::vector<int> LevelIndex::merge(std::string contents, std::vector<Slice> slices) {
+    // Parsed levels whose text is unchanged keep their GameMap, wherever
+    // they moved in the file. Slices that were not parsed before and are
+    // unchanged stay lazy; only new or edited text is parsed here.
+    std::unordered_map<uint64_t, int> parsedByHash;
+    for (const auto& entry : _hashes) {
+        parsedByHash.emplace(entry.second, entry.first);
+    }
+    std::unordered_set<uint64_t> known;
+    for (const auto& slice : _slices) {
+        known.insert(slice.hash);
+    }
+
+    std::unordered_map<int, GameMap> levels;
+    std::unordered_map<int, std::string> errors;
+    std::unordered_map<int, uint64_t> hashes;
+    std::vector<size_t> edited;
+    for (size_t i = 0; i < slices.size(); ++i) {
+        Slice& slice = slices[i];
+        auto parsed = parsedByHash.find(slice.hash);
+        if (parsed != parsedByHash.end()) {
+            int id = parsed->second;
+            auto level = _levels.find(id);
+            if (level != _levels.end()) {
+                levels.emplace(id, std::move(level->second));
+            } else {
+                errors.emplace(id, std::move(_errors[id]));
+            }
+            hashes.emplace(id, slice.hash);
+            slice.parsed = true;
+            parsedByHash.erase(parsed);
+        } else if (known.find(slice.hash) == known.end()) {
+            edited.push_back(i);
+        }
+    }
+
+    std::unordered_map<int, uint64_t> previous;
+    previous.swap(_hashes);
+    _contents = std::move(contents);
+    _slices = std::move(slices);
+    _nextSlice = 0;
+    _levels = std::move(levels);
+    _errors = std::move(errors);
+    _hashes = std::move(hashes);
+
+    std::vector<int> changed;
+    for (size_t index : edited) {
+        int id = parseSlice(index);
+        if (id >= 0) {
+            changed.push_back(id);
+        }
+    }
+    for (const auto& entry : previous) {
+        if (_hashes.find(entry.first) == _hashes.end()) {
+            changed.push_back(entry.first);
+        }
+    }
+    if (!changed.empty()) {
+        ++_revision;
+        for (int id : changed) {
+            _revisions[id] = _revision;
+        }
+    }
+    return changed;
+}
+
+bool LevelIndex::parseNext() {
+    while (_nextSlice < _slices.size() && _slices[_nextSlice].parsed) {
+        ++_nextSlice;
+    }
+    if (_nextSlice == _slices.size()) {
+        return false;
+    }
+    parseSlice(_nextSlice++);
+    return true;
+}
+
+int LevelIndex::parseSlice(size_t index) {
+    Slice& slice = _slices[index];
+    slice.parsed = true;
+    nlohmann::json level = nlohmann::json::parse(_contents.begin() + static_cast<std::ptrdiff_t>(slice.begin),
+                                                 _contents.begin() + static_cast<std::ptrdiff_t>(slice.end),
+                                                 nullptr, false);
+    if (level.is_discarded() || !level.contains("id") || !level["id"].is_number_integer()) {
+        return -1;
+    }
+    int id = level["id"];
+    if (_hashes.find(id) != _hashes.end()) {
+        // A duplicate id; the first level with it wins, as before.
+        return -1;
+    }
+    _hashes.emplace(id, slice.hash);
+    try {
+        GameMap map;
+        map.loadFromJson(level);
+        _levels.emplace(id, std::move(map));
+    } catch (const std::exception& e) {
+        _errors.emplace(id, "Level " + std::to_string(id) + " is malformed: " + e.what());
+    }
+    return id;
+}
+
+void LevelIndex::watch() {
+    auto reloadQuietly = [this]() {
+        try {
+            reload();
+        } catch (const std::exception&) {
+            // The file may be missing for a moment while it is replaced.
+        }
+    };
+
+#ifdef __linux__
+    // Editors often save by writing a new file and renaming it over the old
+    // one, so watch the directory and filter by name.
+    fs::path file(_path);
+    std::string directory = file.has_parent_path() ? file.parent_path().string() : ".";
+    std::string name = file.filename().string();
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0) {
+        // Catches writes made before the watch was in place.
+        reloadQuietly();
+        alignas(struct inotify_event) char buffer[4096];
+        while (_watching) {
+            pollfd request{fd, POLLIN, 0};
+            if (poll(&request, 1, 200) <= 0) {
+                continue;
+            }
+            bool touched = false;
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                    touched = touched || (event->len > 0 && name == event->name);
+                    offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+                }
+            }
+            if (touched) {
+                reloadQuietly();
+            }
+        }
+        close(fd);
+        return;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+
+    while (_watching) {
+        for (int i = 0; i < 5 && _watching; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        reloadQuietly();
+    }
+}
@@ -0,0 +1,76 @@
+#include "MoveHistory.h"
+#include <algorithm>
+#include <stdexcept>
+
+MoveHistory::MoveHistory(int checkpointInterval)
+    : _checkpointInterval(checkpointInterval),
+      _width(0),
+      _boxCount(0)
+{
+    if (checkpointInterval <= 0) {
+        throw std::runtime_error("Checkpoint interval must be positive");
+    }
+}
+
+void MoveHistory::reset(int width, const Position& player, const std::vector<Position>& boxes) {
+    _width = width;
+    _boxCount = boxes.size();
+    _moves.clear();
+    _checkpointMoves.clear();
+    _checkpointCells.clear();
+    addCheckpoint(player, boxes);
+}
+
+bool MoveHistory::record(EFacing direction, bool pushed) {
+    _moves.push_back(static_cast<uint8_t>(static_cast<uint8_t>(direction) | (pushed ? PushFlag : 0)));
+    return _moves.size() % static_cast<size_t>(_checkpointInterval) == 0;
+}
+
+void MoveHistory::addCheckpoint(const Position& player, const std::vector<Position>& boxes) {
+    _checkpointMoves.push_back(size());
+    _checkpointCells.push_back(toCell(player));
+    for (const auto& box : boxes) {
+        _checkpointCells.push_back(toCell(box));
+    }
+}
+
+void MoveHistory::truncate(int length) {
+    if (length < 0 || length >= size()) {
+        return;
+    }
+    _moves.resize(static_cast<size_t>(length));
+    // Move 0 always keeps its checkpoint.
+    auto firstStale = std::upper_bound(_checkpointMoves.begin() + 1, _checkpointMoves.end(), length);
+    size_t kept = static_cast<size_t>(firstStale - _checkpointMoves.begin());
+    _checkpointMoves.resize(kept);
+    _checkpointCells.resize(kept * (_boxCount + 1));
+}
+
+int MoveHistory::restore(int moveIndex, Position& player, std::vector<Position>& boxes) const {
+    if (_checkpointMoves.empty()) {
+        throw std::runtime_error("Move history has not been started");
+    }
+    auto next = std::upper_bound(_checkpointMoves.begin(), _checkpointMoves.end(), moveIndex);
+    size_t checkpoint = next == _checkpointMoves.begin() ? 0 : static_cast<size_t>(next - _checkpointMoves.begin()) - 1;
+
+    const uint32_t* cells = _checkpointCells.data() + checkpoint * (_boxCount + 1);
+    player = toPosition(cells[0]);
+    boxes.clear();
+    for (size_t i = 0; i < _boxCount; ++i) {
+        boxes.push_back(toPosition(cells[1 + i]));
+    }
+    return _checkpointMoves[checkpoint];
+}
+
+size_t MoveHistory::getMemoryBytes() const {
+    return _moves.capacity() * sizeof(uint8_t) + _checkpointMoves.capacity() * sizeof(int) +
+           _checkpointCells.capacity() * sizeof(uint32_t);
+}
+
+uint32_t MoveHistory::toCell(const Position& pos) const {
+    return static_cast<uint32_t>(pos.getRow()) * static_cast<uint32_t>(_width) + static_cast<uint32_t>(pos.getCol());
+}
+
+Position MoveHistory::toPosition(uint32_t cell) const {
+    return Position(static_cast<int>(cell / _width), static_cast<int>(cell % _width));
+}
@@ -0,0 +1,204 @@
+#include "replay/ReplayCodec.h"
+#include <array>
+#include <cstring>
+#include "BoardKernel.h"
+#include "Game.h"
+#include "solver/Lurd.h"
+
+namespace {
+    // Indexed by EFacing.
+    const char Steps[4] = {'l', 'u', 'd', 'r'};
+    const size_t MaxRun = 64;
+    const size_t MaxShortRun = 4;
+
+    // What one payload byte expands to, so decoding is a table lookup and a
+    // copy per byte.
+    struct StepTables {
+        std::array<std::array<char, 4>, 256> packed;
+        // Both nibble runs of a ShortRuns byte, and how many steps they make.
+        std::array<std::array<char, 8>, 256> shortRuns;
+        std::array<uint8_t, 256> shortRunLength;
+
+        StepTables() {
+            for (int byte = 0; byte < 256; ++byte) {
+                for (int i = 0; i < 4; ++i) {
+                    packed[byte][i] = Steps[(byte >> (2 * i)) & 3];
+                }
+                size_t length = 0;
+                for (int nibble : {byte & 0x0F, byte >> 4}) {
+                    for (int i = 0; i <= nibble >> 2; ++i) {
+                        shortRuns[byte][length++] = Steps[nibble & 3];
+                    }
+                }
+                shortRunLength[byte] = static_cast<uint8_t>(length);
+            }
+        }
+    };
+
+    const StepTables& stepTables() {
+        static const StepTables tables;
+        return tables;
+    }
+
+    size_t varintSize(size_t value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    // Calls emit(direction, length) per run of equal steps, at most maxRun long.
+    template <typename Emit>
+    void forEachRun(const std::vector<uint8_t>& codes, size_t maxRun, Emit&& emit) {
+        size_t i = 0;
+        while (i < codes.size()) {
+            size_t end = i + 1;
+            while (end < codes.size() && end - i < maxRun && codes[end] == codes[i]) {
+                ++end;
+            }
+            emit(codes[i], end - i);
+            i = end;
+        }
+    }
+}
+
+bool ReplayCodec::encode(const std::string& lurd, std::vector<uint8_t>& payload, uint8_t& encoding) {
+    std::vector<uint8_t> codes(lurd.size());
+    for (size_t i = 0; i < lurd.size(); ++i) {
+        EFacing direction;
+        if (!Lurd::toFacing(lurd[i], direction)) {
+            return false;
+        }
+        codes[i] = static_cast<uint8_t>(direction);
+    }
+
+    size_t runs = 0;
+    forEachRun(codes, MaxRun, [&runs](uint8_t, size_t) { ++runs; });
+    size_t nibbles = 0;
+    forEachRun(codes, MaxShortRun, [&nibbles](uint8_t, size_t) { ++nibbles; });
+
+    // Run payloads also store their size in the record.
+    size_t packedSize = (codes.size() + 3) / 4;
+    size_t runSize = runs + varintSize(runs);
+    size_t shortRunSize = (nibbles + 1) / 2 + varintSize((nibbles + 1) / 2);
+    payload.clear();
+
+    if (runSize < packedSize && runSize <= shortRunSize) {
+        encoding = ReplayFormat::RunLength;
+        payload.reserve(runs);
+        forEachRun(codes, MaxRun, [&payload](uint8_t direction, size_t length) {
+            payload.push_back(static_cast<uint8_t>(direction | (length - 1) << 2));
+        });
+        return true;
+    }
+    if (shortRunSize < packedSize) {
+        encoding = ReplayFormat::ShortRuns;
+        payload.assign((nibbles + 1) / 2, 0);
+        size_t nibble = 0;
+        forEachRun(codes, MaxShortRun, [&payload, &nibble](uint8_t direction, size_t length) {
+            payload[nibble / 2] |= static_cast<uint8_t>((direction | (length - 1) << 2) << (4 * (nibble % 2)));
+            ++nibble;
+        });
+        return true;
+    }
+
+    encoding = ReplayFormat::Packed;
+    payload.assign(packedSize, 0);
+    for (size_t i = 0; i < codes.size(); ++i) {
+        payload[i / 4] |= static_cast<uint8_t>(codes[i] << (2 * (i % 4)));
+    }
+    return true;
+}
+
+bool ReplayCodec::decode(const uint8_t* payload, size_t size, uint8_t encoding, uint32_t moves, char* out) {
+    const StepTables& tables = stepTables();
+    if (encoding == ReplayFormat::Packed) {
+        if (size != (static_cast<size_t>(moves) + 3) / 4) {
+            return false;
+        }
+        size_t whole = moves / 4;
+        for (size_t i = 0; i < whole; ++i) {
+            std::memcpy(out + 4 * i, tables.packed[payload[i]].data(), 4);
+        }
+        if (moves % 4) {
+            std::memcpy(out + 4 * whole, tables.packed[payload[whole]].data(), moves % 4);
+        }
+        return true;
+    }
+
+    size_t written = 0;
+    if (encoding == ReplayFormat::RunLength) {
+        for (size_t i = 0; i < size; ++i) {
+            size_t length = (payload[i] >> 2) + 1;
+            if (written + length > moves) {
+                return false;
+            }
+            std::memset(out + written, Steps[payload[i] & 3], length);
+            written += length;
+        }
+        return written == moves;
+    }
+    if (encoding != ReplayFormat::ShortRuns) {
+        return false;
+    }
+
+    // Whole bytes while a full eight steps still fit, then nibble by nibble;
+    // an odd run count leaves a zero nibble at the end.
+    size_t i = 0;
+    for (; i < size && written + 8 <= moves; ++i) {
+        std::memcpy(out + written, tables.shortRuns[payload[i]].data(), 8);
+        written += tables.shortRunLength[payload[i]];
+    }
+    for (; i < size; ++i) {
+        for (int shift = 0; shift < 8; shift += 4) {
+            uint8_t nibble = static_cast<uint8_t>(payload[i] >> shift) & 0x0F;
+            if (written == moves && shift == 4 && i + 1 == size && nibble == 0) {
+                break;
+            }
+            size_t length = (nibble >> 2) + 1;
+            if (written + length > moves) {
+                return false;
+            }
+            std::memset(out + written, Steps[nibble & 3], length);
+            written += length;
+        }
+    }
+    return written == moves;
+}
+
+bool ReplayCodec::restorePushes(const GameMap& map, std::string& lurd) {
+    if (BoardKernel<64, 64>::fits(map)) {
+        return withBoardKernel(map, [&lurd](auto& kernel) {
+            for (char& step : lurd) {
+                EFacing direction;
+                bool pushed = false;
+                // The game takes no moves once the level is solved.
+                if (kernel.isSolved() || !Lurd::toFacing(step, direction) || !kernel.move(direction, pushed)) {
+                    return false;
+                }
+                step = Lurd::toChar(direction, pushed);
+            }
+            return true;
+        });
+    }
+
+    // Levels beyond the largest kernel go through the game itself.
+    Game game;
+    game.loadLevel(map);
+    for (char& step : lurd) {
+        EFacing direction;
+        if (!Lurd::toFacing(step, direction)) {
+            return false;
+        }
+        std::vector<Position> boxes = game.getBoxPositions();
+        int movesBefore = game.getMoveCount();
+        game.movePlayer(direction);
+        if (game.getMoveCount() == movesBefore) {
+            return false;
+        }
+        step = Lurd::toChar(direction, game.getBoxPositions() != boxes);
+    }
+    return true;
+}
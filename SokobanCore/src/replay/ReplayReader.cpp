@@ -0,0 +1,199 @@
+#include "replay/ReplayReader.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    uint64_t getUint(const uint8_t* data, int bytes) {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) {
+            value = value << 8 | data[i];
+        }
+        return value;
+    }
+
+    bool readVarint(const uint8_t* data, size_t end, size_t& offset, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < end; shift += 7) {
+            uint8_t byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+ReplayReader::ReplayReader(const std::string& path)
+    : _path(path),
+      _mapped(nullptr),
+      _mappedSize(0),
+      _count(0),
+      _recordsEnd(0)
+{
+    mapFile();
+    try {
+        readIndex();
+    } catch (...) {
+#ifndef _WIN32
+        ::munmap(const_cast<uint8_t*>(_mapped), _mappedSize);
+#endif
+        throw;
+    }
+}
+
+ReplayReader::~ReplayReader() {
+#ifndef _WIN32
+    ::munmap(const_cast<uint8_t*>(_mapped), _mappedSize);
+#endif
+}
+
+void ReplayReader::mapFile() {
+    std::error_code error;
+    _mappedSize = static_cast<size_t>(fs::file_size(_path, error));
+    if (error) {
+        throw std::runtime_error("Failed to open replay archive " + _path);
+    }
+    if (_mappedSize < ReplayFormat::HeaderSize + ReplayFormat::FooterSize) {
+        throw std::runtime_error("Replay archive " + _path + " is truncated");
+    }
+#ifndef _WIN32
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open replay archive " + _path);
+    }
+    void* view = ::mmap(nullptr, _mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map replay archive " + _path);
+    }
+    _mapped = static_cast<const uint8_t*>(view);
+#else
+    std::ifstream file(_path, std::ios::binary);
+    _buffer.resize(_mappedSize);
+    file.read(reinterpret_cast<char*>(_buffer.data()), static_cast<std::streamsize>(_mappedSize));
+    _mapped = _buffer.data();
+#endif
+}
+
+void ReplayReader::readIndex() {
+    const uint8_t* footer = _mapped + _mappedSize - ReplayFormat::FooterSize;
+    if (std::memcmp(_mapped, ReplayFormat::Magic, sizeof(ReplayFormat::Magic)) != 0 ||
+        std::memcmp(footer + 20, ReplayFormat::IndexMagic, sizeof(ReplayFormat::IndexMagic)) != 0) {
+        throw std::runtime_error(_path + " is not a finished replay archive");
+    }
+    if (getUint(_mapped + sizeof(ReplayFormat::Magic), 4) != ReplayFormat::Version ||
+        getUint(footer + 16, 4) != ReplayFormat::RecordsPerBlock) {
+        throw std::runtime_error("Unsupported replay archive version in " + _path);
+    }
+
+    const std::runtime_error corrupt("Corrupt replay archive index in " + _path);
+    uint64_t indexOffset = getUint(footer, 8);
+    size_t end = _mappedSize - ReplayFormat::FooterSize;
+    if (indexOffset < ReplayFormat::HeaderSize || indexOffset > end) {
+        throw corrupt;
+    }
+    _recordsEnd = static_cast<size_t>(indexOffset);
+    _count = static_cast<size_t>(getUint(footer + 8, 8));
+
+    size_t offset = _recordsEnd;
+    uint64_t levelCount;
+    if (!readVarint(_mapped, end, offset, levelCount) || levelCount > end - offset) {
+        throw corrupt;
+    }
+    for (uint64_t i = 0; i < levelCount; ++i) {
+        uint64_t id;
+        if (end - offset < 8) {
+            throw corrupt;
+        }
+        _levelHashes.push_back(getUint(_mapped + offset, 8));
+        offset += 8;
+        if (!readVarint(_mapped, end, offset, id)) {
+            throw corrupt;
+        }
+        _levelIds.push_back(static_cast<int>(static_cast<int64_t>(id >> 1) ^ -static_cast<int64_t>(id & 1)));
+    }
+
+    uint64_t blockCount;
+    if (!readVarint(_mapped, end, offset, blockCount) ||
+        blockCount != (_count + ReplayFormat::RecordsPerBlock - 1) / ReplayFormat::RecordsPerBlock) {
+        throw corrupt;
+    }
+    uint64_t block = 0;
+    for (uint64_t i = 0; i < blockCount; ++i) {
+        uint64_t delta;
+        if (!readVarint(_mapped, end, offset, delta) || delta > _recordsEnd - block) {
+            throw corrupt;
+        }
+        block += delta;
+        _blocks.push_back(block);
+    }
+    if (offset != end) {
+        throw corrupt;
+    }
+}
+
+ReplayInfo ReplayReader::get(size_t index) const {
+    if (index >= _count) {
+        throw std::out_of_range("Replay index out of range");
+    }
+    ReplayInfo info;
+    parse(seek(index), info);
+    return info;
+}
+
+std::string ReplayReader::decode(const ReplayInfo& info) const {
+    std::string lurd(info.moves, '\0');
+    if (!ReplayCodec::decode(info.payload, info.payloadSize, info.encoding, info.moves, &lurd[0])) {
+        throw std::runtime_error("Corrupt replay record in " + _path);
+    }
+    return lurd;
+}
+
+size_t ReplayReader::seek(size_t index) const {
+    if (index >= _count) {
+        return _recordsEnd;
+    }
+    size_t offset = static_cast<size_t>(_blocks[index / ReplayFormat::RecordsPerBlock]);
+    ReplayInfo skipped;
+    for (size_t i = 0; i < index % ReplayFormat::RecordsPerBlock; ++i) {
+        offset = parse(offset, skipped);
+    }
+    return offset;
+}
+
+size_t ReplayReader::parse(size_t offset, ReplayInfo& info) const {
+    uint64_t head;
+    uint64_t moves;
+    uint64_t pushes;
+    if (!readVarint(_mapped, _recordsEnd, offset, head) || !readVarint(_mapped, _recordsEnd, offset, moves) ||
+        !readVarint(_mapped, _recordsEnd, offset, pushes) || (head >> 2) >= _levelHashes.size() ||
+        (head & 3) > ReplayFormat::ShortRuns || moves > UINT32_MAX || pushes > moves) {
+        throw std::runtime_error("Corrupt replay record in " + _path);
+    }
+    info.levelHash = _levelHashes[head >> 2];
+    info.levelId = _levelIds[head >> 2];
+    info.moves = static_cast<uint32_t>(moves);
+    info.pushes = static_cast<uint32_t>(pushes);
+    info.encoding = static_cast<uint8_t>(head & 3);
+
+    uint64_t payloadSize = (moves + 3) / 4;
+    if (info.encoding != ReplayFormat::Packed && !readVarint(_mapped, _recordsEnd, offset, payloadSize)) {
+        throw std::runtime_error("Corrupt replay record in " + _path);
+    }
+    if (payloadSize > _recordsEnd - offset) {
+        throw std::runtime_error("Corrupt replay record in " + _path);
+    }
+    info.payload = _mapped + offset;
+    info.payloadSize = static_cast<size_t>(payloadSize);
+    return offset + info.payloadSize;
+}
@@ -0,0 +1,133 @@
+#include "replay/ReplayWriter.h"
+#include <stdexcept>
+#include "solver/Lurd.h"
+
+namespace {
+    const size_t FlushSize = 1 << 20;
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void putUint(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+}
+
+ReplayWriter::ReplayWriter(const std::string& path)
+    : _path(path),
+      _file(path, std::ios::binary | std::ios::trunc),
+      _offset(0),
+      _count(0),
+      _finished(false)
+{
+    if (!_file.is_open()) {
+        throw std::runtime_error("Failed to create replay archive " + path);
+    }
+    _buffer.reserve(FlushSize + 4096);
+    _buffer.insert(_buffer.end(), ReplayFormat::Magic, ReplayFormat::Magic + sizeof(ReplayFormat::Magic));
+    putUint(_buffer, ReplayFormat::Version, 4);
+    putUint(_buffer, 0, 4);
+    _offset = _buffer.size();
+}
+
+ReplayWriter::~ReplayWriter() {
+    try {
+        finish();
+    } catch (const std::exception&) {
+    }
+}
+
+void ReplayWriter::add(uint64_t levelHash, int levelId, const std::string& lurd) {
+    ReplayInfo info;
+    info.levelHash = levelHash;
+    info.levelId = levelId;
+    if (!ReplayCodec::encode(lurd, _payload, info.encoding)) {
+        throw std::runtime_error("Replay is not a LURD string");
+    }
+    info.moves = static_cast<uint32_t>(lurd.size());
+    info.pushes = static_cast<uint32_t>(Lurd::countPushes(lurd));
+    info.payload = _payload.data();
+    info.payloadSize = _payload.size();
+    add(info);
+}
+
+void ReplayWriter::add(const ReplayInfo& info) {
+    if (_finished) {
+        throw std::runtime_error("Replay archive " + _path + " is already finished");
+    }
+    if (_count % ReplayFormat::RecordsPerBlock == 0) {
+        _blocks.push_back(_offset);
+    }
+    size_t start = _buffer.size();
+    uint64_t slot = getSlot(info.levelHash, info.levelId);
+    putVarint(_buffer, slot << 2 | info.encoding);
+    putVarint(_buffer, info.moves);
+    putVarint(_buffer, info.pushes);
+    if (info.encoding != ReplayFormat::Packed) {
+        putVarint(_buffer, info.payloadSize);
+    }
+    _buffer.insert(_buffer.end(), info.payload, info.payload + info.payloadSize);
+    _offset += _buffer.size() - start;
+    ++_count;
+    if (_buffer.size() >= FlushSize) {
+        flushBuffer();
+    }
+}
+
+void ReplayWriter::finish() {
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+    uint64_t indexOffset = _offset;
+    size_t start = _buffer.size();
+    putVarint(_buffer, _levels.size());
+    for (const auto& level : _levels) {
+        putUint(_buffer, level.first, 8);
+        // Zigzag, so negative ids stay short.
+        int64_t id = level.second;
+        putVarint(_buffer, static_cast<uint64_t>(id) << 1 ^ static_cast<uint64_t>(id >> 63));
+    }
+    putVarint(_buffer, _blocks.size());
+    uint64_t previous = 0;
+    for (uint64_t block : _blocks) {
+        putVarint(_buffer, block - previous);
+        previous = block;
+    }
+    putUint(_buffer, indexOffset, 8);
+    putUint(_buffer, _count, 8);
+    putUint(_buffer, ReplayFormat::RecordsPerBlock, 4);
+    _buffer.insert(_buffer.end(), ReplayFormat::IndexMagic, ReplayFormat::IndexMagic + sizeof(ReplayFormat::IndexMagic));
+    _offset += _buffer.size() - start;
+    flushBuffer();
+    _file.close();
+    if (_file.fail()) {
+        throw std::runtime_error("Failed to write replay archive " + _path);
+    }
+}
+
+uint32_t ReplayWriter::getSlot(uint64_t levelHash, int levelId) {
+    auto it = _slots.find(levelHash);
+    if (it != _slots.end()) {
+        return it->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(_levels.size());
+    _levels.emplace_back(levelHash, levelId);
+    _slots.emplace(levelHash, slot);
+    return slot;
+}
+
+void ReplayWriter::flushBuffer() {
+    _file.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+    if (!_file) {
+        throw std::runtime_error("Failed to write replay archive " + _path);
+    }
+    _buffer.clear();
+}
@@ -0,0 +1,89 @@
+#include "solver/Arena.h"
+#include <algorithm>
+#include <new>
+
+BumpArena::BumpArena(size_t blockSize)
+    : _blockSize(blockSize),
+      _cursor(nullptr),
+      _end(nullptr),
+      _bytesReserved(0),
+      _peakBytesReserved(0),
+      _allocationCount(0),
+      _systemAllocationCount(0) {}
+
+BumpArena::~BumpArena() {
+    release();
+}
+
+void* BumpArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(_cursor);
+    uintptr_t aligned = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (_cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(_end)) {
+        addBlock(bytes + alignment);
+        address = reinterpret_cast<uintptr_t>(_cursor);
+        aligned = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+    _cursor = reinterpret_cast<char*>(aligned + bytes);
+    ++_allocationCount;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void BumpArena::release() {
+    for (char* block : _blocks) {
+        ::operator delete(block);
+    }
+    _blocks.clear();
+    _cursor = nullptr;
+    _end = nullptr;
+    _bytesReserved = 0;
+}
+
+void BumpArena::addBlock(size_t minimumSize) {
+    size_t size = std::max(_blockSize, minimumSize);
+    char* block = static_cast<char*>(::operator new(size));
+    _blocks.push_back(block);
+    _cursor = block;
+    _end = block + size;
+    _bytesReserved += size;
+    _peakBytesReserved = std::max(_peakBytesReserved, _bytesReserved);
+    ++_systemAllocationCount;
+}
+
+NodePool::NodePool(BumpArena& arena, size_t slotSize, size_t slotsPerChunk)
+    : _arena(arena),
+      _slotSize(std::max(slotSize, sizeof(FreeSlot))),
+      _slotsPerChunk(slotsPerChunk),
+      _cursor(nullptr),
+      _end(nullptr),
+      _freeList(nullptr),
+      _liveCount(0),
+      _peakLiveCount(0)
+{
+    const size_t alignment = alignof(void*);
+    _slotSize = (_slotSize + alignment - 1) / alignment * alignment;
+}
+
+void* NodePool::allocate() {
+    void* slot;
+    if (_freeList != nullptr) {
+        slot = _freeList;
+        _freeList = _freeList->next;
+    } else {
+        if (_cursor == _end) {
+            _cursor = static_cast<char*>(_arena.allocate(_slotSize * _slotsPerChunk, alignof(void*)));
+            _end = _cursor + _slotSize * _slotsPerChunk;
+        }
+        slot = _cursor;
+        _cursor += _slotSize;
+    }
+    ++_liveCount;
+    _peakLiveCount = std::max(_peakLiveCount, _liveCount);
+    return slot;
+}
+
+void NodePool::free(void* slot) {
+    FreeSlot* freed = static_cast<FreeSlot*>(slot);
+    freed->next = _freeList;
+    _freeList = freed;
+    --_liveCount;
+}
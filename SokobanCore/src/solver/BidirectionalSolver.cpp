@@ -0,0 +1,330 @@
+#include "solver/Solver.h"
+#include "solver/Lurd.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// States claimed by either search direction, split into independently
+// locked shards. A state claimed by the other direction is a meeting point.
+class Solver::SharedStateTable {
+public:
+    enum class Claim {
+        Inserted,
+        Duplicate,
+        Met,
+    };
+
+    explicit SharedStateTable(int boxCount)
+        : stop(false), expanded(0), forwardMeeting(nullptr), backwardMeeting(nullptr), _hash{boxCount} {
+        for (size_t i = 0; i < ShardCount; ++i) {
+            _shards.emplace_back(new Shard(boxCount));
+        }
+    }
+
+    Claim claim(SearchNode* node, bool forward, SearchNode*& other) {
+        Shard& shard = *_shards[(_hash(node) >> 7) % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto inserted = shard.states.emplace(node, forward);
+        if (inserted.second) {
+            return Claim::Inserted;
+        }
+        if (inserted.first->second == forward) {
+            return Claim::Duplicate;
+        }
+        other = inserted.first->first;
+        return Claim::Met;
+    }
+
+    void recordMeeting(SearchNode* forwardNode, SearchNode* backwardNode) {
+        std::lock_guard<std::mutex> lock(meetingMutex);
+        if (forwardMeeting == nullptr) {
+            forwardMeeting = forwardNode;
+            backwardMeeting = backwardNode;
+        }
+        stop = true;
+    }
+
+    size_t getPeakMemoryBytes() const {
+        size_t total = 0;
+        for (const auto& shard : _shards) {
+            total += shard->arena.getPeakBytesReserved();
+        }
+        return total;
+    }
+
+    uint64_t getAllocationCount() const {
+        uint64_t total = 0;
+        for (const auto& shard : _shards) {
+            total += shard->arena.getAllocationCount();
+        }
+        return total;
+    }
+
+    uint64_t getSystemAllocationCount() const {
+        uint64_t total = 0;
+        for (const auto& shard : _shards) {
+            total += shard->arena.getSystemAllocationCount();
+        }
+        return total;
+    }
+
+    std::atomic<bool> stop;
+    std::atomic<uint64_t> expanded;
+    std::mutex meetingMutex;
+    SearchNode* forwardMeeting;
+    SearchNode* backwardMeeting;
+
+private:
+    static constexpr size_t ShardCount = 64;
+
+    struct Shard {
+        explicit Shard(int boxCount)
+            : arena(64 * 1024),
+              states(64, SearchNodeHash{boxCount}, SearchNodeEqual{boxCount},
+                     ArenaAllocator<std::pair<SearchNode* const, bool>>(arena)) {}
+
+        std::mutex mutex;
+        BumpArena arena;
+        std::unordered_map<SearchNode*, bool, SearchNodeHash, SearchNodeEqual,
+                           ArenaAllocator<std::pair<SearchNode* const, bool>>> states;
+    };
+
+    SearchNodeHash _hash;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+struct Solver::SideResult {
+    explicit SideResult(int boxCount) : pool(arena, SearchNode::slotSize(boxCount)) {}
+
+    BumpArena arena;
+    NodePool pool;
+    uint64_t nodesExpanded = 0;
+    uint64_t nodesGenerated = 0;
+    uint64_t macroPushes = 0;
+    bool exhausted = false;
+    std::exception_ptr error;
+};
+
+SolverResult Solver::solveBidirectional(const SolverOptions& options) {
+    SolverResult result;
+    SharedStateTable table(_boxCount);
+    SideResult forwardSide(_boxCount);
+    SideResult backwardSide(_boxCount);
+
+    auto run = [&](bool forward, SideResult& side) {
+        try {
+            runSide(forward, options, table, side);
+        } catch (...) {
+            side.error = std::current_exception();
+            table.stop = true;
+        }
+    };
+    std::thread forwardThread(run, true, std::ref(forwardSide));
+    std::thread backwardThread(run, false, std::ref(backwardSide));
+    forwardThread.join();
+    backwardThread.join();
+
+    for (SideResult* side : {&forwardSide, &backwardSide}) {
+        if (side->error) {
+            std::rethrow_exception(side->error);
+        }
+    }
+
+    if (table.forwardMeeting != nullptr) {
+        SearchContext context(_board, _boxCount);
+        result.solved = true;
+        result.solution = reconstruct(context, table.forwardMeeting);
+        if (table.backwardMeeting != nullptr) {
+            result.solution += reconstructBackward(context, table.backwardMeeting, table.forwardMeeting->player);
+        }
+        result.pushes = Lurd::countPushes(result.solution);
+        result.moves = static_cast<int>(result.solution.size());
+    } else {
+        result.exhausted = forwardSide.exhausted || backwardSide.exhausted;
+    }
+
+    result.nodesExpanded = forwardSide.nodesExpanded + backwardSide.nodesExpanded;
+    result.nodesGenerated = forwardSide.nodesGenerated + backwardSide.nodesGenerated;
+    result.macroPushes = forwardSide.macroPushes;
+    result.peakMemoryBytes = forwardSide.arena.getPeakBytesReserved() + backwardSide.arena.getPeakBytesReserved() +
+                             table.getPeakMemoryBytes();
+    result.arenaAllocations = forwardSide.arena.getAllocationCount() + backwardSide.arena.getAllocationCount() +
+                              table.getAllocationCount();
+    result.systemAllocations = forwardSide.arena.getSystemAllocationCount() +
+                               backwardSide.arena.getSystemAllocationCount() + table.getSystemAllocationCount();
+    return result;
+}
+
+void Solver::runSide(bool forward, const SolverOptions& options, SharedStateTable& table, SideResult& side) {
+    auto startTime = std::chrono::steady_clock::now();
+    SearchContext context(_board, _boxCount);
+    std::vector<OpenEntry, ArenaAllocator<OpenEntry>> openStorage{ArenaAllocator<OpenEntry>(side.arena)};
+    openStorage.reserve(1024);
+    OpenList open(std::greater<OpenEntry>(), std::move(openStorage));
+    std::vector<SearchNode*> children;
+
+    if (forward) {
+        SearchNode* root = createRoot(side.pool, _board.getInitialBoxes(), _board.getPlayerStart());
+        int h = heuristic(root->boxes());
+        if (h >= 0) {
+            open.push({h, h, root});
+        }
+    } else {
+        // The solved position with the player in every region it could have
+        // finished the last push from.
+        SearchNode* solved = createRoot(side.pool, _board.getTargets(), _board.getPlayerStart());
+        context.setOccupied(solved->boxes(), 1);
+        std::vector<uint8_t> covered(_board.getCellCount(), 0);
+        for (int cell = 0; cell < _board.getCellCount(); ++cell) {
+            if (!context.isFree(cell) || covered[cell]) {
+                continue;
+            }
+            context.computeReach(cell);
+            bool touchesBox = false;
+            for (int reached = 0; reached < _board.getCellCount(); ++reached) {
+                if (!context.isReachable(reached)) {
+                    continue;
+                }
+                covered[reached] = 1;
+                for (int dir = 0; dir < Board::DirectionCount && !touchesBox; ++dir) {
+                    int next = _board.neighbor(reached, dir);
+                    touchesBox = next >= 0 && context.isOccupied(next);
+                }
+            }
+            if (touchesBox) {
+                SearchNode* root = createRoot(side.pool, _board.getTargets(), cell);
+                int h = backwardHeuristic(root->boxes());
+                open.push({h, h, root});
+            }
+        }
+        context.setOccupied(solved->boxes(), 0);
+        side.pool.free(solved);
+    }
+
+    while (!table.stop) {
+        if (open.empty()) {
+            // Either direction running dry proves there is no solution.
+            side.exhausted = true;
+            table.stop = true;
+            break;
+        }
+        if (table.expanded >= options.maxNodes || options.isCancelled()) {
+            table.stop = true;
+            break;
+        }
+        if (options.timeLimitMs > 0.0 && (side.nodesExpanded & 1023) == 0) {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+            if (elapsed.count() > options.timeLimitMs) {
+                table.stop = true;
+                break;
+            }
+        }
+
+        SearchNode* current = open.top().node;
+        open.pop();
+        const uint16_t* boxes = current->boxes();
+        context.setOccupied(boxes, 1);
+        current->normalizedPlayer = static_cast<uint16_t>(context.computeReach(current->player));
+
+        SearchNode* other = nullptr;
+        SharedStateTable::Claim claim = table.claim(current, forward, other);
+        if (claim == SharedStateTable::Claim::Duplicate) {
+            context.setOccupied(boxes, 0);
+            side.pool.free(current);
+            continue;
+        }
+        if (claim == SharedStateTable::Claim::Met) {
+            context.setOccupied(boxes, 0);
+            table.recordMeeting(forward ? current : other, forward ? other : current);
+            break;
+        }
+        if (forward && context.isSolved(boxes)) {
+            context.setOccupied(boxes, 0);
+            table.recordMeeting(current, nullptr);
+            break;
+        }
+
+        ++side.nodesExpanded;
+        ++table.expanded;
+        if (forward) {
+            generatePushes(context, side.pool, current, options.useTunnelMacros, children);
+        } else {
+            generatePulls(context, side.pool, current, children);
+        }
+        context.setOccupied(boxes, 0);
+
+        for (SearchNode* child : children) {
+            int h = forward ? heuristic(child->boxes()) : backwardHeuristic(child->boxes());
+            open.push({static_cast<int>(child->pushes) + h, h, child});
+            side.macroPushes += child->pushLength - 1;
+        }
+        side.nodesGenerated += children.size();
+    }
+}
+
+void Solver::generatePulls(SearchContext& context, NodePool& pool, SearchNode* current,
+                           std::vector<SearchNode*>& children) const {
+    // Pulling a box from b towards d needs the player on b + d with room to
+    // step back onto b + 2d; it is the exact reverse of a push.
+    children.clear();
+    const uint16_t* boxes = current->boxes();
+    for (int i = 0; i < _boxCount; ++i) {
+        int box = boxes[i];
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            int puller = _board.neighbor(box, dir);
+            if (puller < 0 || !context.isReachable(puller)) {
+                continue;
+            }
+            int retreat = _board.neighbor(puller, dir);
+            if (!context.isFree(retreat)) {
+                continue;
+            }
+
+            SearchNode* child = static_cast<SearchNode*>(pool.allocate());
+            uint16_t* childBoxes = child->boxes();
+            std::copy(boxes, boxes + _boxCount, childBoxes);
+            childBoxes[i] = static_cast<uint16_t>(puller);
+            std::sort(childBoxes, childBoxes + _boxCount);
+            child->parent = current;
+            child->pushes = current->pushes + 1;
+            child->player = static_cast<uint16_t>(retreat);
+            child->normalizedPlayer = child->player;
+            child->pushedFrom = static_cast<uint16_t>(box);
+            child->pushLength = 1;
+            child->direction = static_cast<uint8_t>(dir);
+            children.push_back(child);
+        }
+    }
+}
+
+int Solver::backwardHeuristic(const uint16_t* boxes) const {
+    const int width = _board.getWidth();
+    int total = 0;
+    for (int i = 0; i < _boxCount; ++i) {
+        int best = _board.getCellCount();
+        for (int start : _board.getInitialBoxes()) {
+            int distance = std::abs(boxes[i] / width - start / width) + std::abs(boxes[i] % width - start % width);
+            best = std::min(best, distance);
+        }
+        total += best;
+    }
+    return total;
+}
+
+std::string Solver::reconstructBackward(SearchContext& context, const SearchNode* meeting, int player) const {
+    // Walking the pull chain back towards the solved position replays each
+    // pull as the push that undoes it.
+    std::string solution;
+    for (const SearchNode* node = meeting; node->parent != nullptr; node = node->parent) {
+        solution += context.walkPath(node->boxes(), player, node->player);
+        solution += Lurd::toChar(Board::toFacing(Board::opposite(node->direction)), true);
+        player = _board.neighbor(node->pushedFrom, node->direction);
+    }
+    return solution;
+}
@@ -0,0 +1,224 @@
+#include "solver/Board.h"
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+namespace {
+    const int RowOffsets[Board::DirectionCount] = {0, -1, 1, 0};
+    const int ColOffsets[Board::DirectionCount] = {-1, 0, 0, 1};
+}
+
+Board::Board(const GameMap& map)
+    : _width(map.getWidth()),
+      _height(map.getHeight()),
+      _playerStart(0),
+      _floorCount(0),
+      _deadCount(0),
+      _tunnelCount(0),
+      _articulationCount(0)
+{
+    const int cellCount = getCellCount();
+    _floor.assign(cellCount, 0);
+    _target.assign(cellCount, 0);
+    _dead.assign(cellCount, 0);
+    _tunnel.assign(cellCount, 0);
+    _articulation.assign(cellCount, 0);
+    _goalDistance.assign(cellCount, Unreachable);
+
+    auto checkBounds = [this](const Position& pos) {
+        if (pos.getRow() < 0 || pos.getRow() >= _height || pos.getCol() < 0 || pos.getCol() >= _width) {
+            throw std::runtime_error("Level position out of bounds");
+        }
+    };
+
+    checkBounds(map.getPlayerStart());
+    _playerStart = toCell(map.getPlayerStart());
+    for (const auto& pos : map.getBoxPositions()) {
+        checkBounds(pos);
+        _initialBoxes.push_back(toCell(pos));
+    }
+
+    for (int row = 0; row < _height; ++row) {
+        for (int col = 0; col < _width; ++col) {
+            int cell = row * _width + col;
+            ETileType tile = map.getTileAt(row, col);
+            _floor[cell] = tile != ETileType::WALL ? 1 : 0;
+        }
+    }
+
+    computeFloor();
+
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (_floor[cell] && map.getTileAt(cell / _width, cell % _width) == ETileType::TARGET) {
+            _target[cell] = 1;
+            _targets.push_back(cell);
+        }
+    }
+
+    computeGoalDistances();
+    computeTunnels();
+    computeArticulationPoints();
+}
+
+int Board::neighbor(int cell, int direction) const {
+    int row = cell / _width + RowOffsets[direction];
+    int col = cell % _width + ColOffsets[direction];
+    if (row < 0 || row >= _height || col < 0 || col >= _width) {
+        return -1;
+    }
+    return row * _width + col;
+}
+
+bool Board::isTunnel(int cell, int direction) const {
+    bool horizontal = direction == toDirection(EFacing::LEFT) || direction == toDirection(EFacing::RIGHT);
+    return _tunnel[cell] == (horizontal ? 1 : 2);
+}
+
+EFacing Board::toFacing(int direction) {
+    return static_cast<EFacing>(direction);
+}
+
+int Board::toDirection(EFacing facing) {
+    return static_cast<int>(facing);
+}
+
+void Board::computeFloor() {
+    std::vector<uint8_t> reachable(getCellCount(), 0);
+    std::deque<int> queue;
+    if (_floor[_playerStart]) {
+        reachable[_playerStart] = 1;
+        queue.push_back(_playerStart);
+    }
+    while (!queue.empty()) {
+        int cell = queue.front();
+        queue.pop_front();
+        for (int dir = 0; dir < DirectionCount; ++dir) {
+            int next = neighbor(cell, dir);
+            if (next >= 0 && _floor[next] && !reachable[next]) {
+                reachable[next] = 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    _floor.swap(reachable);
+
+    _floorCount = 0;
+    for (uint8_t floor : _floor) {
+        _floorCount += floor;
+    }
+}
+
+void Board::computeGoalDistances() {
+    // Pull boxes backwards from every target: a box can reach a target from
+    // exactly the cells this reverse search visits, everything else is dead.
+    std::deque<int> queue;
+    for (int target : _targets) {
+        _goalDistance[target] = 0;
+        queue.push_back(target);
+    }
+    while (!queue.empty()) {
+        int cell = queue.front();
+        queue.pop_front();
+        for (int dir = 0; dir < DirectionCount; ++dir) {
+            int from = neighbor(cell, opposite(dir));
+            if (from < 0 || !_floor[from] || _goalDistance[from] != Unreachable) {
+                continue;
+            }
+            int pusher = neighbor(from, opposite(dir));
+            if (pusher < 0 || !_floor[pusher]) {
+                continue;
+            }
+            _goalDistance[from] = _goalDistance[cell] + 1;
+            queue.push_back(from);
+        }
+    }
+
+    _deadCount = 0;
+    for (int cell = 0; cell < getCellCount(); ++cell) {
+        if (_floor[cell] && _goalDistance[cell] == Unreachable) {
+            _dead[cell] = 1;
+            ++_deadCount;
+        }
+    }
+}
+
+void Board::computeTunnels() {
+    // Bit 0 marks a horizontal corridor cell, bit 1 a vertical one.
+    auto isOpen = [this](int cell) { return cell >= 0 && _floor[cell]; };
+    _tunnelCount = 0;
+    for (int cell = 0; cell < getCellCount(); ++cell) {
+        if (!_floor[cell]) {
+            continue;
+        }
+        bool left = isOpen(neighbor(cell, 0));
+        bool up = isOpen(neighbor(cell, 1));
+        bool down = isOpen(neighbor(cell, 2));
+        bool right = isOpen(neighbor(cell, 3));
+        if (left && right && !up && !down) {
+            _tunnel[cell] = 1;
+        } else if (up && down && !left && !right) {
+            _tunnel[cell] = 2;
+        }
+        if (_tunnel[cell]) {
+            ++_tunnelCount;
+        }
+    }
+}
+
+void Board::computeArticulationPoints() {
+    // Iterative Tarjan lowlink search; levels can be large enough that a
+    // recursive DFS would be a stack risk.
+    const int cellCount = getCellCount();
+    std::vector<int> discovery(cellCount, -1);
+    std::vector<int> low(cellCount, 0);
+    std::vector<int> parent(cellCount, -1);
+    std::vector<int> nextDirection(cellCount, 0);
+    std::vector<int> stack;
+    int time = 0;
+
+    for (int root = 0; root < cellCount; ++root) {
+        if (!_floor[root] || discovery[root] >= 0) {
+            continue;
+        }
+        int rootChildren = 0;
+        discovery[root] = low[root] = time++;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int cell = stack.back();
+            if (nextDirection[cell] < DirectionCount) {
+                int next = neighbor(cell, nextDirection[cell]++);
+                if (next < 0 || !_floor[next]) {
+                    continue;
+                }
+                if (discovery[next] < 0) {
+                    parent[next] = cell;
+                    discovery[next] = low[next] = time++;
+                    if (cell == root) {
+                        ++rootChildren;
+                    }
+                    stack.push_back(next);
+                } else if (next != parent[cell]) {
+                    low[cell] = std::min(low[cell], discovery[next]);
+                }
+                continue;
+            }
+
+            stack.pop_back();
+            int up = parent[cell];
+            if (up >= 0) {
+                low[up] = std::min(low[up], low[cell]);
+                if (up != root && low[cell] >= discovery[up]) {
+                    _articulation[up] = 1;
+                }
+            }
+        }
+        if (rootChildren > 1) {
+            _articulation[root] = 1;
+        }
+    }
+
+    _articulationCount = 0;
+    for (uint8_t articulation : _articulation) {
+        _articulationCount += articulation;
+    }
+}
@@ -0,0 +1,440 @@
+#include "solver/Solver.h"
+#include "solver/Lurd.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+    // Sorted runs of fixed-size records are front coded: every record stores
+    // how many leading bytes it shares with the previous one, then the rest.
+    class RunWriter {
+    public:
+        RunWriter(const fs::path& path, size_t recordSize)
+            : _out(path, std::ios::binary | std::ios::trunc), _recordSize(recordSize),
+              _previous(recordSize, 0), _count(0), _bytesWritten(0) {
+            if (!_out.is_open()) {
+                throw std::runtime_error("Failed to create " + path.string());
+            }
+        }
+
+        void write(const uint8_t* record) {
+            size_t prefix = 0;
+            if (_count > 0) {
+                while (prefix < _recordSize && record[prefix] == _previous[prefix]) {
+                    ++prefix;
+                }
+            }
+            _out.put(static_cast<char>(prefix));
+            _out.write(reinterpret_cast<const char*>(record + prefix), _recordSize - prefix);
+            std::memcpy(_previous.data(), record, _recordSize);
+            _bytesWritten += 1 + _recordSize - prefix;
+            ++_count;
+        }
+
+        void close() {
+            _out.close();
+            if (_out.fail()) {
+                throw std::runtime_error("Failed to write search run");
+            }
+        }
+
+        uint64_t getCount() const { return _count; }
+        uint64_t getBytesWritten() const { return _bytesWritten; }
+
+    private:
+        std::ofstream _out;
+        size_t _recordSize;
+        std::vector<uint8_t> _previous;
+        uint64_t _count;
+        uint64_t _bytesWritten;
+    };
+
+    class RunReader {
+    public:
+        RunReader(const fs::path& path, size_t recordSize)
+            : _in(path, std::ios::binary), _recordSize(recordSize), _current(recordSize, 0), _valid(false) {
+            if (!_in.is_open()) {
+                throw std::runtime_error("Failed to open " + path.string());
+            }
+        }
+
+        bool next() {
+            int prefix = _in.get();
+            if (prefix == EOF || static_cast<size_t>(prefix) > _recordSize) {
+                _valid = false;
+                return false;
+            }
+            _in.read(reinterpret_cast<char*>(_current.data() + prefix), _recordSize - prefix);
+            _valid = static_cast<size_t>(_in.gcount()) == _recordSize - prefix;
+            return _valid;
+        }
+
+        bool isValid() const { return _valid; }
+        const uint8_t* current() const { return _current.data(); }
+
+    private:
+        std::ifstream _in;
+        size_t _recordSize;
+        std::vector<uint8_t> _current;
+        bool _valid;
+    };
+
+    void encodeState(const SearchNode* node, int boxCount, uint8_t* record) {
+        // Big-endian so byte order and numeric order agree when sorting.
+        record[0] = static_cast<uint8_t>(node->normalizedPlayer >> 8);
+        record[1] = static_cast<uint8_t>(node->normalizedPlayer & 0xFF);
+        const uint16_t* boxes = node->boxes();
+        for (int i = 0; i < boxCount; ++i) {
+            record[2 + i * 2] = static_cast<uint8_t>(boxes[i] >> 8);
+            record[3 + i * 2] = static_cast<uint8_t>(boxes[i] & 0xFF);
+        }
+    }
+
+    void decodeState(const uint8_t* record, int boxCount, SearchNode* node) {
+        node->normalizedPlayer = static_cast<uint16_t>(record[0] << 8 | record[1]);
+        node->player = node->normalizedPlayer;
+        uint16_t* boxes = node->boxes();
+        for (int i = 0; i < boxCount; ++i) {
+            boxes[i] = static_cast<uint16_t>(record[2 + i * 2] << 8 | record[3 + i * 2]);
+        }
+        node->parent = nullptr;
+        node->pushes = 0;
+        node->pushedFrom = 0;
+        node->pushLength = 0;
+        node->direction = 0;
+    }
+
+    std::string fingerprint(const Board& board) {
+        uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 1099511628211ULL;
+        };
+        mix(board.getWidth());
+        mix(board.getHeight());
+        for (int cell = 0; cell < board.getCellCount(); ++cell) {
+            mix(board.isFloor(cell) + 2 * board.isTarget(cell));
+        }
+        for (int box : board.getInitialBoxes()) {
+            mix(box);
+        }
+        mix(board.getPlayerStart());
+        std::ostringstream out;
+        out << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return out.str();
+    }
+
+    fs::path layerPath(const fs::path& directory, size_t depth) {
+        return directory / ("layer-" + std::to_string(depth) + ".run");
+    }
+
+    void removeSpillFiles(const fs::path& directory, size_t layerCount) {
+        for (size_t depth = 0; depth < layerCount; ++depth) {
+            fs::remove(layerPath(directory, depth));
+        }
+        fs::remove(directory / "checkpoint.json");
+        std::error_code ignored;
+        fs::remove(directory, ignored);
+    }
+}
+
+SolverResult Solver::solveExternal(const SolverOptions& options) {
+    // Breadth-first over push layers with delayed duplicate detection: each
+    // new layer is collected in memory-sized sorted runs, then merged and
+    // stripped of every state already stored in an earlier layer.
+    auto startTime = std::chrono::steady_clock::now();
+    SolverResult result;
+    const size_t recordSize = (1 + _boxCount) * sizeof(uint16_t);
+    if (recordSize > UINT8_MAX) {
+        throw std::runtime_error("Too many boxes for the external solver");
+    }
+
+    const fs::path directory(options.spillDirectory);
+    const fs::path checkpointPath = directory / "checkpoint.json";
+    fs::create_directories(directory);
+
+    SearchContext context(_board, _boxCount);
+    BumpArena arena;
+    NodePool pool(arena, SearchNode::slotSize(_boxCount));
+    std::vector<SearchNode*> children;
+    std::vector<uint8_t> record(recordSize);
+    const std::string levelFingerprint = fingerprint(_board);
+
+    auto normalize = [&](SearchNode* node) {
+        context.setOccupied(node->boxes(), 1);
+        node->normalizedPlayer = static_cast<uint16_t>(context.computeReach(node->player));
+        context.setOccupied(node->boxes(), 0);
+    };
+
+    std::vector<uint64_t> layerCounts;
+    std::ifstream checkpointFile(checkpointPath);
+    if (checkpointFile.is_open()) {
+        json checkpoint = json::parse(checkpointFile, nullptr, false);
+        if (!checkpoint.is_discarded() && checkpoint.value("fingerprint", "") == levelFingerprint) {
+            layerCounts = checkpoint.value("layerCounts", std::vector<uint64_t>());
+        }
+    }
+    checkpointFile.close();
+
+    auto saveCheckpoint = [&]() {
+        json checkpoint;
+        checkpoint["fingerprint"] = levelFingerprint;
+        checkpoint["recordSize"] = recordSize;
+        checkpoint["layerCounts"] = layerCounts;
+        fs::path temporary = checkpointPath;
+        temporary += ".tmp";
+        std::ofstream out(temporary, std::ios::trunc);
+        out << checkpoint.dump();
+        out.close();
+        fs::rename(temporary, checkpointPath);
+    };
+
+    // Anything not covered by the checkpoint is a leftover from an interrupted layer.
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        bool knownLayer = false;
+        for (size_t depth = 0; depth < layerCounts.size(); ++depth) {
+            knownLayer = knownLayer || entry.path() == layerPath(directory, depth);
+        }
+        if (entry.path().extension() == ".run" && !knownLayer) {
+            fs::remove(entry.path());
+        }
+    }
+
+    SearchNode* root = createRoot(pool, _board.getInitialBoxes(), _board.getPlayerStart());
+    normalize(root);
+    if (layerCounts.empty()) {
+        encodeState(root, _boxCount, record.data());
+        RunWriter writer(layerPath(directory, 0), recordSize);
+        writer.write(record.data());
+        writer.close();
+        layerCounts.push_back(1);
+        saveCheckpoint();
+    }
+
+    std::vector<uint8_t> goalRecord;
+    bool stopped = false;
+    if (context.isSolved(root->boxes())) {
+        encodeState(root, _boxCount, record.data());
+        goalRecord = record;
+    }
+
+    const size_t capacity = std::max<size_t>(1, options.memoryBudgetBytes / (recordSize + sizeof(uint32_t)));
+    std::vector<uint8_t> buffer;
+    std::vector<uint32_t> order;
+    std::vector<fs::path> runs;
+    SearchNode* parent = static_cast<SearchNode*>(pool.allocate());
+
+    auto flushRun = [&]() {
+        size_t count = buffer.size() / recordSize;
+        if (count == 0) {
+            return;
+        }
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return std::memcmp(&buffer[a * recordSize], &buffer[b * recordSize], recordSize) < 0;
+        });
+        fs::path path = directory / ("pending-" + std::to_string(runs.size()) + ".run");
+        RunWriter writer(path, recordSize);
+        const uint8_t* previous = nullptr;
+        for (uint32_t index : order) {
+            const uint8_t* current = &buffer[index * recordSize];
+            if (previous == nullptr || std::memcmp(previous, current, recordSize) != 0) {
+                writer.write(current);
+            }
+            previous = current;
+        }
+        writer.close();
+        result.bytesSpilled += writer.getBytesWritten();
+        result.peakMemoryBytes = std::max(result.peakMemoryBytes,
+                                          buffer.capacity() + order.capacity() * sizeof(uint32_t));
+        runs.push_back(path);
+        buffer.clear();
+    };
+
+    while (goalRecord.empty() && layerCounts.back() > 0 && !stopped) {
+        const size_t depth = layerCounts.size() - 1;
+        RunReader reader(layerPath(directory, depth), recordSize);
+        runs.clear();
+        buffer.clear();
+
+        while (goalRecord.empty() && reader.next()) {
+            if (result.nodesExpanded >= options.maxNodes || options.isCancelled()) {
+                stopped = true;
+                break;
+            }
+            if (options.timeLimitMs > 0.0 && (result.nodesExpanded & 1023) == 0) {
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+                if (elapsed.count() > options.timeLimitMs) {
+                    stopped = true;
+                    break;
+                }
+            }
+
+            decodeState(reader.current(), _boxCount, parent);
+            context.setOccupied(parent->boxes(), 1);
+            context.computeReach(parent->player);
+            generatePushes(context, pool, parent, false, children);
+            context.setOccupied(parent->boxes(), 0);
+            ++result.nodesExpanded;
+            result.nodesGenerated += children.size();
+
+            for (SearchNode* child : children) {
+                normalize(child);
+                encodeState(child, _boxCount, record.data());
+                if (goalRecord.empty() && context.isSolved(child->boxes())) {
+                    goalRecord = record;
+                }
+                buffer.insert(buffer.end(), record.begin(), record.end());
+                pool.free(child);
+                if (buffer.size() / recordSize >= capacity) {
+                    flushRun();
+                }
+            }
+        }
+        flushRun();
+
+        if (!goalRecord.empty() || stopped) {
+            for (const auto& run : runs) {
+                fs::remove(run);
+            }
+            break;
+        }
+
+        // Merge the runs and drop states seen in any earlier layer.
+        std::vector<std::unique_ptr<RunReader>> candidates;
+        std::vector<std::unique_ptr<RunReader>> previousLayers;
+        for (const auto& run : runs) {
+            candidates.emplace_back(new RunReader(run, recordSize));
+            candidates.back()->next();
+        }
+        for (size_t layer = 0; layer <= depth; ++layer) {
+            previousLayers.emplace_back(new RunReader(layerPath(directory, layer), recordSize));
+            previousLayers.back()->next();
+        }
+
+        auto greater = [&](size_t a, size_t b) {
+            return std::memcmp(candidates[a]->current(), candidates[b]->current(), recordSize) > 0;
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heads(greater);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (candidates[i]->isValid()) {
+                heads.push(i);
+            }
+        }
+
+        fs::path nextPath = layerPath(directory, depth + 1);
+        RunWriter writer(nextPath, recordSize);
+        std::vector<uint8_t> last;
+        while (!heads.empty()) {
+            size_t index = heads.top();
+            heads.pop();
+            std::memcpy(record.data(), candidates[index]->current(), recordSize);
+            if (candidates[index]->next()) {
+                heads.push(index);
+            }
+            if (!last.empty() && std::memcmp(last.data(), record.data(), recordSize) == 0) {
+                continue;
+            }
+            last = record;
+
+            bool seen = false;
+            for (auto& layer : previousLayers) {
+                while (layer->isValid() && std::memcmp(layer->current(), record.data(), recordSize) < 0) {
+                    layer->next();
+                }
+                if (layer->isValid() && std::memcmp(layer->current(), record.data(), recordSize) == 0) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen) {
+                writer.write(record.data());
+            }
+        }
+        writer.close();
+        result.bytesSpilled += writer.getBytesWritten();
+        candidates.clear();
+        previousLayers.clear();
+        for (const auto& run : runs) {
+            fs::remove(run);
+        }
+
+        layerCounts.push_back(writer.getCount());
+        saveCheckpoint();
+    }
+
+    if (!goalRecord.empty()) {
+        // Walk back one layer at a time, looking for a state with a push
+        // that leads to the state found so far.
+        struct Step {
+            std::vector<uint16_t> boxes;
+            int box;
+            int direction;
+        };
+        std::vector<Step> steps;
+        std::vector<uint8_t> target = goalRecord;
+        encodeState(root, _boxCount, record.data());
+        bool atRoot = target == record;
+
+        for (size_t depth = layerCounts.size(); depth-- > 0 && !atRoot;) {
+            RunReader reader(layerPath(directory, depth), recordSize);
+            bool found = false;
+            while (!found && reader.next()) {
+                decodeState(reader.current(), _boxCount, parent);
+                context.setOccupied(parent->boxes(), 1);
+                context.computeReach(parent->player);
+                generatePushes(context, pool, parent, false, children);
+                context.setOccupied(parent->boxes(), 0);
+                for (SearchNode* child : children) {
+                    normalize(child);
+                    encodeState(child, _boxCount, record.data());
+                    if (!found && record == target) {
+                        found = true;
+                        steps.push_back({std::vector<uint16_t>(parent->boxes(), parent->boxes() + _boxCount),
+                                         child->pushedFrom, child->direction});
+                        target.assign(reader.current(), reader.current() + recordSize);
+                    }
+                    pool.free(child);
+                }
+            }
+            if (!found) {
+                throw std::runtime_error("Spilled search layers are inconsistent");
+            }
+        }
+        std::reverse(steps.begin(), steps.end());
+
+        int player = _board.getPlayerStart();
+        for (const Step& step : steps) {
+            int pusher = _board.neighbor(step.box, Board::opposite(step.direction));
+            result.solution += context.walkPath(step.boxes.data(), player, pusher);
+            result.solution += Lurd::toChar(Board::toFacing(step.direction), true);
+            player = step.box;
+        }
+        result.solved = true;
+        result.pushes = static_cast<int>(steps.size());
+        result.moves = static_cast<int>(result.solution.size());
+        removeSpillFiles(directory, layerCounts.size());
+    } else if (!stopped) {
+        result.exhausted = true;
+        removeSpillFiles(directory, layerCounts.size());
+    }
+
+    result.peakMemoryBytes += arena.getPeakBytesReserved();
+    result.arenaAllocations = arena.getAllocationCount();
+    result.systemAllocations = arena.getSystemAllocationCount();
+    return result;
+}
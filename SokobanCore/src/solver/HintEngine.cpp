@@ -0,0 +1,212 @@
+#include "solver/HintEngine.h"
+#include "solver/Lurd.h"
+#include "solver/Solver.h"
+#include <algorithm>
+
+HintEngine::HintEngine()
+    : _pendingAtStart(false),
+      _hasRequest(false),
+      _shutdown(false),
+      _generation(0),
+      _hintReady(false),
+      _cancel(false),
+      _searching(false),
+      _cache(nullptr),
+      _worker(&HintEngine::run, this) {}
+
+HintEngine::~HintEngine() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shutdown = true;
+        _cancel = true;
+    }
+    _wake.notify_one();
+    _worker.join();
+}
+
+void HintEngine::request(const GameMap& state, bool atLevelStart) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending = state;
+        _pendingAtStart = atLevelStart;
+        _hasRequest = true;
+        _hintReady = false;
+        ++_generation;
+        _cancel = true;
+    }
+    _wake.notify_one();
+}
+
+void HintEngine::cancel() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hasRequest = false;
+    _hintReady = false;
+    ++_generation;
+    _cancel = true;
+}
+
+void HintEngine::setCache(SolutionCache* cache) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache = cache;
+}
+
+bool HintEngine::getHint(Hint& hint) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_hintReady) {
+        return false;
+    }
+    hint = _hint;
+    return true;
+}
+
+void HintEngine::run() {
+    while (true) {
+        GameMap state;
+        bool atLevelStart;
+        SolutionCache* cache;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _shutdown || _hasRequest; });
+            if (_shutdown) {
+                return;
+            }
+            state = std::move(_pending);
+            atLevelStart = _pendingAtStart;
+            cache = _cache;
+            generation = _generation;
+            _hasRequest = false;
+            _cancel = false;
+            _searching = true;
+        }
+
+        Hint hint;
+        bool finished;
+        try {
+            finished = compute(state, cache, atLevelStart, hint);
+        } catch (const std::exception&) {
+            finished = true;
+            hint = Hint();
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _searching = false;
+        if (finished && generation == _generation) {
+            _hint = hint;
+            _hintReady = true;
+        }
+    }
+}
+
+bool HintEngine::compute(const GameMap& state, SolutionCache* cache, bool atLevelStart, Hint& hint) {
+    prepareLevel(state);
+
+    std::vector<int> boxes;
+    bool solved = true;
+    for (const auto& pos : state.getBoxPositions()) {
+        boxes.push_back(_board->toCell(pos));
+        solved = solved && _board->isTarget(boxes.back());
+    }
+    if (solved) {
+        return true;
+    }
+
+    std::string key = stateKey(boxes, _board->toCell(state.getPlayerStart()));
+    auto planned = _plan.find(key);
+    if (planned == _plan.end()) {
+        // Any cached line will do for a hint, optimal or not.
+        SolverResult result;
+        CacheEntry cached;
+        if (cache != nullptr && cache->lookup(SolutionCache::contentHash(state), cached)) {
+            result.solved = cached.has(CacheEntry::Solved);
+            result.exhausted = cached.has(CacheEntry::Unsolvable);
+            result.solution = cached.solution;
+        }
+
+        SolverOptions options;
+        options.maxNodes = 500000;
+        options.cancel = &_cancel;
+        options.cache = atLevelStart ? cache : nullptr;
+        Solver solver(state);
+        if (!result.solved && !result.exhausted) {
+            result = solver.solve(options);
+        }
+        if (!result.solved && !result.exhausted && !_cancel) {
+            options.bidirectional = true;
+            options.maxNodes = 2000000;
+            result = solver.solve(options);
+        }
+        if (_cancel) {
+            return false;
+        }
+        if (!result.solved) {
+            hint.deadlocked = result.exhausted;
+            return true;
+        }
+        rememberSolution(state, result.solution);
+        planned = _plan.find(key);
+        if (planned == _plan.end()) {
+            return true;
+        }
+    }
+
+    hint.available = true;
+    hint.box = _board->toPosition(planned->second.box);
+    hint.direction = Board::toFacing(planned->second.direction);
+    hint.pushesLeft = planned->second.pushesLeft;
+    return true;
+}
+
+void HintEngine::prepareLevel(const GameMap& state) {
+    // Remembered pushes stay valid for as long as the walls and targets do.
+    std::vector<ETileType> tiles;
+    tiles.reserve(state.getWidth() * state.getHeight());
+    for (int row = 0; row < state.getHeight(); ++row) {
+        for (int col = 0; col < state.getWidth(); ++col) {
+            tiles.push_back(state.getTileAt(row, col));
+        }
+    }
+    if (_board && tiles == _levelTiles && _board->getWidth() == state.getWidth()) {
+        return;
+    }
+    _levelTiles.swap(tiles);
+    _plan.clear();
+    _board.reset(new Board(state));
+    _context.reset(new SearchContext(*_board, static_cast<int>(state.getBoxPositions().size())));
+}
+
+std::string HintEngine::stateKey(const std::vector<int>& boxes, int player) {
+    std::vector<uint16_t> sorted(boxes.begin(), boxes.end());
+    std::sort(sorted.begin(), sorted.end());
+    _context->setOccupied(sorted.data(), 1);
+    uint16_t normalized = static_cast<uint16_t>(_context->computeReach(player));
+    _context->setOccupied(sorted.data(), 0);
+
+    std::string key(reinterpret_cast<const char*>(&normalized), sizeof(normalized));
+    key.append(reinterpret_cast<const char*>(sorted.data()), sorted.size() * sizeof(uint16_t));
+    return key;
+}
+
+void HintEngine::rememberSolution(const GameMap& state, const std::string& solution) {
+    std::vector<int> boxes;
+    for (const auto& pos : state.getBoxPositions()) {
+        boxes.push_back(_board->toCell(pos));
+    }
+    int player = _board->toCell(state.getPlayerStart());
+    int pushesLeft = Lurd::countPushes(solution);
+
+    for (char step : solution) {
+        EFacing facing;
+        if (!Lurd::toFacing(step, facing)) {
+            return;
+        }
+        int direction = Board::toDirection(facing);
+        int next = _board->neighbor(player, direction);
+        auto box = std::find(boxes.begin(), boxes.end(), next);
+        if (box != boxes.end()) {
+            _plan[stateKey(boxes, player)] = {next, direction, pushesLeft--};
+            *box = _board->neighbor(next, direction);
+        }
+        player = next;
+    }
+}
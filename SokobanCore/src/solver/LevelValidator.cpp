@@ -0,0 +1,96 @@
+#include "solver/LevelValidator.h"
+#include "solver/Board.h"
+#include <algorithm>
+
+namespace {
+    bool isInside(const GameMap& map, const Position& pos) {
+        return pos.getRow() >= 0 && pos.getRow() < map.getHeight() &&
+               pos.getCol() >= 0 && pos.getCol() < map.getWidth();
+    }
+
+    std::string describe(const Position& pos) {
+        return "(" + std::to_string(pos.getRow()) + ", " + std::to_string(pos.getCol()) + ")";
+    }
+}
+
+ValidationReport LevelValidator::validate(const GameMap& map, SolutionCache* cache) {
+    ValidationReport report;
+    uint64_t hash = cache != nullptr ? SolutionCache::contentHash(map) : 0;
+    CacheEntry cached;
+    if (cache != nullptr && cache->lookup(hash, cached) && cached.has(CacheEntry::Validated)) {
+        return report;
+    }
+
+    int targetCount = 0;
+    for (int row = 0; row < map.getHeight(); ++row) {
+        for (int col = 0; col < map.getWidth(); ++col) {
+            ETileType tile = map.getTileAt(row, col);
+            if (tile != ETileType::PATH && tile != ETileType::TARGET && tile != ETileType::WALL) {
+                report.errors.push_back("Unknown tile type at " + describe(Position(row, col)));
+            } else if (tile == ETileType::TARGET) {
+                ++targetCount;
+            }
+        }
+    }
+
+    Position player = map.getPlayerStart();
+    if (!isInside(map, player)) {
+        report.errors.push_back("Player start " + describe(player) + " is out of bounds");
+    } else if (map.getTileAt(player.getRow(), player.getCol()) == ETileType::WALL) {
+        report.errors.push_back("Player start " + describe(player) + " is on a wall");
+    }
+
+    std::vector<Position> boxes = map.getBoxPositions();
+    if (boxes.empty()) {
+        report.errors.push_back("Level has no boxes");
+    }
+    if (static_cast<int>(boxes.size()) != targetCount) {
+        report.errors.push_back("Level has " + std::to_string(boxes.size()) + " boxes but " +
+                                std::to_string(targetCount) + " targets");
+    }
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const Position& box = boxes[i];
+        if (!isInside(map, box)) {
+            report.errors.push_back("Box " + describe(box) + " is out of bounds");
+            continue;
+        }
+        if (map.getTileAt(box.getRow(), box.getCol()) == ETileType::WALL) {
+            report.errors.push_back("Box " + describe(box) + " is on a wall");
+        }
+        if (box == player) {
+            report.errors.push_back("Box " + describe(box) + " overlaps the player start");
+        }
+        if (std::find(boxes.begin() + i + 1, boxes.end(), box) != boxes.end()) {
+            report.errors.push_back("Box " + describe(box) + " is listed more than once");
+        }
+    }
+
+    if (!report.isValid()) {
+        return report;
+    }
+
+    Board board(map);
+    if (static_cast<int>(board.getTargets().size()) != targetCount) {
+        report.errors.push_back("Level has targets outside the player's reachable area");
+    }
+    for (const auto& box : boxes) {
+        int cell = board.toCell(box);
+        if (!board.isFloor(cell)) {
+            report.errors.push_back("Box " + describe(box) + " is outside the player's reachable area");
+        } else if (board.isDead(cell)) {
+            report.errors.push_back("Box " + describe(box) + " starts on a dead square");
+        }
+    }
+
+    if (cache != nullptr && report.isValid()) {
+        CacheEntry entry;
+        entry.flags = CacheEntry::Validated;
+        entry.deadSquares.resize(board.getCellCount());
+        for (int cell = 0; cell < board.getCellCount(); ++cell) {
+            entry.deadSquares[cell] = board.isDead(cell) ? 1 : 0;
+        }
+        cache->store(hash, entry);
+    }
+    return report;
+}
@@ -0,0 +1,85 @@
+#include "solver/Lurd.h"
+#include "Game.h"
+#include "interfaces/IGameObserver.h"
+
+namespace {
+    class PushCounter : public IGameObserver {
+    public:
+        void onNotify(EGameEvent event) override {
+            if (event == EGameEvent::BOX_MOVED) {
+                ++pushes;
+            }
+        }
+
+        int pushes = 0;
+    };
+}
+
+char Lurd::toChar(EFacing direction, bool push) {
+    char step = 'l';
+    switch (direction) {
+        case EFacing::LEFT:
+            step = 'l';
+            break;
+        case EFacing::UP:
+            step = 'u';
+            break;
+        case EFacing::DOWN:
+            step = 'd';
+            break;
+        case EFacing::RIGHT:
+            step = 'r';
+            break;
+    }
+    return push ? static_cast<char>(step - 'a' + 'A') : step;
+}
+
+bool Lurd::toFacing(char step, EFacing& direction) {
+    switch (step) {
+        case 'l': case 'L':
+            direction = EFacing::LEFT;
+            return true;
+        case 'u': case 'U':
+            direction = EFacing::UP;
+            return true;
+        case 'd': case 'D':
+            direction = EFacing::DOWN;
+            return true;
+        case 'r': case 'R':
+            direction = EFacing::RIGHT;
+            return true;
+        default:
+            return false;
+    }
+}
+
+int Lurd::countPushes(const std::string& solution) {
+    int pushes = 0;
+    for (char step : solution) {
+        if (isPush(step)) {
+            ++pushes;
+        }
+    }
+    return pushes;
+}
+
+bool Lurd::verify(const GameMap& map, const std::string& solution) {
+    PushCounter counter;
+    Game game;
+    game.loadLevel(map);
+    game.addObserver(&counter);
+    for (char step : solution) {
+        EFacing direction;
+        if (!toFacing(step, direction) || game.getCurrentState() != EGameState::PLAYING) {
+            return false;
+        }
+        int movesBefore = game.getMoveCount();
+        int pushesBefore = counter.pushes;
+        game.movePlayer(direction);
+        // The case of each step has to match what it did to the boxes.
+        if (game.getMoveCount() == movesBefore || (counter.pushes != pushesBefore) != isPush(step)) {
+            return false;
+        }
+    }
+    return game.getCurrentState() == EGameState::LEVEL_COMPLETED;
+}
@@ -0,0 +1,427 @@
+#include "solver/PlayoutEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // Playouts a worker claims at a time; the shared counters are only
+    // touched once per batch.
+    const uint64_t BatchSize = 256;
+
+    // xorshift64*: a few instructions per draw and no shared state.
+    class Rng {
+    public:
+        explicit Rng(uint64_t seed) {
+            // SplitMix64 so that neighbouring thread seeds give unrelated streams.
+            uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            _state = (z ^ (z >> 31)) | 1;
+        }
+
+        uint64_t next() {
+            _state ^= _state >> 12;
+            _state ^= _state << 25;
+            _state ^= _state >> 27;
+            return _state * 0x2545F4914F6CDD1Dull;
+        }
+
+        uint32_t below(uint32_t bound) {
+            return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+        }
+
+    private:
+        uint64_t _state;
+    };
+
+    struct Tally {
+        uint64_t playouts = 0;
+        uint64_t solved = 0;
+        uint64_t stuck = 0;
+        uint64_t pushes = 0;
+        // Playouts by the most boxes they had on targets at once.
+        std::vector<uint64_t> bestCounts;
+    };
+
+    struct SharedTally {
+        explicit SharedTally(int boxCount)
+            : playouts(0), solved(0), stuck(0), pushes(0), bestCounts(new std::atomic<uint64_t>[boxCount + 1]) {
+            for (int i = 0; i <= boxCount; ++i) {
+                bestCounts[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void merge(Tally& local) {
+            playouts.fetch_add(local.playouts, std::memory_order_relaxed);
+            solved.fetch_add(local.solved, std::memory_order_relaxed);
+            stuck.fetch_add(local.stuck, std::memory_order_relaxed);
+            pushes.fetch_add(local.pushes, std::memory_order_relaxed);
+            for (size_t i = 0; i < local.bestCounts.size(); ++i) {
+                if (local.bestCounts[i]) {
+                    bestCounts[i].fetch_add(local.bestCounts[i], std::memory_order_relaxed);
+                    local.bestCounts[i] = 0;
+                }
+            }
+            local.playouts = local.solved = local.stuck = local.pushes = 0;
+        }
+
+        std::atomic<uint64_t> playouts;
+        std::atomic<uint64_t> solved;
+        std::atomic<uint64_t> stuck;
+        std::atomic<uint64_t> pushes;
+        std::unique_ptr<std::atomic<uint64_t>[]> bestCounts;
+    };
+}
+
+double PlayoutResult::reachedFraction(int boxes) const {
+    if (playouts == 0 || boxes < 0 || boxes >= static_cast<int>(reachedTargets.size())) {
+        return 0.0;
+    }
+    return static_cast<double>(reachedTargets[boxes]) / static_cast<double>(playouts);
+}
+
+double PlayoutResult::meanPushes() const {
+    return playouts == 0 ? 0.0 : static_cast<double>(totalPushes) / static_cast<double>(playouts);
+}
+
+double PlayoutResult::playoutsPerSecond() const {
+    return elapsedMs <= 0.0 ? 0.0 : static_cast<double>(playouts) * 1000.0 / elapsedMs;
+}
+
+class PlayoutEngine::Worker {
+public:
+    Worker(const PlayoutEngine& engine, const PlayoutOptions& options, int maxPushes, uint64_t seed)
+        : _engine(engine),
+          _board(engine._board),
+          _neighbors(engine._neighbors.data()),
+          _boxCount(engine._boxCount),
+          _occupied(engine._board.getCellCount(), 0),
+          _reach(engine._board.getCellCount(), 0),
+          _queue(engine._board.getCellCount(), 0),
+          _stamp(0),
+          _rng(seed),
+          _maxPushes(maxPushes),
+          _mcts(options.mcts),
+          _exploration(options.exploration),
+          _maxTreeNodes(std::max<size_t>(1, options.maxTreeNodes)),
+          _state(engine._start)
+    {
+        setOccupied(1);
+        if (_mcts) {
+            // Reserved up front so node references stay valid while the tree grows.
+            _tree.reserve(_maxTreeNodes);
+            _tree.push_back(TreeNode());
+            _path.reserve(static_cast<size_t>(_maxPushes) + 1);
+        }
+    }
+
+    void play(uint64_t count, Tally& tally) {
+        for (uint64_t i = 0; i < count; ++i) {
+            reset();
+            Outcome outcome = _mcts ? searchTree() : rollout(0, _state.onTarget);
+            ++tally.playouts;
+            tally.solved += outcome.solved ? 1 : 0;
+            tally.stuck += outcome.stuck ? 1 : 0;
+            tally.pushes += static_cast<uint64_t>(outcome.pushes);
+            ++tally.bestCounts[outcome.bestOnTarget];
+        }
+    }
+
+private:
+    struct Outcome {
+        int pushes;
+        int bestOnTarget;
+        bool solved;
+        bool stuck;
+    };
+
+    struct TreeNode {
+        uint32_t firstChild = 0;
+        uint16_t childCount = 0;
+        uint16_t move = 0;
+        bool expanded = false;
+        uint32_t visits = 0;
+        double value = 0.0;
+    };
+
+    int neighbor(int cell, int direction) const { return _neighbors[cell * Board::DirectionCount + direction]; }
+    bool isFree(int cell) const { return cell >= 0 && _board.isFloor(cell) && !_occupied[cell]; }
+    bool isBlocked(int cell) const { return _occupied[cell] || !_board.isFloor(cell); }
+
+    void setOccupied(uint8_t value) {
+        for (int i = 0; i < _boxCount; ++i) {
+            _occupied[_state.boxes[i]] = value;
+        }
+    }
+
+    void reset() {
+        setOccupied(0);
+        _state = _engine._start;
+        setOccupied(1);
+    }
+
+    // Same flood fill as SearchContext::computeReach, but cells are marked
+    // with a per-call stamp so the grid never has to be cleared.
+    void computeReach() {
+        if (++_stamp == 0) {
+            std::fill(_reach.begin(), _reach.end(), 0);
+            _stamp = 1;
+        }
+        size_t tail = 0;
+        _queue[tail++] = _state.player;
+        _reach[_state.player] = _stamp;
+        for (size_t head = 0; head < tail; ++head) {
+            int cell = _queue[head];
+            for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+                int next = neighbor(cell, dir);
+                if (next >= 0 && _reach[next] != _stamp && _board.isFloor(next) && !_occupied[next]) {
+                    _reach[next] = _stamp;
+                    _queue[tail++] = next;
+                }
+            }
+        }
+    }
+
+    // SearchContext::createsFrozenSquare over the neighbour table: the box
+    // just pushed to cell closes a 2x2 block of walls and boxes.
+    bool createsFrozenSquare(int cell) const {
+        static const int Horizontal[2] = {0, 3};
+        static const int Vertical[2] = {1, 2};
+        for (int h : Horizontal) {
+            int side = neighbor(cell, h);
+            if (side < 0 || !isBlocked(side)) {
+                continue;
+            }
+            for (int v : Vertical) {
+                int above = neighbor(cell, v);
+                int corner = neighbor(side, v);
+                if (above < 0 || corner < 0 || !isBlocked(above) || !isBlocked(corner)) {
+                    continue;
+                }
+                bool hasLooseBox = !_board.isTarget(cell) || (_occupied[side] && !_board.isTarget(side)) ||
+                                   (_occupied[above] && !_board.isTarget(above)) ||
+                                   (_occupied[corner] && !_board.isTarget(corner));
+                if (hasLooseBox) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    int legalMoves(uint16_t* moves) {
+        computeReach();
+        int count = 0;
+        for (int i = 0; i < _boxCount; ++i) {
+            int box = _state.boxes[i];
+            for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+                int from = neighbor(box, Board::opposite(dir));
+                if (from < 0 || _reach[from] != _stamp) {
+                    continue;
+                }
+                int to = neighbor(box, dir);
+                if (!isFree(to) || _board.isDead(to)) {
+                    continue;
+                }
+                _occupied[box] = 0;
+                _occupied[to] = 1;
+                bool frozen = createsFrozenSquare(to);
+                _occupied[to] = 0;
+                _occupied[box] = 1;
+                if (!frozen) {
+                    moves[count++] = static_cast<uint16_t>(i * Board::DirectionCount + dir);
+                }
+            }
+        }
+        return count;
+    }
+
+    void apply(uint16_t move) {
+        int index = move / Board::DirectionCount;
+        int box = _state.boxes[index];
+        int to = neighbor(box, move % Board::DirectionCount);
+        _occupied[box] = 0;
+        _occupied[to] = 1;
+        _state.boxes[index] = static_cast<uint16_t>(to);
+        _state.player = static_cast<uint16_t>(box);
+        _state.onTarget = static_cast<uint16_t>(_state.onTarget + _board.isTarget(to) - _board.isTarget(box));
+    }
+
+    Outcome rollout(int pushes, int best) {
+        while (_state.onTarget < _boxCount && pushes < _maxPushes) {
+            int count = legalMoves(_moves.data());
+            if (count == 0) {
+                return Outcome{pushes, best, false, true};
+            }
+            apply(_moves[_rng.below(static_cast<uint32_t>(count))]);
+            ++pushes;
+            best = std::max<int>(best, _state.onTarget);
+        }
+        return Outcome{pushes, best, _state.onTarget == _boxCount, false};
+    }
+
+    // One UCT iteration: descend by UCB1 until a node that has not been
+    // visited yet, expand it, finish with a random rollout and back up the
+    // share of boxes it got onto targets.
+    Outcome searchTree() {
+        int pushes = 0;
+        int best = _state.onTarget;
+        uint32_t node = 0;
+        _path.clear();
+        _path.push_back(node);
+
+        while (_state.onTarget < _boxCount && pushes < _maxPushes) {
+            TreeNode& current = _tree[node];
+            if (!current.expanded) {
+                int count = legalMoves(_moves.data());
+                if (_tree.size() + static_cast<size_t>(count) > _maxTreeNodes) {
+                    break;
+                }
+                current.expanded = true;
+                current.firstChild = static_cast<uint32_t>(_tree.size());
+                current.childCount = static_cast<uint16_t>(count);
+                for (int i = 0; i < count; ++i) {
+                    TreeNode child;
+                    child.move = _moves[i];
+                    _tree.push_back(child);
+                }
+            }
+            if (current.childCount == 0) {
+                break;
+            }
+
+            uint32_t chosen = selectChild(current);
+            apply(_tree[chosen].move);
+            ++pushes;
+            best = std::max<int>(best, _state.onTarget);
+            node = chosen;
+            _path.push_back(node);
+            if (_tree[node].visits == 0) {
+                break;
+            }
+        }
+
+        Outcome outcome = rollout(pushes, best);
+        double reward = static_cast<double>(outcome.bestOnTarget) / static_cast<double>(std::max(1, _boxCount));
+        for (uint32_t visited : _path) {
+            ++_tree[visited].visits;
+            _tree[visited].value += reward;
+        }
+        return outcome;
+    }
+
+    uint32_t selectChild(const TreeNode& parent) {
+        const double logVisits = std::log(static_cast<double>(std::max<uint32_t>(1, parent.visits)));
+        uint32_t chosen = parent.firstChild;
+        double bestScore = -1.0;
+        for (uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; ++i) {
+            const TreeNode& child = _tree[i];
+            if (child.visits == 0) {
+                return i;
+            }
+            double score = child.value / child.visits + _exploration * std::sqrt(logVisits / child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                chosen = i;
+            }
+        }
+        return chosen;
+    }
+
+    const PlayoutEngine& _engine;
+    const Board& _board;
+    const int16_t* _neighbors;
+    int _boxCount;
+    std::vector<uint8_t> _occupied;
+    std::vector<uint32_t> _reach;
+    std::vector<int> _queue;
+    uint32_t _stamp;
+    Rng _rng;
+    int _maxPushes;
+    bool _mcts;
+    double _exploration;
+    size_t _maxTreeNodes;
+    State _state;
+    std::array<uint16_t, MaxBoxes * Board::DirectionCount> _moves;
+    std::vector<TreeNode> _tree;
+    std::vector<uint32_t> _path;
+};
+
+PlayoutEngine::PlayoutEngine(const GameMap& map)
+    : _board(map),
+      _boxCount(static_cast<int>(map.getBoxPositions().size())),
+      _start()
+{
+    if (_boxCount > MaxBoxes) {
+        throw std::runtime_error("Level has too many boxes for playouts");
+    }
+    if (_board.getCellCount() > INT16_MAX) {
+        throw std::runtime_error("Level is too large for playouts");
+    }
+    _neighbors.resize(static_cast<size_t>(_board.getCellCount()) * Board::DirectionCount);
+    for (int cell = 0; cell < _board.getCellCount(); ++cell) {
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            _neighbors[cell * Board::DirectionCount + dir] = static_cast<int16_t>(_board.neighbor(cell, dir));
+        }
+    }
+    _start.player = static_cast<uint16_t>(_board.getPlayerStart());
+    const auto& boxes = _board.getInitialBoxes();
+    for (int i = 0; i < _boxCount; ++i) {
+        _start.boxes[i] = static_cast<uint16_t>(boxes[i]);
+        _start.onTarget = static_cast<uint16_t>(_start.onTarget + _board.isTarget(boxes[i]));
+    }
+}
+
+PlayoutResult PlayoutEngine::run(const PlayoutOptions& options) const {
+    auto startTime = std::chrono::steady_clock::now();
+    const int maxPushes = options.maxPushes > 0 ? options.maxPushes : std::max(32, 2 * _board.getFloorCount());
+
+    unsigned threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const uint64_t batches = (options.playouts + BatchSize - 1) / BatchSize;
+    threadCount = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(threadCount, batches)));
+
+    SharedTally shared(_boxCount);
+    std::atomic<uint64_t> nextPlayout(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            Worker worker(*this, options, maxPushes, options.seed + t);
+            Tally local;
+            local.bestCounts.assign(static_cast<size_t>(_boxCount) + 1, 0);
+            for (uint64_t first = nextPlayout.fetch_add(BatchSize); first < options.playouts;
+                 first = nextPlayout.fetch_add(BatchSize)) {
+                worker.play(std::min(BatchSize, options.playouts - first), local);
+                shared.merge(local);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    PlayoutResult result;
+    result.playouts = shared.playouts.load();
+    result.solved = shared.solved.load();
+    result.stuck = shared.stuck.load();
+    result.totalPushes = shared.pushes.load();
+    result.reachedTargets.assign(static_cast<size_t>(_boxCount) + 1, 0);
+    uint64_t atLeast = 0;
+    for (int k = _boxCount; k >= 0; --k) {
+        uint64_t count = shared.bestCounts[k].load();
+        atLeast += count;
+        result.reachedTargets[k] = atLeast;
+        if (count && result.bestOnTarget == 0) {
+            result.bestOnTarget = k;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    result.elapsedMs = elapsed.count();
+    return result;
+}
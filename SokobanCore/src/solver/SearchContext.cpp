@@ -0,0 +1,124 @@
+#include "solver/SearchContext.h"
+#include "solver/Lurd.h"
+#include <algorithm>
+#include <stdexcept>
+
+SearchContext::SearchContext(const Board& board, int boxCount)
+    : _board(board),
+      _boxCount(boxCount),
+      _occupied(board.getCellCount(), 0),
+      _reach(board.getCellCount(), 0),
+      _cameFrom(board.getCellCount(), -1)
+{
+    _queue.reserve(board.getCellCount());
+}
+
+void SearchContext::setOccupied(const uint16_t* boxes, uint8_t value) {
+    for (int i = 0; i < _boxCount; ++i) {
+        _occupied[boxes[i]] = value;
+    }
+}
+
+int SearchContext::computeReach(int start) {
+    std::fill(_reach.begin(), _reach.end(), 0);
+    _queue.clear();
+    _queue.push_back(start);
+    _reach[start] = 1;
+    int normalized = start;
+    for (size_t head = 0; head < _queue.size(); ++head) {
+        int cell = _queue[head];
+        normalized = std::min(normalized, cell);
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            int next = _board.neighbor(cell, dir);
+            if (next >= 0 && !_reach[next] && _board.isFloor(next) && !_occupied[next]) {
+                _reach[next] = 1;
+                _queue.push_back(next);
+            }
+        }
+    }
+    return normalized;
+}
+
+bool SearchContext::createsFrozenSquare(int cell) const {
+    // A 2x2 block made only of walls and boxes can never be broken up again,
+    // so it is a deadlock unless every box inside already sits on a target.
+    static const int Corners[4][2] = {{-1, -1}, {-1, 0}, {0, -1}, {0, 0}};
+    const int width = _board.getWidth();
+    const int height = _board.getHeight();
+    const int row = cell / width;
+    const int col = cell % width;
+
+    for (const auto& corner : Corners) {
+        int top = row + corner[0];
+        int left = col + corner[1];
+        if (top < 0 || left < 0 || top + 1 >= height || left + 1 >= width) {
+            continue;
+        }
+        bool blocked = true;
+        bool hasLooseBox = false;
+        for (int dr = 0; dr < 2 && blocked; ++dr) {
+            for (int dc = 0; dc < 2; ++dc) {
+                int square = (top + dr) * width + left + dc;
+                if (_occupied[square]) {
+                    hasLooseBox = hasLooseBox || !_board.isTarget(square);
+                } else if (_board.isFloor(square)) {
+                    blocked = false;
+                    break;
+                }
+            }
+        }
+        if (blocked && hasLooseBox) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SearchContext::walkPath(const uint16_t* boxes, int from, int to) {
+    if (from == to) {
+        return std::string();
+    }
+    setOccupied(boxes, 1);
+
+    std::fill(_cameFrom.begin(), _cameFrom.end(), -1);
+    _queue.clear();
+    _queue.push_back(from);
+    _cameFrom[from] = from;
+    for (size_t head = 0; head < _queue.size() && _cameFrom[to] < 0; ++head) {
+        int cell = _queue[head];
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            int next = _board.neighbor(cell, dir);
+            if (next >= 0 && _cameFrom[next] < 0 && _board.isFloor(next) && !_occupied[next]) {
+                _cameFrom[next] = cell;
+                _queue.push_back(next);
+            }
+        }
+    }
+
+    setOccupied(boxes, 0);
+    if (_cameFrom[to] < 0) {
+        throw std::logic_error("Search produced a push the player cannot reach");
+    }
+
+    std::string path;
+    for (int cell = to; cell != from; cell = _cameFrom[cell]) {
+        int previous = _cameFrom[cell];
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            if (_board.neighbor(previous, dir) == cell) {
+                path += Lurd::toChar(Board::toFacing(dir), false);
+                break;
+            }
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool SearchContext::isSolved(const uint16_t* boxes) const {
+    for (int i = 0; i < _boxCount; ++i) {
+        if (!_board.isTarget(boxes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,283 @@
+#include "solver/SolutionCache.h"
+#include "solver/Lurd.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char Magic[8] = {'S', 'K', 'B', 'C', 'A', 'C', 'H', 'E'};
+    const uint32_t Version = 2;
+    const size_t HeaderSize = sizeof(Magic) + 4;
+    // hash, flags, lower bound, node counts, cell count and solution length.
+    const size_t FixedPayloadSize = 8 + 1 + 4 + 8 + 8 + 4 + 4;
+
+    void putUint(std::string& out, uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) {
+            out += static_cast<char>((value >> (i * 8)) & 0xFF);
+        }
+    }
+
+    uint64_t getUint(const uint8_t* data, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value = value << 8 | data[i];
+        }
+        return value;
+    }
+
+    bool sameEntry(const CacheEntry& a, const CacheEntry& b) {
+        return a.flags == b.flags && a.lowerBound == b.lowerBound && a.solution == b.solution &&
+               a.deadSquares == b.deadSquares && a.nodesExpanded == b.nodesExpanded &&
+               a.nodesGenerated == b.nodesGenerated;
+    }
+
+    void createFile(const std::string& path) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to create solution cache " + path);
+        }
+        std::string header(Magic, sizeof(Magic));
+        putUint(header, Version, 4);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+}
+
+SolutionCache::SolutionCache(const std::string& path)
+    : _path(path),
+      _mapped(nullptr),
+      _mappedSize(0)
+{
+    std::error_code error;
+    if (!fs::exists(_path, error) || fs::file_size(_path, error) == 0) {
+        createFile(_path);
+    }
+
+    mapFile();
+    if (_mappedSize >= HeaderSize && std::memcmp(_mapped, Magic, sizeof(Magic)) == 0 &&
+        getUint(_mapped + sizeof(Magic), 4) < Version) {
+        // Only a cache: results in an older layout are recomputed.
+        unmapFile();
+        createFile(_path);
+        mapFile();
+    }
+    if (_mappedSize < HeaderSize || std::memcmp(_mapped, Magic, sizeof(Magic)) != 0 ||
+        getUint(_mapped + sizeof(Magic), 4) != Version) {
+        unmapFile();
+        throw std::runtime_error(_path + " is not a solution cache");
+    }
+
+    size_t validEnd = indexRecords();
+    if (validEnd < _mappedSize) {
+        // Drop the torn tail so new records are appended after a whole one.
+        unmapFile();
+        fs::resize_file(_path, validEnd);
+        mapFile();
+        indexRecords();
+    }
+}
+
+SolutionCache::~SolutionCache() {
+    unmapFile();
+}
+
+uint64_t SolutionCache::contentHash(const GameMap& map) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    mix(static_cast<uint64_t>(map.getWidth()));
+    mix(static_cast<uint64_t>(map.getHeight()));
+    for (int row = 0; row < map.getHeight(); ++row) {
+        for (int col = 0; col < map.getWidth(); ++col) {
+            mix(static_cast<uint64_t>(map.getTileAt(row, col)));
+        }
+    }
+    mix(static_cast<uint64_t>(map.getPlayerStart().getRow()));
+    mix(static_cast<uint64_t>(map.getPlayerStart().getCol()));
+
+    // Box order in the level file does not change the level.
+    std::vector<std::pair<int, int>> boxes;
+    for (const auto& box : map.getBoxPositions()) {
+        boxes.emplace_back(box.getRow(), box.getCol());
+    }
+    std::sort(boxes.begin(), boxes.end());
+    for (const auto& box : boxes) {
+        mix(static_cast<uint64_t>(box.first));
+        mix(static_cast<uint64_t>(box.second));
+    }
+    return hash;
+}
+
+bool SolutionCache::lookup(uint64_t hash, CacheEntry& entry) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto appended = _appended.find(hash);
+    if (appended != _appended.end()) {
+        entry = appended->second;
+        return true;
+    }
+    auto indexed = _index.find(hash);
+    return indexed != _index.end() && decode(indexed->second, entry);
+}
+
+void SolutionCache::store(uint64_t hash, const CacheEntry& entry) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    CacheEntry merged;
+    bool existing = false;
+    auto appended = _appended.find(hash);
+    if (appended != _appended.end()) {
+        merged = appended->second;
+        existing = true;
+    } else {
+        auto indexed = _index.find(hash);
+        existing = indexed != _index.end() && decode(indexed->second, merged);
+    }
+
+    CacheEntry previous = merged;
+    merged.flags |= entry.flags;
+    merged.lowerBound = std::max(merged.lowerBound, entry.lowerBound);
+    if (!entry.solution.empty() &&
+        (merged.solution.empty() || Lurd::countPushes(entry.solution) < Lurd::countPushes(merged.solution))) {
+        merged.solution = entry.solution;
+    }
+    if (!entry.deadSquares.empty()) {
+        merged.deadSquares = entry.deadSquares;
+    }
+    // Keep the effort of an optimal search over that of a faster one.
+    if (entry.nodesExpanded > 0 &&
+        (merged.nodesExpanded == 0 || (entry.has(CacheEntry::Optimal) && !previous.has(CacheEntry::Optimal)))) {
+        merged.nodesExpanded = entry.nodesExpanded;
+        merged.nodesGenerated = entry.nodesGenerated;
+    }
+    if (existing && sameEntry(previous, merged)) {
+        return;
+    }
+
+    _appended[hash] = merged;
+    std::string record = encode(hash, merged);
+    std::ofstream file(_path, std::ios::binary | std::ios::app);
+    file.write(record.data(), static_cast<std::streamsize>(record.size()));
+}
+
+size_t SolutionCache::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = _appended.size();
+    for (const auto& indexed : _index) {
+        count += _appended.count(indexed.first) == 0 ? 1 : 0;
+    }
+    return count;
+}
+
+void SolutionCache::mapFile() {
+    _mappedSize = static_cast<size_t>(fs::file_size(_path));
+#ifndef _WIN32
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open solution cache " + _path);
+    }
+    void* view = ::mmap(nullptr, _mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map solution cache " + _path);
+    }
+    _mapped = static_cast<const uint8_t*>(view);
+#else
+    std::ifstream file(_path, std::ios::binary);
+    _buffer.resize(_mappedSize);
+    file.read(reinterpret_cast<char*>(_buffer.data()), static_cast<std::streamsize>(_mappedSize));
+    _mapped = _buffer.data();
+#endif
+}
+
+void SolutionCache::unmapFile() {
+#ifndef _WIN32
+    if (_mapped != nullptr) {
+        ::munmap(const_cast<uint8_t*>(_mapped), _mappedSize);
+    }
+#else
+    _buffer.clear();
+#endif
+    _mapped = nullptr;
+    _mappedSize = 0;
+}
+
+size_t SolutionCache::indexRecords() {
+    _index.clear();
+    size_t offset = HeaderSize;
+    while (offset + 4 <= _mappedSize) {
+        size_t length = static_cast<size_t>(getUint(_mapped + offset, 4));
+        if (length < FixedPayloadSize || offset + 4 + length > _mappedSize) {
+            break;
+        }
+        CacheEntry entry;
+        if (!decode(offset, entry)) {
+            break;
+        }
+        _index[getUint(_mapped + offset + 4, 8)] = offset;
+        offset += 4 + length;
+    }
+    return offset;
+}
+
+bool SolutionCache::decode(size_t offset, CacheEntry& entry) const {
+    const uint8_t* record = _mapped + offset;
+    size_t length = static_cast<size_t>(getUint(record, 4));
+    const uint8_t* payload = record + 4;
+
+    entry.flags = payload[8];
+    entry.lowerBound = static_cast<int>(getUint(payload + 9, 4));
+    entry.nodesExpanded = getUint(payload + 13, 8);
+    entry.nodesGenerated = getUint(payload + 21, 8);
+    size_t cellCount = static_cast<size_t>(getUint(payload + 29, 4));
+    size_t bitmapSize = (cellCount + 7) / 8;
+    if (FixedPayloadSize + bitmapSize > length) {
+        return false;
+    }
+    const uint8_t* bitmap = payload + 33;
+    size_t solutionLength = static_cast<size_t>(getUint(bitmap + bitmapSize, 4));
+    if (FixedPayloadSize + bitmapSize + solutionLength != length) {
+        return false;
+    }
+
+    entry.deadSquares.assign(cellCount, 0);
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        entry.deadSquares[cell] = (bitmap[cell / 8] >> (cell % 8)) & 1;
+    }
+    const char* solution = reinterpret_cast<const char*>(bitmap + bitmapSize + 4);
+    entry.solution.assign(solution, solutionLength);
+    return true;
+}
+
+std::string SolutionCache::encode(uint64_t hash, const CacheEntry& entry) const {
+    // Dead squares are packed one bit per cell to keep records small.
+    std::string bitmap((entry.deadSquares.size() + 7) / 8, '\0');
+    for (size_t cell = 0; cell < entry.deadSquares.size(); ++cell) {
+        if (entry.deadSquares[cell]) {
+            bitmap[cell / 8] = static_cast<char>(bitmap[cell / 8] | (1 << (cell % 8)));
+        }
+    }
+
+    std::string payload;
+    putUint(payload, hash, 8);
+    payload += static_cast<char>(entry.flags);
+    putUint(payload, static_cast<uint32_t>(entry.lowerBound), 4);
+    putUint(payload, entry.nodesExpanded, 8);
+    putUint(payload, entry.nodesGenerated, 8);
+    putUint(payload, entry.deadSquares.size(), 4);
+    payload += bitmap;
+    putUint(payload, entry.solution.size(), 4);
+    payload += entry.solution;
+
+    std::string record;
+    putUint(record, payload.size(), 4);
+    return record + payload;
+}
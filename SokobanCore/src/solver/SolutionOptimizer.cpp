@@ -0,0 +1,274 @@
+#include "solver/SolutionOptimizer.h"
+#include "solver/Lurd.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+
+SolutionOptimizer::SolutionOptimizer(const GameMap& map)
+    : _map(map),
+      _board(map),
+      _context(_board, static_cast<int>(_board.getInitialBoxes().size())),
+      _boxCount(static_cast<int>(_board.getInitialBoxes().size()))
+{
+}
+
+OptimizationResult SolutionOptimizer::optimize(const std::string& solution, const OptimizerOptions& options) {
+    auto startTime = std::chrono::steady_clock::now();
+    OptimizationResult result;
+    result.solution = solution;
+    result.originalMoves = static_cast<int>(solution.size());
+    result.originalPushes = Lurd::countPushes(solution);
+    result.moves = result.originalMoves;
+    result.pushes = result.originalPushes;
+
+    std::vector<Push> pushes;
+    if (!Lurd::verify(_map, solution) || !parse(solution, pushes)) {
+        return result;
+    }
+    result.valid = true;
+
+    // Rebuilding the unchanged push list already shortens every walk.
+    std::string best = solution;
+    accept(std::vector<Push>(pushes), pushes, best);
+
+    for (int pass = 0; pass < options.maxPasses; ++pass) {
+        int cycles = removeCycles(pushes, best);
+        int windows = improveWindows(pushes, best, options);
+        result.cyclesRemoved += cycles;
+        result.windowsImproved += windows;
+        if (cycles == 0 && windows == 0) {
+            break;
+        }
+    }
+
+    result.solution = best;
+    result.moves = static_cast<int>(best.size());
+    result.pushes = Lurd::countPushes(best);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    result.optimizeTimeMs = elapsed.count();
+    return result;
+}
+
+bool SolutionOptimizer::parse(const std::string& solution, std::vector<Push>& pushes) const {
+    std::vector<uint8_t> boxAt(_board.getCellCount(), 0);
+    for (int box : _board.getInitialBoxes()) {
+        boxAt[box] = 1;
+    }
+    int player = _board.getPlayerStart();
+    for (char step : solution) {
+        EFacing facing;
+        if (!Lurd::toFacing(step, facing)) {
+            return false;
+        }
+        int direction = Board::toDirection(facing);
+        int next = _board.neighbor(player, direction);
+        if (next < 0) {
+            return false;
+        }
+        if (boxAt[next]) {
+            int destination = _board.neighbor(next, direction);
+            if (destination < 0) {
+                return false;
+            }
+            boxAt[next] = 0;
+            boxAt[destination] = 1;
+            pushes.push_back({next, direction});
+        }
+        player = next;
+    }
+    return true;
+}
+
+std::vector<SolutionOptimizer::State> SolutionOptimizer::replay(const std::vector<Push>& pushes) const {
+    std::vector<State> states;
+    states.reserve(pushes.size() + 1);
+
+    State state;
+    state.player = _board.getPlayerStart();
+    for (int box : _board.getInitialBoxes()) {
+        state.boxes.push_back(static_cast<uint16_t>(box));
+    }
+    std::sort(state.boxes.begin(), state.boxes.end());
+    states.push_back(state);
+
+    for (const Push& push : pushes) {
+        auto it = std::find(state.boxes.begin(), state.boxes.end(), push.box);
+        *it = static_cast<uint16_t>(_board.neighbor(push.box, push.direction));
+        std::sort(state.boxes.begin(), state.boxes.end());
+        state.player = push.box;
+        states.push_back(state);
+    }
+    return states;
+}
+
+std::string SolutionOptimizer::build(const std::vector<Push>& pushes) {
+    std::vector<State> states = replay(pushes);
+    std::string solution;
+    for (size_t i = 0; i < pushes.size(); ++i) {
+        const Push& push = pushes[i];
+        int pusher = _board.neighbor(push.box, Board::opposite(push.direction));
+        solution += _context.walkPath(states[i].boxes.data(), states[i].player, pusher);
+        solution += Lurd::toChar(Board::toFacing(push.direction), true);
+    }
+    return solution;
+}
+
+bool SolutionOptimizer::accept(const std::vector<Push>& candidate, std::vector<Push>& pushes, std::string& solution) {
+    std::string rebuilt;
+    try {
+        rebuilt = build(candidate);
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    bool better = candidate.size() < pushes.size() ||
+                  (candidate.size() == pushes.size() && rebuilt.size() < solution.size());
+    if (!better || !Lurd::verify(_map, rebuilt)) {
+        return false;
+    }
+    pushes = candidate;
+    solution = rebuilt;
+    return true;
+}
+
+std::string SolutionOptimizer::stateKey(const State& state) {
+    _context.setOccupied(state.boxes.data(), 1);
+    int normalized = _context.computeReach(state.player);
+    _context.setOccupied(state.boxes.data(), 0);
+
+    std::string key(sizeof(uint16_t) * (state.boxes.size() + 1), '\0');
+    uint16_t player = static_cast<uint16_t>(normalized);
+    std::copy_n(reinterpret_cast<const char*>(&player), sizeof(player), key.begin());
+    std::copy_n(reinterpret_cast<const char*>(state.boxes.data()), sizeof(uint16_t) * state.boxes.size(),
+                key.begin() + sizeof(player));
+    return key;
+}
+
+int SolutionOptimizer::removeCycles(std::vector<Push>& pushes, std::string& solution) {
+    // Any stretch of pushes that leads back to a position seen earlier (same
+    // boxes, same player area) achieved nothing and can be skipped entirely.
+    std::vector<State> states = replay(pushes);
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, size_t> lastSeen;
+    for (size_t i = 0; i < states.size(); ++i) {
+        keys.push_back(stateKey(states[i]));
+        lastSeen[keys.back()] = i;
+    }
+
+    std::vector<Push> candidate;
+    int cycles = 0;
+    for (size_t i = 0; i < pushes.size(); ++i) {
+        size_t skipTo = lastSeen[keys[i]];
+        if (skipTo > i) {
+            ++cycles;
+            i = skipTo;
+            if (i == pushes.size()) {
+                break;
+            }
+        }
+        candidate.push_back(pushes[i]);
+    }
+
+    if (cycles == 0 || !accept(candidate, pushes, solution)) {
+        return 0;
+    }
+    return cycles;
+}
+
+int SolutionOptimizer::improveWindows(std::vector<Push>& pushes, std::string& solution,
+                                      const OptimizerOptions& options) {
+    int improved = 0;
+    std::vector<State> states = replay(pushes);
+    for (size_t i = 0; i + 1 < pushes.size();) {
+        size_t end = std::min(pushes.size(), i + static_cast<size_t>(std::max(2, options.windowPushes)));
+        std::vector<Push> replacement;
+        if (searchWindow(states[i], states[end], static_cast<int>(end - i) - 1, options.windowNodes,
+                         end == pushes.size(), replacement)) {
+            std::vector<Push> candidate(pushes.begin(), pushes.begin() + static_cast<std::ptrdiff_t>(i));
+            candidate.insert(candidate.end(), replacement.begin(), replacement.end());
+            candidate.insert(candidate.end(), pushes.begin() + static_cast<std::ptrdiff_t>(end), pushes.end());
+            if (accept(candidate, pushes, solution)) {
+                ++improved;
+                states = replay(pushes);
+                continue;
+            }
+        }
+        ++i;
+    }
+    return improved;
+}
+
+bool SolutionOptimizer::searchWindow(const State& from, const State& to, int maxPushes, uint64_t maxNodes,
+                                     bool finalWindow, std::vector<Push>& replacement) {
+    // Breadth-first over pushes, so the first match uses the fewest pushes.
+    // The last window only has to reach the same box layout; the player may
+    // end anywhere once the level is won.
+    struct WindowNode {
+        State state;
+        int parent;
+        Push push;
+    };
+
+    const std::string goalKey = stateKey(to);
+    std::vector<WindowNode> nodes;
+    std::unordered_map<std::string, int> seen;
+    nodes.push_back({from, -1, {0, 0}});
+    seen.emplace(stateKey(from), 0);
+
+    size_t levelStart = 0;
+    for (int depth = 0; depth < maxPushes; ++depth) {
+        size_t levelEnd = nodes.size();
+        for (size_t index = levelStart; index < levelEnd; ++index) {
+            std::vector<WindowNode> children;
+            {
+                const State& state = nodes[index].state;
+                _context.setOccupied(state.boxes.data(), 1);
+                _context.computeReach(state.player);
+                for (int i = 0; i < _boxCount; ++i) {
+                    int box = state.boxes[i];
+                    for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+                        int pusher = _board.neighbor(box, Board::opposite(dir));
+                        int destination = _board.neighbor(box, dir);
+                        if (pusher < 0 || !_context.isReachable(pusher) || !_context.isFree(destination) ||
+                            _board.isDead(destination)) {
+                            continue;
+                        }
+                        WindowNode child{state, static_cast<int>(index), {box, dir}};
+                        child.state.boxes[i] = static_cast<uint16_t>(destination);
+                        std::sort(child.state.boxes.begin(), child.state.boxes.end());
+                        child.state.player = box;
+                        children.push_back(std::move(child));
+                    }
+                }
+                _context.setOccupied(state.boxes.data(), 0);
+            }
+
+            for (WindowNode& child : children) {
+                std::string key = stateKey(child.state);
+                bool reached = finalWindow ? child.state.boxes == to.boxes : key == goalKey;
+                if (!seen.emplace(std::move(key), static_cast<int>(nodes.size())).second && !reached) {
+                    continue;
+                }
+                nodes.push_back(std::move(child));
+                if (reached) {
+                    replacement.clear();
+                    for (int node = static_cast<int>(nodes.size()) - 1; nodes[node].parent >= 0;
+                         node = nodes[node].parent) {
+                        replacement.push_back(nodes[node].push);
+                    }
+                    std::reverse(replacement.begin(), replacement.end());
+                    return true;
+                }
+                if (nodes.size() >= maxNodes) {
+                    return false;
+                }
+            }
+        }
+        levelStart = levelEnd;
+        if (levelStart == nodes.size()) {
+            break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,286 @@
+#include "solver/Solver.h"
+#include "solver/Lurd.h"
+#include "solver/SolutionCache.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_set>
+
+Solver::Solver(const GameMap& map)
+    : _board(map),
+      _boxCount(static_cast<int>(_board.getInitialBoxes().size())),
+      _levelHash(SolutionCache::contentHash(map))
+{
+    if (_board.getCellCount() > UINT16_MAX) {
+        throw std::runtime_error("Level is too large for the solver");
+    }
+}
+
+SolverResult Solver::solve(const SolverOptions& requested) {
+    auto startTime = std::chrono::steady_clock::now();
+    SolverOptions options = requested;
+    // The backward search starts with a box on every target, so it only
+    // describes the goal when there are exactly as many targets as boxes.
+    if (options.bidirectional && static_cast<int>(_board.getTargets().size()) != _boxCount) {
+        options.bidirectional = false;
+    }
+
+    SolverResult result;
+    if (loadCached(options, result)) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+        result.solveTimeMs = elapsed.count();
+        return result;
+    }
+
+    if (!options.spillDirectory.empty()) {
+        result = solveExternal(options);
+    } else if (options.bidirectional) {
+        result = solveBidirectional(options);
+    } else {
+        result = solveForward(options);
+    }
+
+    if (result.nodesExpanded > 0) {
+        result.branchingFactor = static_cast<double>(result.nodesGenerated) / result.nodesExpanded;
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    result.solveTimeMs = elapsed.count();
+    storeCached(options, result);
+    return result;
+}
+
+bool Solver::loadCached(const SolverOptions& options, SolverResult& result) const {
+    CacheEntry entry;
+    if (options.cache == nullptr || !options.cache->lookup(_levelHash, entry)) {
+        return false;
+    }
+    // Optimal modes may only reuse a solution another optimal run produced.
+    bool optimalRequired = !options.bidirectional || !options.spillDirectory.empty();
+    if (entry.has(CacheEntry::Solved) && (entry.has(CacheEntry::Optimal) || !optimalRequired)) {
+        result.solved = true;
+        result.solution = entry.solution;
+        result.pushes = Lurd::countPushes(entry.solution);
+        result.moves = static_cast<int>(entry.solution.size());
+    } else if (entry.has(CacheEntry::Unsolvable)) {
+        result.exhausted = true;
+    } else {
+        return false;
+    }
+    result.nodesExpanded = entry.nodesExpanded;
+    result.nodesGenerated = entry.nodesGenerated;
+    if (result.nodesExpanded > 0) {
+        result.branchingFactor = static_cast<double>(result.nodesGenerated) / result.nodesExpanded;
+    }
+    result.fromCache = true;
+    return true;
+}
+
+void Solver::storeCached(const SolverOptions& options, const SolverResult& result) const {
+    if (options.cache == nullptr || (!result.solved && !result.exhausted)) {
+        return;
+    }
+    bool optimal = !options.bidirectional || !options.spillDirectory.empty();
+
+    CacheEntry entry;
+    entry.nodesExpanded = result.nodesExpanded;
+    entry.nodesGenerated = result.nodesGenerated;
+    entry.deadSquares.resize(_board.getCellCount());
+    for (int cell = 0; cell < _board.getCellCount(); ++cell) {
+        entry.deadSquares[cell] = _board.isDead(cell) ? 1 : 0;
+    }
+    if (result.solved) {
+        entry.flags = CacheEntry::Solved | (optimal ? CacheEntry::Optimal : 0);
+        entry.solution = result.solution;
+        entry.lowerBound = optimal ? result.pushes : 0;
+    } else {
+        entry.flags = CacheEntry::Unsolvable;
+    }
+    if (!optimal) {
+        std::vector<uint16_t> boxes(_board.getInitialBoxes().begin(), _board.getInitialBoxes().end());
+        entry.lowerBound = std::max(0, heuristic(boxes.data()));
+    }
+    options.cache->store(_levelHash, entry);
+}
+
+SolverResult Solver::solveForward(const SolverOptions& options) {
+    auto startTime = std::chrono::steady_clock::now();
+    SolverResult result;
+    SearchContext context(_board, _boxCount);
+
+    // Declared first so it outlives every container that allocates from it.
+    BumpArena arena;
+    NodePool pool(arena, SearchNode::slotSize(_boxCount));
+    std::unordered_set<SearchNode*, SearchNodeHash, SearchNodeEqual, ArenaAllocator<SearchNode*>> closed(
+        1024, SearchNodeHash{_boxCount}, SearchNodeEqual{_boxCount}, ArenaAllocator<SearchNode*>(arena));
+    std::vector<OpenEntry, ArenaAllocator<OpenEntry>> openStorage{ArenaAllocator<OpenEntry>(arena)};
+    openStorage.reserve(1024);
+    OpenList open(std::greater<OpenEntry>(), std::move(openStorage));
+    std::vector<SearchNode*> children;
+
+    SearchNode* root = createRoot(pool, _board.getInitialBoxes(), _board.getPlayerStart());
+    int rootH = heuristic(root->boxes());
+    if (rootH >= 0) {
+        open.push({rootH, rootH, root});
+    }
+
+    SearchNode* goal = nullptr;
+    while (!open.empty()) {
+        if (result.nodesExpanded >= options.maxNodes || options.isCancelled()) {
+            break;
+        }
+        if (options.timeLimitMs > 0.0 && (result.nodesExpanded & 1023) == 0) {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+            if (elapsed.count() > options.timeLimitMs) {
+                break;
+            }
+        }
+
+        SearchNode* current = open.top().node;
+        open.pop();
+        const uint16_t* boxes = current->boxes();
+
+        context.setOccupied(boxes, 1);
+        current->normalizedPlayer = static_cast<uint16_t>(context.computeReach(current->player));
+
+        if (!closed.insert(current).second) {
+            // Never expanded, so nothing points at it and the slot can be reused.
+            context.setOccupied(boxes, 0);
+            pool.free(current);
+            continue;
+        }
+
+        if (context.isSolved(boxes)) {
+            context.setOccupied(boxes, 0);
+            goal = current;
+            break;
+        }
+
+        ++result.nodesExpanded;
+        generatePushes(context, pool, current, options.useTunnelMacros, children);
+        context.setOccupied(boxes, 0);
+
+        for (SearchNode* child : children) {
+            int h = heuristic(child->boxes());
+            open.push({static_cast<int>(child->pushes) + h, h, child});
+            result.macroPushes += child->pushLength - 1;
+        }
+        result.nodesGenerated += children.size();
+    }
+
+    if (goal != nullptr) {
+        result.solved = true;
+        result.solution = reconstruct(context, goal);
+        result.pushes = static_cast<int>(goal->pushes);
+        result.moves = static_cast<int>(result.solution.size());
+    } else {
+        result.exhausted = open.empty();
+    }
+
+    result.peakMemoryBytes = arena.getPeakBytesReserved();
+    result.arenaAllocations = arena.getAllocationCount();
+    result.systemAllocations = arena.getSystemAllocationCount();
+    return result;
+}
+
+SearchNode* Solver::createRoot(NodePool& pool, const std::vector<int>& boxes, int player) const {
+    SearchNode* root = static_cast<SearchNode*>(pool.allocate());
+    std::copy(boxes.begin(), boxes.end(), root->boxes());
+    std::sort(root->boxes(), root->boxes() + _boxCount);
+    root->parent = nullptr;
+    root->pushes = 0;
+    root->player = static_cast<uint16_t>(player);
+    root->normalizedPlayer = root->player;
+    root->pushedFrom = 0;
+    root->pushLength = 0;
+    root->direction = 0;
+    return root;
+}
+
+void Solver::generatePushes(SearchContext& context, NodePool& pool, SearchNode* current, bool useMacros,
+                            std::vector<SearchNode*>& children) const {
+    children.clear();
+    const uint16_t* boxes = current->boxes();
+    for (int i = 0; i < _boxCount; ++i) {
+        int box = boxes[i];
+        for (int dir = 0; dir < Board::DirectionCount; ++dir) {
+            int pusher = _board.neighbor(box, Board::opposite(dir));
+            int destination = _board.neighbor(box, dir);
+            if (pusher < 0 || !context.isReachable(pusher) || !context.isFree(destination) ||
+                _board.isDead(destination)) {
+                continue;
+            }
+            int length = 1;
+            if (useMacros) {
+                destination = followTunnel(context, destination, dir, length);
+            }
+
+            context.setOccupied(box, 0);
+            context.setOccupied(destination, 1);
+            bool frozen = context.createsFrozenSquare(destination);
+            context.setOccupied(destination, 0);
+            context.setOccupied(box, 1);
+            if (frozen) {
+                continue;
+            }
+
+            SearchNode* child = static_cast<SearchNode*>(pool.allocate());
+            uint16_t* childBoxes = child->boxes();
+            std::copy(boxes, boxes + _boxCount, childBoxes);
+            childBoxes[i] = static_cast<uint16_t>(destination);
+            std::sort(childBoxes, childBoxes + _boxCount);
+            child->parent = current;
+            child->pushes = current->pushes + length;
+            child->player = static_cast<uint16_t>(_board.neighbor(destination, Board::opposite(dir)));
+            child->normalizedPlayer = child->player;
+            child->pushedFrom = static_cast<uint16_t>(box);
+            child->pushLength = static_cast<uint16_t>(length);
+            child->direction = static_cast<uint8_t>(dir);
+            children.push_back(child);
+        }
+    }
+}
+
+int Solver::followTunnel(const SearchContext& context, int cell, int direction, int& length) const {
+    // A box inside a one-way tunnel (corridor cell that is also an articulation
+    // point) cannot be reached from the front, so the only useful move is to
+    // keep pushing it until it leaves the tunnel or lands on a target.
+    while (_board.isTunnel(cell, direction) && _board.isArticulation(cell) && !_board.isTarget(cell)) {
+        int next = _board.neighbor(cell, direction);
+        if (!context.isFree(next) || _board.isDead(next)) {
+            break;
+        }
+        cell = next;
+        ++length;
+    }
+    return cell;
+}
+
+int Solver::heuristic(const uint16_t* boxes) const {
+    int total = 0;
+    for (int i = 0; i < _boxCount; ++i) {
+        int distance = _board.goalDistance(boxes[i]);
+        if (distance == Board::Unreachable) {
+            return -1;
+        }
+        total += distance;
+    }
+    return total;
+}
+
+std::string Solver::reconstruct(SearchContext& context, const SearchNode* goal) const {
+    std::vector<const SearchNode*> chain;
+    for (const SearchNode* node = goal; node != nullptr; node = node->parent) {
+        chain.push_back(node);
+    }
+    std::reverse(chain.begin(), chain.end());
+
+    std::string solution;
+    for (size_t i = 1; i < chain.size(); ++i) {
+        const SearchNode* parent = chain[i - 1];
+        const SearchNode* child = chain[i];
+        int pusher = _board.neighbor(child->pushedFrom, Board::opposite(child->direction));
+        solution += context.walkPath(parent->boxes(), parent->player, pusher);
+        solution.append(child->pushLength, Lurd::toChar(Board::toFacing(child->direction), true));
+    }
+    return solution;
+}
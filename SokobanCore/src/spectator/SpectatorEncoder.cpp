@@ -0,0 +1,107 @@
+#include "spectator/SpectatorEncoder.h"
+
+namespace {
+    void putU16(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void putU32(std::vector<uint8_t>& out, uint32_t value) {
+        putU16(out, value & 0xFFFF);
+        putU16(out, value >> 16);
+    }
+
+    bool toFacing(int rowStep, int colStep, EFacing& direction) {
+        if (rowStep == 0 && colStep == -1) direction = EFacing::LEFT;
+        else if (rowStep == -1 && colStep == 0) direction = EFacing::UP;
+        else if (rowStep == 1 && colStep == 0) direction = EFacing::DOWN;
+        else if (rowStep == 0 && colStep == 1) direction = EFacing::RIGHT;
+        else return false;
+        return true;
+    }
+}
+
+SpectatorEncoder::SpectatorEncoder(IGame* game)
+    : _game(game),
+      _lastPlayer(0, 0),
+      _pushed(false),
+      _keyframeSize(0),
+      _movesSinceKeyframe(0)
+{
+}
+
+bool SpectatorEncoder::encode(EGameEvent event, std::vector<uint8_t>& out) {
+    switch (event) {
+        case EGameEvent::LEVEL_RELOADED:
+        case EGameEvent::HISTORY_SEEKED:
+            encodeKeyframe(out);
+            return true;
+        case EGameEvent::BOX_MOVED:
+            _pushed = true;
+            return false;
+        case EGameEvent::PLAYER_MOVED:
+            return encodeMove(out);
+        case EGameEvent::LEVEL_WON:
+        case EGameEvent::LEVEL_SOURCE_CHANGED:
+            // Viewers see the win in the boxes; an edit arrives as a reload.
+            return false;
+    }
+    return false;
+}
+
+void SpectatorEncoder::encodeKeyframe(std::vector<uint8_t>& out) {
+    int width = _game->getLevelWidth();
+    int height = _game->getLevelLength();
+    const std::vector<Position>& boxes = _game->getBoxPositions();
+    _lastPlayer = _game->getPlayerPosition();
+    _pushed = false;
+    _movesSinceKeyframe = 0;
+
+    size_t start = out.size();
+    out.push_back(SpectatorFormat::KeyframeTag);
+    putU32(out, 0);
+    putU32(out, static_cast<uint32_t>(_game->getLevelId()));
+    putU32(out, static_cast<uint32_t>(_game->getMoveCount()));
+    putU16(out, static_cast<uint32_t>(width));
+    putU16(out, static_cast<uint32_t>(height));
+    putU16(out, static_cast<uint32_t>(_lastPlayer.getRow()));
+    putU16(out, static_cast<uint32_t>(_lastPlayer.getCol()));
+    putU32(out, static_cast<uint32_t>(boxes.size()));
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; ++col) {
+            out.push_back(static_cast<uint8_t>(_game->getTileAt(Position(row, col))));
+        }
+    }
+    for (const Position& box : boxes) {
+        putU16(out, static_cast<uint32_t>(box.getRow()));
+        putU16(out, static_cast<uint32_t>(box.getCol()));
+    }
+    _keyframeSize = out.size() - start;
+    uint32_t length = static_cast<uint32_t>(_keyframeSize - SpectatorFormat::KeyframeHeaderSize);
+    for (int i = 0; i < 4; ++i) {
+        out[start + 1 + i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+}
+
+bool SpectatorEncoder::encodeMove(std::vector<uint8_t>& out) {
+    Position player = _game->getPlayerPosition();
+    EFacing direction;
+    bool valid = toFacing(player.getRow() - _lastPlayer.getRow(), player.getCol() - _lastPlayer.getCol(), direction);
+    bool pushed = _pushed;
+    _lastPlayer = player;
+    _pushed = false;
+    if (!valid) {
+        // Not a single step, so not a move viewers could replay.
+        encodeKeyframe(out);
+        return true;
+    }
+
+    out.push_back(static_cast<uint8_t>(SpectatorFormat::DeltaFlag | (pushed ? SpectatorFormat::PushedFlag : 0) |
+                                       static_cast<uint8_t>(direction)));
+    // Rebuilding the keyframe costs about as much as the moves it replaces.
+    if (++_movesSinceKeyframe >= _keyframeSize) {
+        encodeKeyframe(out);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,248 @@
+#include "spectator/SpectatorGame.h"
+#include "spectator/SpectatorEncoder.h"
+#include <algorithm>
+#include <stdexcept>
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    uint32_t getU16(const uint8_t* in) {
+        return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8;
+    }
+
+    uint32_t getU32(const uint8_t* in) {
+        return getU16(in) | getU16(in + 2) << 16;
+    }
+
+    Position step(const Position& from, EFacing direction) {
+        switch (direction) {
+            case EFacing::LEFT: return Position(from.getRow(), from.getCol() - 1);
+            case EFacing::UP: return Position(from.getRow() - 1, from.getCol());
+            case EFacing::DOWN: return Position(from.getRow() + 1, from.getCol());
+            case EFacing::RIGHT: return Position(from.getRow(), from.getCol() + 1);
+        }
+        return from;
+    }
+}
+
+SpectatorGame::SpectatorGame()
+    : _socket(-1),
+      _loaded(false),
+      _levelId(0),
+      _moveCount(0),
+      _width(0),
+      _height(0),
+      _player(0, 0),
+      _boxesOnTarget(0) {}
+
+SpectatorGame::~SpectatorGame() {
+#ifndef _WIN32
+    if (_socket >= 0) {
+        ::close(_socket);
+    }
+#endif
+}
+
+void SpectatorGame::connect(const std::string& socketPath) {
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid spectator socket path " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket < 0) {
+        throw std::runtime_error("Failed to create spectator socket");
+    }
+    if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(socket);
+        throw std::runtime_error("Failed to connect to " + socketPath + ": " + std::strerror(errno));
+    }
+    ::fcntl(socket, F_SETFL, ::fcntl(socket, F_GETFL) | O_NONBLOCK);
+
+    if (_socket >= 0) {
+        ::close(_socket);
+    }
+    _socket = socket;
+    _partial.clear();
+#else
+    (void)socketPath;
+    throw std::runtime_error("Spectating needs Unix domain sockets");
+#endif
+}
+
+bool SpectatorGame::receive() {
+#ifndef _WIN32
+    if (_socket < 0) {
+        return false;
+    }
+    uint8_t buffer[16384];
+    while (true) {
+        ssize_t count = ::recv(_socket, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            feed(buffer, static_cast<size_t>(count));
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else {
+            return false;
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+void SpectatorGame::feed(const uint8_t* data, size_t size) {
+    // Moves are applied straight from the input; only a keyframe split
+    // across reads is collected in _partial first.
+    size_t offset = 0;
+    while (offset < size) {
+        if (_partial.empty() && (data[offset] & SpectatorFormat::DeltaFlag)) {
+            applyMove(data[offset]);
+            ++offset;
+            continue;
+        }
+        if (_partial.empty() && data[offset] != SpectatorFormat::KeyframeTag) {
+            throw std::runtime_error("Corrupt spectator stream");
+        }
+
+        size_t needed = SpectatorFormat::KeyframeHeaderSize;
+        if (_partial.size() >= SpectatorFormat::KeyframeHeaderSize) {
+            uint32_t length = getU32(&_partial[1]);
+            if (length < SpectatorFormat::KeyframeFixedSize || length > SpectatorFormat::MaxKeyframeSize) {
+                throw std::runtime_error("Corrupt spectator keyframe");
+            }
+            needed += length;
+        }
+        size_t take = std::min(needed - _partial.size(), size - offset);
+        _partial.insert(_partial.end(), data + offset, data + offset + take);
+        offset += take;
+
+        if (_partial.size() > SpectatorFormat::KeyframeHeaderSize && _partial.size() == needed) {
+            applyKeyframe(_partial.data() + SpectatorFormat::KeyframeHeaderSize, needed - SpectatorFormat::KeyframeHeaderSize);
+            _partial.clear();
+        }
+    }
+}
+
+void SpectatorGame::applyKeyframe(const uint8_t* data, size_t size) {
+    int width = static_cast<int>(getU16(data + 8));
+    int height = static_cast<int>(getU16(data + 10));
+    uint32_t boxCount = getU32(data + 16);
+    size_t tiles = static_cast<size_t>(width) * height;
+    if (size != SpectatorFormat::KeyframeFixedSize + tiles + 4 * static_cast<size_t>(boxCount)) {
+        throw std::runtime_error("Corrupt spectator keyframe");
+    }
+
+    _levelId = static_cast<int>(getU32(data));
+    _moveCount = static_cast<int>(getU32(data + 4));
+    _width = width;
+    _height = height;
+    _player = Position(static_cast<int>(getU16(data + 12)), static_cast<int>(getU16(data + 14)));
+    const uint8_t* cursor = data + SpectatorFormat::KeyframeFixedSize;
+    _tiles.assign(cursor, cursor + tiles);
+    cursor += tiles;
+
+    _boxes.clear();
+    _boxAt.assign(tiles, -1);
+    _boxesOnTarget = 0;
+    for (uint32_t i = 0; i < boxCount; ++i, cursor += 4) {
+        Position box(static_cast<int>(getU16(cursor)), static_cast<int>(getU16(cursor + 2)));
+        if (!isInside(box.getRow(), box.getCol())) {
+            throw std::runtime_error("Corrupt spectator keyframe");
+        }
+        int index = box.getRow() * _width + box.getCol();
+        _boxAt[index] = static_cast<int>(_boxes.size());
+        _boxes.push_back(box);
+        if (_tiles[index] == static_cast<uint8_t>(ETileType::TARGET)) {
+            ++_boxesOnTarget;
+        }
+    }
+
+    _loaded = true;
+    notify(EGameEvent::LEVEL_RELOADED);
+}
+
+void SpectatorGame::applyMove(uint8_t packet) {
+    if (!_loaded) {
+        return;
+    }
+    EFacing direction = static_cast<EFacing>(packet & SpectatorFormat::DirectionMask);
+    Position next = step(_player, direction);
+    if (!isInside(next.getRow(), next.getCol())) {
+        throw std::runtime_error("Corrupt spectator move");
+    }
+
+    if (packet & SpectatorFormat::PushedFlag) {
+        int from = next.getRow() * _width + next.getCol();
+        Position boxNext = step(next, direction);
+        if (_boxAt[from] < 0 || !isInside(boxNext.getRow(), boxNext.getCol())) {
+            throw std::runtime_error("Corrupt spectator move");
+        }
+        int to = boxNext.getRow() * _width + boxNext.getCol();
+        uint8_t target = static_cast<uint8_t>(ETileType::TARGET);
+        _boxesOnTarget += (_tiles[to] == target) - (_tiles[from] == target);
+        _boxAt[to] = _boxAt[from];
+        _boxAt[from] = -1;
+        _boxes[_boxAt[to]] = boxNext;
+        _player = next;
+        notify(EGameEvent::BOX_MOVED);
+    } else {
+        _player = next;
+    }
+
+    ++_moveCount;
+    notify(EGameEvent::PLAYER_MOVED);
+    if (getCurrentState() == EGameState::LEVEL_COMPLETED) {
+        notify(EGameEvent::LEVEL_WON);
+    }
+}
+
+EGameState SpectatorGame::getCurrentState() {
+    if (!_loaded) {
+        return EGameState::LOADING;
+    }
+    return _boxesOnTarget == static_cast<int>(_boxes.size()) ? EGameState::LEVEL_COMPLETED : EGameState::PLAYING;
+}
+
+ETileType SpectatorGame::getTileAt(Position position) {
+    if (!isInside(position.getRow(), position.getCol())) {
+        return ETileType::WALL;
+    }
+    return static_cast<ETileType>(_tiles[position.getRow() * _width + position.getCol()]);
+}
+
+void SpectatorGame::addObserver(IGameObserver* observer) {
+    if (observer) {
+        _observers.push_back(observer);
+    }
+}
+
+void SpectatorGame::removeObserver(IGameObserver* observer) {
+    auto it = std::find(_observers.begin(), _observers.end(), observer);
+    if (it != _observers.end()) {
+        _observers.erase(it);
+    }
+}
+
+void SpectatorGame::notify(EGameEvent event) {
+    for (auto* observer : _observers) {
+        if (observer) {
+            observer->onNotify(event);
+        }
+    }
+}
+
+bool SpectatorGame::isInside(int row, int col) const {
+    return row >= 0 && col >= 0 && row < _height && col < _width;
+}
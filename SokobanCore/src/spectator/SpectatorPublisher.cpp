@@ -0,0 +1,194 @@
+#include "spectator/SpectatorPublisher.h"
+#include <chrono>
+#include <stdexcept>
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    uint32_t getU32(const uint8_t* in) {
+        return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+               static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+    }
+}
+
+SpectatorPublisher::SpectatorPublisher(IGame* game, const std::string& socketPath, size_t maxBacklog, int sendIntervalMs)
+    : _game(game),
+      _socketPath(socketPath),
+      _maxBacklog(maxBacklog),
+      _sendIntervalMs(sendIntervalMs),
+      _listenSocket(-1),
+      _encoder(game),
+      _stopping(false),
+      _subscribers(0),
+      _disconnected(0)
+{
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid spectator socket path " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    _listenSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenSocket < 0) {
+        throw std::runtime_error("Failed to create spectator socket");
+    }
+    // A socket file left behind by a previous run would make bind fail.
+    ::unlink(socketPath.c_str());
+    if (::bind(_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(_listenSocket, 16) != 0) {
+        ::close(_listenSocket);
+        throw std::runtime_error("Failed to listen on spectator socket " + socketPath + ": " + std::strerror(errno));
+    }
+    ::fcntl(_listenSocket, F_SETFL, ::fcntl(_listenSocket, F_GETFL) | O_NONBLOCK);
+#else
+    throw std::runtime_error("Spectator broadcast needs Unix domain sockets");
+#endif
+
+    if (_game && _game->getCurrentState() != EGameState::LOADING) {
+        _encoder.encodeKeyframe(_packets);
+        publish(true);
+    }
+    _sender = std::thread(&SpectatorPublisher::run, this);
+}
+
+SpectatorPublisher::~SpectatorPublisher() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _sender.join();
+
+#ifndef _WIN32
+    for (Client& client : _clients) {
+        ::close(client.socket);
+    }
+    ::close(_listenSocket);
+    ::unlink(_socketPath.c_str());
+#endif
+}
+
+void SpectatorPublisher::onNotify(EGameEvent event) {
+    // Encoded outside the lock; only the append is shared.
+    _packets.clear();
+    bool keyframe = _encoder.encode(event, _packets);
+    if (!_packets.empty()) {
+        publish(keyframe);
+    }
+}
+
+void SpectatorPublisher::publish(bool wake) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _outgoing.insert(_outgoing.end(), _packets.begin(), _packets.end());
+    }
+    // No wake-up per move: the sender picks moves up on its next interval,
+    // which keeps the game thread clear of system calls.
+    if (wake) {
+        _wake.notify_one();
+    }
+}
+
+void SpectatorPublisher::run() {
+    std::vector<uint8_t> batch;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait_for(lock, std::chrono::milliseconds(_sendIntervalMs));
+        bool stopping = _stopping;
+        batch.clear();
+        batch.swap(_outgoing);
+        lock.unlock();
+
+        // Accepted before the batch, so new viewers get the state up to
+        // now from _sync and the batch on top of it.
+        acceptClients();
+        fanOut(batch);
+
+        lock.lock();
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void SpectatorPublisher::acceptClients() {
+#ifndef _WIN32
+    while (true) {
+        int socket = ::accept(_listenSocket, nullptr, nullptr);
+        if (socket < 0) {
+            break;
+        }
+        ::fcntl(socket, F_SETFL, ::fcntl(socket, F_GETFL) | O_NONBLOCK);
+        _clients.push_back(Client{socket, _sync, 0});
+    }
+#endif
+}
+
+void SpectatorPublisher::fanOut(const std::vector<uint8_t>& batch) {
+    size_t offset = 0;
+    while (offset < batch.size()) {
+        if (batch[offset] & SpectatorFormat::DeltaFlag) {
+            _sync.push_back(batch[offset]);
+            ++offset;
+            continue;
+        }
+        size_t size = SpectatorFormat::KeyframeHeaderSize + getU32(&batch[offset + 1]);
+        _sync.assign(batch.begin() + static_cast<std::ptrdiff_t>(offset),
+                     batch.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        offset += size;
+    }
+
+    for (size_t i = 0; i < _clients.size();) {
+        Client& client = _clients[i];
+        client.backlog.insert(client.backlog.end(), batch.begin(), batch.end());
+        if (sendBacklog(client)) {
+            ++i;
+            continue;
+        }
+#ifndef _WIN32
+        ::close(client.socket);
+#endif
+        if (i + 1 != _clients.size()) {
+            _clients[i] = std::move(_clients.back());
+        }
+        _clients.pop_back();
+        _disconnected.fetch_add(1, std::memory_order_relaxed);
+    }
+    _subscribers.store(_clients.size(), std::memory_order_relaxed);
+}
+
+bool SpectatorPublisher::sendBacklog(Client& client) {
+#ifndef _WIN32
+    while (client.sent < client.backlog.size()) {
+        ssize_t count = ::send(client.socket, client.backlog.data() + client.sent, client.backlog.size() - client.sent,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (count > 0) {
+            client.sent += static_cast<size_t>(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    // Sent bytes are dropped once they make up half the buffer, so a viewer
+    // that never fully catches up does not keep them forever.
+    if (client.sent > 0 && client.sent * 2 >= client.backlog.size()) {
+        client.backlog.erase(client.backlog.begin(), client.backlog.begin() + static_cast<std::ptrdiff_t>(client.sent));
+        client.sent = 0;
+    }
+    return client.backlog.size() - client.sent <= _maxBacklog;
+#else
+    (void)client;
+    return false;
+#endif
+}
@@ -0,0 +1,116 @@
+#include "telemetry/TelemetryReader.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    class Cursor {
+    public:
+        explicit Cursor(const std::string& data) : _data(data), _offset(0) {}
+
+        bool atEnd() const { return _offset >= _data.size(); }
+
+        bool readByte(uint8_t& value) {
+            if (atEnd()) {
+                return false;
+            }
+            value = static_cast<uint8_t>(_data[_offset++]);
+            return true;
+        }
+
+        bool readVarint(uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t byte;
+                if (!readByte(byte)) {
+                    return false;
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool readSigned(int64_t& value) {
+            uint64_t raw;
+            if (!readVarint(raw)) {
+                return false;
+            }
+            value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+            return true;
+        }
+
+    private:
+        const std::string& _data;
+        size_t _offset;
+    };
+}
+
+TelemetryLog TelemetryReader::read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    std::string data = contents.str();
+
+    TelemetryLog log;
+    if (data.size() < sizeof(TelemetryFormat::Magic) ||
+        std::memcmp(data.data(), TelemetryFormat::Magic, sizeof(TelemetryFormat::Magic)) != 0) {
+        throw std::runtime_error(path + " is not a telemetry file");
+    }
+    std::string body = data.substr(sizeof(TelemetryFormat::Magic));
+    Cursor cursor(body);
+    uint64_t version;
+    if (!cursor.readVarint(version) || version != TelemetryFormat::Version ||
+        !cursor.readVarint(log.startEpochNs)) {
+        throw std::runtime_error(path + " has an unsupported telemetry version");
+    }
+
+    TelemetryEvent previous{};
+    while (!cursor.atEnd()) {
+        TelemetryEvent event{};
+        uint64_t timeDelta;
+        int64_t deltas[6];
+        bool complete = cursor.readByte(event.type) && cursor.readVarint(timeDelta);
+        for (int i = 0; i < 6 && complete; ++i) {
+            complete = cursor.readSigned(deltas[i]);
+        }
+        if (!complete) {
+            log.truncated = true;
+            break;
+        }
+        event.timestampNs = previous.timestampNs + timeDelta;
+        event.moveCount = static_cast<uint32_t>(previous.moveCount + deltas[0]);
+        event.level = static_cast<uint16_t>(previous.level + deltas[1]);
+        event.playerRow = static_cast<int16_t>(previous.playerRow + deltas[2]);
+        event.playerCol = static_cast<int16_t>(previous.playerCol + deltas[3]);
+        event.boxRow = static_cast<int16_t>(previous.boxRow + deltas[4]);
+        event.boxCol = static_cast<int16_t>(previous.boxCol + deltas[5]);
+        log.events.push_back(event);
+        previous = event;
+    }
+    return log;
+}
+
+const char* TelemetryReader::eventName(uint8_t type) {
+    switch (static_cast<EGameEvent>(type)) {
+        case EGameEvent::PLAYER_MOVED:
+            return "PLAYER_MOVED";
+        case EGameEvent::BOX_MOVED:
+            return "BOX_MOVED";
+        case EGameEvent::LEVEL_RELOADED:
+            return "LEVEL_RELOADED";
+        case EGameEvent::LEVEL_WON:
+            return "LEVEL_WON";
+        case EGameEvent::HISTORY_SEEKED:
+            return "HISTORY_SEEKED";
+        case EGameEvent::LEVEL_SOURCE_CHANGED:
+            return "LEVEL_SOURCE_CHANGED";
+    }
+    return "UNKNOWN";
+}
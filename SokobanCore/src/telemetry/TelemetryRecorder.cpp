@@ -0,0 +1,137 @@
+#include "telemetry/TelemetryRecorder.h"
+#include <stdexcept>
+
+namespace {
+    void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    void putSigned(std::string& out, int64_t value) {
+        putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+TelemetryRecorder::TelemetryRecorder(const std::string& path, size_t capacity, int flushIntervalMs)
+    : _ring(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+      _mask(_ring.size() - 1),
+      _head(0),
+      _tail(0),
+      _cachedHead(0),
+      _recorded(0),
+      _dropped(0),
+      _written(0),
+      _start(std::chrono::steady_clock::now()),
+      _flushIntervalMs(flushIntervalMs),
+      _file(path, std::ios::binary | std::ios::trunc),
+      _previous(),
+      _stopping(false)
+{
+    if (!_file.is_open()) {
+        throw std::runtime_error("Failed to create telemetry file " + path);
+    }
+
+    std::string header(TelemetryFormat::Magic, sizeof(TelemetryFormat::Magic));
+    putVarint(header, TelemetryFormat::Version);
+    auto epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    putVarint(header, static_cast<uint64_t>(epoch.count()));
+    _file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    _buffer.reserve(_ring.size() * 8);
+    _flusher = std::thread(&TelemetryRecorder::run, this);
+}
+
+TelemetryRecorder::~TelemetryRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _flusher.join();
+}
+
+void TelemetryRecorder::record(EGameEvent type, int level, int moveCount, const Position& player,
+                               const Position& box) noexcept {
+    // Single writer, so plain stores are enough for the counters.
+    _recorded.store(_recorded.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _cachedHead > _mask) {
+        _cachedHead = _head.load(std::memory_order_acquire);
+        if (tail - _cachedHead > _mask) {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    TelemetryEvent& event = _ring[tail & _mask];
+    event.timestampNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+    event.moveCount = static_cast<uint32_t>(moveCount);
+    event.level = static_cast<uint16_t>(level);
+    event.type = static_cast<uint8_t>(type);
+    event.reserved = 0;
+    event.playerRow = static_cast<int16_t>(player.getRow());
+    event.playerCol = static_cast<int16_t>(player.getCol());
+    event.boxRow = static_cast<int16_t>(box.getRow());
+    event.boxCol = static_cast<int16_t>(box.getCol());
+    _tail.store(tail + 1, std::memory_order_release);
+}
+
+void TelemetryRecorder::flush() {
+    _wake.notify_one();
+}
+
+void TelemetryRecorder::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+        _wake.wait_for(lock, std::chrono::milliseconds(_flushIntervalMs));
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    lock.unlock();
+    drain();
+}
+
+void TelemetryRecorder::drain() {
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    uint64_t tail = _tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+    _buffer.clear();
+    for (; head != tail; ++head) {
+        encode(_ring[head & _mask]);
+    }
+    _head.store(head, std::memory_order_release);
+
+    _file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _file.flush();
+}
+
+void TelemetryRecorder::encode(const TelemetryEvent& event) {
+    // Consecutive events are close in time, move count and position, so
+    // deltas from the previous event mostly fit in a single byte each.
+    _buffer += static_cast<char>(event.type);
+    putVarint(_buffer, event.timestampNs - _previous.timestampNs);
+    putSigned(_buffer, static_cast<int64_t>(event.moveCount) - _previous.moveCount);
+    putSigned(_buffer, static_cast<int64_t>(event.level) - _previous.level);
+    putSigned(_buffer, event.playerRow - _previous.playerRow);
+    putSigned(_buffer, event.playerCol - _previous.playerCol);
+    putSigned(_buffer, event.boxRow - _previous.boxRow);
+    putSigned(_buffer, event.boxCol - _previous.boxCol);
+    _previous = event;
+    _written.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,66 @@
+#ifndef SOKOBANGAME_TERMINALSCREEN_H
+#define SOKOBANGAME_TERMINALSCREEN_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ECellStyle : uint8_t {
+    PLAIN,
+    WALL,
+    FLOOR,
+    TARGET,
+    BOX,
+    BOX_ON_TARGET,
+    PLAYER,
+    STATUS,
+    HELP,
+};
+
+struct Cell {
+    char glyph;
+    ECellStyle style;
+
+    bool operator==(const Cell& other) const { return glyph == other.glyph && style == other.style; }
+    bool operator!=(const Cell& other) const { return !(*this == other); }
+};
+
+// Two grids of character cells: what the terminal shows now and what the
+// next frame should show. Writing a cell only records it when it differs
+// from the screen, and present() emits just those cells, each run prefixed
+// with a cursor address and a colour change only where one is needed. The
+// cost of a frame follows the number of changed cells, not the screen size.
+class TerminalScreen {
+public:
+    TerminalScreen();
+
+    // Forgets what is on screen; the next present() clears and repaints.
+    void resize(int columns, int rows);
+    void setColor(bool enabled);
+
+    void set(int row, int col, Cell cell);
+    // Clipped at the right edge; the rest of the row up to width is blanked.
+    void text(int row, int col, const std::string& value, ECellStyle style, int width);
+
+    // Appends the escape sequences for every changed cell to out and
+    // returns false when nothing changed.
+    bool present(std::string& out);
+
+    int getColumns() const { return _columns; }
+    int getRows() const { return _rows; }
+
+private:
+    const char* getStyle(ECellStyle style) const;
+
+    int _columns;
+    int _rows;
+    bool _color;
+    bool _cleared;
+    std::vector<Cell> _front;
+    std::vector<Cell> _back;
+    // Cells written since the last present(), each listed once.
+    std::vector<int> _dirty;
+    std::vector<uint8_t> _isDirty;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef SOKOBANGAME_TERMINAL_VIEW_H
+#define SOKOBANGAME_TERMINAL_VIEW_H
+
+#include <interfaces/IGame.h>
+#include <interfaces/IGameObserver.h>
+#include <enums/EGameEvent.h>
+#include <InputQueue.h>
+#include "TerminalScreen.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Text front end for terminals without a display, e.g. over SSH. The board
+// is drawn two character cells per tile between a status line and a help
+// line. Move events only redraw the tiles the player and a pushed box left
+// and entered, so a move costs a few cells of output whatever the board
+// size. Boards larger than the terminal scroll by half a screen when the
+// player comes close to an edge.
+class Terminal_View : public IGameObserver {
+public:
+    explicit Terminal_View(IGame* game);
+
+    // Screen size in character cells; everything is redrawn.
+    void resize(int columns, int rows);
+    void setColor(bool enabled);
+    // Watching someone else's game: every key but quit is ignored.
+    void setSpectating(bool spectating);
+
+    void onNotify(EGameEvent event) override;
+
+    // Queues the commands in raw bytes read from the terminal.
+    void handleInput(const char* bytes, size_t length);
+
+    // Applies every queued command and picks up edits to the level pack.
+    void update();
+
+    // Appends the escape sequences for what changed since the last call;
+    // false when the screen is already up to date.
+    bool render(std::string& out);
+
+    bool shouldClose() const { return _quit; }
+
+    void applyCommand(EInputCommand command);
+
+private:
+    IGame* _gameLogic;
+    TerminalScreen _screen;
+    InputQueue _inputQueue;
+
+    int _levelWidth;
+    int _levelHeight;
+    // Tiles that fit between the status and help lines.
+    int _viewRows;
+    int _viewCols;
+    // Board tile shown in the top left corner of the view.
+    int _originRow;
+    int _originCol;
+    // Screen cell of the view's top left corner; centres small boards.
+    int _screenRow;
+    int _screenCol;
+
+    // One byte per tile, set where a box stands, so drawing a tile does not
+    // search the box list.
+    std::vector<uint8_t> _boxes;
+    // Where the player was last drawn; a push moves the box one step
+    // further along the same direction.
+    Position _drawnPlayer;
+
+    std::string _statusMessage;
+    // What the status line shows, so it is only rebuilt when it changes.
+    std::string _shownMessage;
+    int _shownLevelId;
+    int _shownMoveCount;
+    std::string _statusLine;
+    bool _spectating;
+    bool _quit;
+
+    void rebuildBoard();
+    void layoutView();
+    bool followPlayer();
+    void drawView();
+    void drawTile(int row, int col);
+    void drawStatus();
+    void loadNextLevel();
+    void reloadEditedLevel();
+    bool isInside(int row, int col) const;
+};
+
+#endif
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "include/Terminal_View.h"
+#include <Game.h>
+#include <InputQueue.h>
+#include <LevelIndex.h>
+#include <memory>
+#include <spectator/SpectatorGame.h>
+#include <spectator/SpectatorPublisher.h>
+
+namespace {
+    volatile std::sig_atomic_t windowResized = 0;
+
+    void onWindowResized(int) {
+        windowResized = 1;
+    }
+
+    void writeAll(const std::string& out) {
+        size_t written = 0;
+        while (written < out.size()) {
+            ssize_t count = ::write(STDOUT_FILENO, out.data() + written, out.size() - written);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            written += static_cast<size_t>(count);
+        }
+    }
+
+    bool getWindowSize(int& columns, int& rows) {
+        winsize size{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0) {
+            return false;
+        }
+        columns = size.ws_col;
+        rows = size.ws_row;
+        return true;
+    }
+
+    // Raw input on the alternate screen with the cursor hidden, for as long
+    // as it lives; the shell gets its screen and settings back on any exit
+    // that unwinds the stack.
+    class RawTerminal {
+    public:
+        RawTerminal() : _original() {
+            if (tcgetattr(STDIN_FILENO, &_original) != 0) {
+                throw std::runtime_error("stdin is not a terminal");
+            }
+            termios raw = _original;
+            cfmakeraw(&raw);
+            raw.c_oflag |= OPOST | ONLCR;
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+            writeAll("\x1b[?1049h\x1b[?25l");
+        }
+
+        ~RawTerminal() {
+            writeAll("\x1b[0m\x1b[?25h\x1b[?1049l");
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &_original);
+        }
+
+        RawTerminal(const RawTerminal&) = delete;
+        RawTerminal& operator=(const RawTerminal&) = delete;
+
+    private:
+        termios _original;
+    };
+
+    // Plays random moves through the view at a fixed screen size, rendering
+    // after each one into memory, and reports the time and output per move.
+    void runBenchmark(Game& game, long moves, int columns, int rows) {
+        Terminal_View view(&game);
+        game.addObserver(&view);
+        view.resize(columns, rows);
+
+        std::string out;
+        view.render(out);
+        size_t fullFrame = out.size();
+
+        uint32_t seed = 12345;
+        size_t bytes = 0;
+        long frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long move = 0; move < moves; ++move) {
+            seed = seed * 1664525u + 1013904223u;
+            view.applyCommand(static_cast<EInputCommand>((seed >> 16) % 4));
+            if (game.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                game.restartLevel();
+            }
+            out.clear();
+            if (view.render(out)) {
+                bytes += out.size();
+                ++frames;
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        game.removeObserver(&view);
+
+        std::cout << "Terminal benchmark: " << moves << " moves on a " << columns << "x" << rows << " screen, "
+                  << elapsed.count() / std::max(1L, moves) << " ns/move, "
+                  << static_cast<double>(bytes) / std::max(1L, frames) << " bytes/frame (full frame "
+                  << fullFrame << " bytes)\n";
+    }
+
+    // Runs the view on the terminal until the player quits. A spectator
+    // stream, when given, is read alongside the keyboard; returns false if
+    // its publisher went away.
+    bool runInteractive(Terminal_View& view, SpectatorGame* spectator) {
+        // Without SA_RESTART, so a resize interrupts the wait for input.
+        struct sigaction action{};
+        action.sa_handler = onWindowResized;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGWINCH, &action, nullptr);
+
+        RawTerminal terminal;
+        int columns = 80;
+        int rows = 24;
+        getWindowSize(columns, rows);
+        view.resize(columns, rows);
+
+        std::string out;
+        char input[256];
+        bool hangup = false;
+        bool streaming = true;
+        while (!view.shouldClose() && !hangup && streaming) {
+            if (windowResized) {
+                windowResized = 0;
+                if (getWindowSize(columns, rows)) {
+                    view.resize(columns, rows);
+                }
+            }
+
+            view.update();
+            out.clear();
+            if (view.render(out)) {
+                writeAll(out);
+            }
+
+            // Wakes up now and then without input to pick up edits to the
+            // level pack.
+            pollfd requests[2] = {{STDIN_FILENO, POLLIN, 0}, {spectator ? spectator->getSocket() : -1, POLLIN, 0}};
+            if (poll(requests, spectator ? 2 : 1, 250) <= 0) {
+                continue;
+            }
+            if (requests[0].revents != 0) {
+                ssize_t count = ::read(STDIN_FILENO, input, sizeof(input));
+                if (count > 0) {
+                    view.handleInput(input, static_cast<size_t>(count));
+                }
+                // Readable without data: the SSH session went away.
+                hangup = count == 0 || (requests[0].revents & (POLLHUP | POLLERR)) != 0;
+            }
+            if (spectator && requests[1].revents != 0) {
+                streaming = spectator->receive();
+            }
+        }
+        return streaming;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool color = std::getenv("NO_COLOR") == nullptr;
+    int level = 1;
+    long benchmarkMoves = 0;
+    int benchmarkColumns = 80;
+    int benchmarkRows = 24;
+    std::string broadcastPath;
+    std::string watchPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-color") == 0) {
+            color = false;
+        } else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            level = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+            benchmarkMoves = std::stol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            benchmarkColumns = std::stoi(argv[++i]);
+            benchmarkRows = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--broadcast") == 0 && i + 1 < argc) {
+            broadcastPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watchPath = argv[++i];
+        } else {
+            std::cerr << "Usage: SokobanTerminal [--level N] [--no-color] [--broadcast SOCKET]"
+                         " [--benchmark MOVES [--size COLUMNS ROWS]]\n"
+                         "       SokobanTerminal --watch SOCKET [--no-color]\n";
+            return 2;
+        }
+    }
+
+    try {
+        if (!watchPath.empty()) {
+            if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+                std::cerr << "Error: SokobanTerminal needs an interactive terminal\n";
+                return 1;
+            }
+
+            SpectatorGame spectator;
+            spectator.connect(watchPath);
+            Terminal_View view(&spectator);
+            view.setColor(color);
+            view.setSpectating(true);
+            spectator.addObserver(&view);
+
+            bool streaming = runInteractive(view, &spectator);
+            spectator.removeObserver(&view);
+            if (!streaming) {
+                std::cout << "The session being watched has ended.\n";
+            }
+            return 0;
+        }
+
+        Game game;
+        game.loadLevel(level);
+
+        // Registered first, so viewers hear about every event the local
+        // view reacts to.
+        std::unique_ptr<SpectatorPublisher> publisher;
+        if (!broadcastPath.empty()) {
+            publisher = std::make_unique<SpectatorPublisher>(&game, broadcastPath);
+            game.addObserver(publisher.get());
+        }
+
+        if (benchmarkMoves > 0) {
+            runBenchmark(game, benchmarkMoves, benchmarkColumns, benchmarkRows);
+            game.removeObserver(publisher.get());
+            return 0;
+        }
+
+        if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+            std::cerr << "Error: SokobanTerminal needs an interactive terminal\n";
+            return 1;
+        }
+
+        Terminal_View view(&game);
+        view.setColor(color);
+        game.addObserver(&view);
+
+        // Edits to levels.json show up without restarting.
+        LevelIndex::shared().startWatching();
+
+        runInteractive(view, nullptr);
+
+        game.removeObserver(&view);
+        game.removeObserver(publisher.get());
+        LevelIndex::shared().stopWatching();
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "TerminalScreen.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const Cell Blank = Cell{' ', ECellStyle::PLAIN};
+
+    // Every sequence starts with a reset so a style never depends on the
+    // one before it.
+    const char* const ColorStyles[] = {
+        "\x1b[0m",
+        "\x1b[0;37;100m",
+        "\x1b[0m",
+        "\x1b[0;31m",
+        "\x1b[0;1;33m",
+        "\x1b[0;1;32m",
+        "\x1b[0;1;36m",
+        "\x1b[0;1;37;44m",
+        "\x1b[0;2m",
+    };
+
+    const char* const MonoStyles[] = {
+        "\x1b[0m",
+        "\x1b[0m",
+        "\x1b[0m",
+        "\x1b[0m",
+        "\x1b[0;1m",
+        "\x1b[0;1m",
+        "\x1b[0;1m",
+        "\x1b[0;7m",
+        "\x1b[0m",
+    };
+
+    void appendNumber(std::string& out, int value) {
+        char digits[12];
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (length > 0) {
+            out += digits[--length];
+        }
+    }
+}
+
+TerminalScreen::TerminalScreen()
+    : _columns(0),
+      _rows(0),
+      _color(true),
+      _cleared(false) {}
+
+void TerminalScreen::resize(int columns, int rows) {
+    _columns = std::max(0, columns);
+    _rows = std::max(0, rows);
+    size_t cells = static_cast<size_t>(_columns) * _rows;
+    _front.assign(cells, Blank);
+    _back.assign(cells, Blank);
+    _isDirty.assign(cells, 0);
+    _dirty.clear();
+    _cleared = false;
+}
+
+void TerminalScreen::setColor(bool enabled) {
+    _color = enabled;
+    resize(_columns, _rows);
+}
+
+void TerminalScreen::set(int row, int col, Cell cell) {
+    if (row < 0 || col < 0 || row >= _rows || col >= _columns) {
+        return;
+    }
+    int index = row * _columns + col;
+    _back[index] = cell;
+    if (!_isDirty[index] && _front[index] != cell) {
+        _isDirty[index] = 1;
+        _dirty.push_back(index);
+    }
+}
+
+void TerminalScreen::text(int row, int col, const std::string& value, ECellStyle style, int width) {
+    if (row < 0 || row >= _rows) {
+        return;
+    }
+    int first = std::max(0, col);
+    int last = std::min(_columns, col + width);
+    int length = static_cast<int>(value.size());
+    for (int i = first; i < last; ++i) {
+        int index = row * _columns + i;
+        Cell cell = Cell{i - col < length ? value[i - col] : ' ', style};
+        _back[index] = cell;
+        if (!_isDirty[index] && _front[index] != cell) {
+            _isDirty[index] = 1;
+            _dirty.push_back(index);
+        }
+    }
+}
+
+bool TerminalScreen::present(std::string& out) {
+    size_t start = out.size();
+    if (!_cleared) {
+        out += "\x1b[0m\x1b[2J";
+        _cleared = true;
+    }
+
+    // Row-major order keeps runs of neighbouring cells together, so most of
+    // them need no cursor address of their own.
+    std::sort(_dirty.begin(), _dirty.end());
+    int cursor = -1;
+    // Styles that look the same share a sequence, so compare those.
+    const char* shown = nullptr;
+    for (int index : _dirty) {
+        _isDirty[index] = 0;
+        const Cell& cell = _back[index];
+        if (_front[index] == cell) {
+            continue;
+        }
+        if (index != cursor) {
+            out += "\x1b[";
+            appendNumber(out, index / _columns + 1);
+            out += ';';
+            appendNumber(out, index % _columns + 1);
+            out += 'H';
+        }
+        const char* style = getStyle(cell.style);
+        if (shown == nullptr || std::strcmp(style, shown) != 0) {
+            out += style;
+            shown = style;
+        }
+        out += cell.glyph;
+        _front[index] = cell;
+        // Writing the last column leaves the cursor in a pending-wrap state
+        // that terminals handle differently, so the next cell is addressed.
+        cursor = (index + 1) % _columns == 0 ? -1 : index + 1;
+    }
+    _dirty.clear();
+
+    const char* plain = getStyle(ECellStyle::PLAIN);
+    if (shown != nullptr && std::strcmp(shown, plain) != 0) {
+        out += plain;
+    }
+    return out.size() > start;
+}
+
+const char* TerminalScreen::getStyle(ECellStyle style) const {
+    return (_color ? ColorStyles : MonoStyles)[static_cast<int>(style)];
+}
@@ -0,0 +1,365 @@
+#include "Terminal_View.h"
+#include <LevelIndex.h>
+#include <algorithm>
+
+namespace {
+    const Cell Blank = Cell{' ', ECellStyle::PLAIN};
+
+    struct TileGlyph {
+        char left;
+        char right;
+        ECellStyle style;
+    };
+
+    const TileGlyph WallGlyph = {'#', '#', ECellStyle::WALL};
+    const TileGlyph FloorGlyph = {' ', ' ', ECellStyle::FLOOR};
+    const TileGlyph TargetGlyph = {'.', '.', ECellStyle::TARGET};
+    const TileGlyph BoxGlyph = {'[', ']', ECellStyle::BOX};
+    const TileGlyph BoxOnTargetGlyph = {'{', '}', ECellStyle::BOX_ON_TARGET};
+    const TileGlyph PlayerGlyph = {'@', '@', ECellStyle::PLAYER};
+
+    const char* const HelpText = " Arrows/WASD: Move | R: Restart | N: Next Level | Q: Exit";
+    const char* const SpectatorHelpText = " Spectating | Q: Exit";
+
+    // Keeps the player at least a quarter of the view away from its edges;
+    // past that the view jumps to centre the player, so scrolling is rare.
+    int scrollOrigin(int origin, int player, int view, int level) {
+        if (level <= view) {
+            return 0;
+        }
+        int margin = view / 4;
+        if (player < origin + margin || player >= origin + view - margin) {
+            origin = player - view / 2;
+        }
+        return std::max(0, std::min(origin, level - view));
+    }
+}
+
+Terminal_View::Terminal_View(IGame* game)
+    : _gameLogic(game),
+      _levelWidth(0),
+      _levelHeight(0),
+      _viewRows(0),
+      _viewCols(0),
+      _originRow(0),
+      _originCol(0),
+      _screenRow(1),
+      _screenCol(0),
+      _drawnPlayer(0, 0),
+      _statusMessage("Use Arrow Keys to move. R to restart."),
+      _shownLevelId(-1),
+      _shownMoveCount(-1),
+      _spectating(false),
+      _quit(false) {}
+
+void Terminal_View::resize(int columns, int rows) {
+    _screen.resize(columns, rows);
+    _shownMoveCount = -1;
+    rebuildBoard();
+}
+
+void Terminal_View::setColor(bool enabled) {
+    _screen.setColor(enabled);
+    _shownMoveCount = -1;
+    rebuildBoard();
+}
+
+void Terminal_View::setSpectating(bool spectating) {
+    _spectating = spectating;
+    if (_spectating) {
+        _statusMessage = "Watching a live session.";
+    }
+    drawView();
+}
+
+void Terminal_View::onNotify(EGameEvent event) {
+    switch (event) {
+        case EGameEvent::LEVEL_WON:
+            _statusMessage = _spectating ? "Level Complete!" : "Level Complete! Press N for next level or R to restart.";
+            break;
+
+        case EGameEvent::LEVEL_RELOADED:
+            _statusMessage = _spectating ? "Watching a live session." : "Level Loaded! Use Arrow Keys to move.";
+            rebuildBoard();
+            break;
+
+        case EGameEvent::BOX_MOVED: {
+            // Sent before PLAYER_MOVED: the player already stands where the
+            // box was, and the box went one step further.
+            Position player = _gameLogic->getPlayerPosition();
+            int rowStep = player.getRow() - _drawnPlayer.getRow();
+            int colStep = player.getCol() - _drawnPlayer.getCol();
+            int toRow = player.getRow() + rowStep;
+            int toCol = player.getCol() + colStep;
+            if (isInside(player.getRow(), player.getCol()) && isInside(toRow, toCol)) {
+                _boxes[player.getRow() * _levelWidth + player.getCol()] = 0;
+                _boxes[toRow * _levelWidth + toCol] = 1;
+                drawTile(toRow, toCol);
+            }
+            break;
+        }
+
+        case EGameEvent::PLAYER_MOVED: {
+            Position previous = _drawnPlayer;
+            _drawnPlayer = _gameLogic->getPlayerPosition();
+            if (followPlayer()) {
+                drawView();
+            } else {
+                drawTile(previous.getRow(), previous.getCol());
+                drawTile(_drawnPlayer.getRow(), _drawnPlayer.getCol());
+            }
+            break;
+        }
+
+        case EGameEvent::HISTORY_SEEKED:
+            _statusMessage = "Move " + std::to_string(_gameLogic->getMoveCount()) + " of " +
+                             std::to_string(_gameLogic->getHistoryLength());
+            rebuildBoard();
+            break;
+
+        case EGameEvent::LEVEL_SOURCE_CHANGED:
+            reloadEditedLevel();
+            break;
+    }
+}
+
+void Terminal_View::handleInput(const char* bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        char key = bytes[i];
+        if (key == '\x1b') {
+            // A lone escape is the key itself; anything following it in the
+            // same read is an escape sequence such as an arrow key.
+            if (i + 1 == length) {
+                _quit = true;
+                return;
+            }
+            if ((bytes[i + 1] == '[' || bytes[i + 1] == 'O') && i + 2 < length) {
+                char final = bytes[i + 2];
+                i += 2;
+                // Skips the parameters of sequences with any.
+                while ((final < '@' || final > '~') && i + 1 < length) {
+                    final = bytes[++i];
+                }
+                switch (final) {
+                    case 'A': _inputQueue.push(EInputCommand::MOVE_UP); break;
+                    case 'B': _inputQueue.push(EInputCommand::MOVE_DOWN); break;
+                    case 'C': _inputQueue.push(EInputCommand::MOVE_RIGHT); break;
+                    case 'D': _inputQueue.push(EInputCommand::MOVE_LEFT); break;
+                    default: break;
+                }
+            } else {
+                ++i;
+            }
+            continue;
+        }
+
+        switch (key) {
+            case 'w': case 'W':
+                _inputQueue.push(EInputCommand::MOVE_UP);
+                break;
+            case 's': case 'S':
+                _inputQueue.push(EInputCommand::MOVE_DOWN);
+                break;
+            case 'a': case 'A':
+                _inputQueue.push(EInputCommand::MOVE_LEFT);
+                break;
+            case 'd': case 'D':
+                _inputQueue.push(EInputCommand::MOVE_RIGHT);
+                break;
+            case 'r': case 'R':
+                _inputQueue.push(EInputCommand::RESTART);
+                break;
+            case 'n': case 'N':
+                _inputQueue.push(EInputCommand::NEXT_LEVEL);
+                break;
+            case 'q': case 'Q': case '\x03':
+                _quit = true;
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void Terminal_View::update() {
+    if (!_gameLogic) return;
+
+    _gameLogic->checkLevelSource();
+
+    if (_spectating) {
+        _inputQueue.clear();
+        return;
+    }
+
+    // Keys are applied as they arrive; a burst typed between two frames is
+    // drawn once.
+    EInputCommand command;
+    while (_inputQueue.pop(command)) {
+        applyCommand(command);
+    }
+}
+
+bool Terminal_View::render(std::string& out) {
+    if (!_gameLogic || _screen.getRows() == 0) {
+        return false;
+    }
+    drawStatus();
+    return _screen.present(out);
+}
+
+void Terminal_View::applyCommand(EInputCommand command) {
+    EFacing direction;
+    if (InputQueue::toFacing(command, direction)) {
+        _gameLogic->movePlayer(direction);
+        return;
+    }
+
+    switch (command) {
+        case EInputCommand::RESTART:
+            _gameLogic->restartLevel();
+            break;
+        case EInputCommand::NEXT_LEVEL:
+            loadNextLevel();
+            break;
+        default:
+            break;
+    }
+}
+
+void Terminal_View::rebuildBoard() {
+    if (!_gameLogic) return;
+
+    _levelWidth = std::max(0, _gameLogic->getLevelWidth());
+    _levelHeight = std::max(0, _gameLogic->getLevelLength());
+    _boxes.assign(static_cast<size_t>(_levelWidth) * _levelHeight, 0);
+    for (const Position& box : _gameLogic->getBoxPositions()) {
+        if (isInside(box.getRow(), box.getCol())) {
+            _boxes[box.getRow() * _levelWidth + box.getCol()] = 1;
+        }
+    }
+    _drawnPlayer = _gameLogic->getPlayerPosition();
+
+    layoutView();
+    followPlayer();
+    drawView();
+}
+
+void Terminal_View::layoutView() {
+    int columns = _screen.getColumns();
+    int rows = _screen.getRows();
+    _viewCols = std::max(0, columns / 2);
+    _viewRows = std::max(0, rows - 2);
+
+    int shownCols = std::min(_levelWidth, _viewCols);
+    int shownRows = std::min(_levelHeight, _viewRows);
+    _screenCol = (columns - shownCols * 2) / 2;
+    _screenRow = 1 + (_viewRows - shownRows) / 2;
+}
+
+bool Terminal_View::followPlayer() {
+    int originRow = scrollOrigin(_originRow, _drawnPlayer.getRow(), _viewRows, _levelHeight);
+    int originCol = scrollOrigin(_originCol, _drawnPlayer.getCol(), _viewCols, _levelWidth);
+    bool moved = originRow != _originRow || originCol != _originCol;
+    _originRow = originRow;
+    _originCol = originCol;
+    return moved;
+}
+
+void Terminal_View::drawView() {
+    // Only cells that end up different from the screen are sent, so a
+    // scroll costs the tiles that changed, not the whole view.
+    int columns = _screen.getColumns();
+    for (int row = 1; row <= _viewRows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            _screen.set(row, col, Blank);
+        }
+    }
+    if (_screen.getRows() > 1) {
+        _screen.text(_screen.getRows() - 1, 0, _spectating ? SpectatorHelpText : HelpText, ECellStyle::HELP, columns);
+    }
+
+    int lastRow = std::min(_levelHeight, _originRow + _viewRows);
+    int lastCol = std::min(_levelWidth, _originCol + _viewCols);
+    for (int row = _originRow; row < lastRow; ++row) {
+        for (int col = _originCol; col < lastCol; ++col) {
+            drawTile(row, col);
+        }
+    }
+}
+
+void Terminal_View::drawTile(int row, int col) {
+    if (!isInside(row, col) || row < _originRow || col < _originCol ||
+        row >= _originRow + _viewRows || col >= _originCol + _viewCols) {
+        return;
+    }
+
+    const TileGlyph* glyph = &FloorGlyph;
+    ETileType tile = _gameLogic->getTileAt(Position(row, col));
+    if (_drawnPlayer.getRow() == row && _drawnPlayer.getCol() == col) {
+        glyph = &PlayerGlyph;
+    } else if (_boxes[row * _levelWidth + col]) {
+        glyph = tile == ETileType::TARGET ? &BoxOnTargetGlyph : &BoxGlyph;
+    } else if (tile == ETileType::WALL) {
+        glyph = &WallGlyph;
+    } else if (tile == ETileType::TARGET) {
+        glyph = &TargetGlyph;
+    }
+
+    int screenRow = _screenRow + row - _originRow;
+    int screenCol = _screenCol + 2 * (col - _originCol);
+    _screen.set(screenRow, screenCol, Cell{glyph->left, glyph->style});
+    _screen.set(screenRow, screenCol + 1, Cell{glyph->right, glyph->style});
+}
+
+void Terminal_View::drawStatus() {
+    int levelId = _gameLogic->getLevelId();
+    int moveCount = _gameLogic->getMoveCount();
+    if (levelId == _shownLevelId && moveCount == _shownMoveCount && _statusMessage == _shownMessage) {
+        return;
+    }
+    _shownLevelId = levelId;
+    _shownMoveCount = moveCount;
+    _shownMessage = _statusMessage;
+
+    // Built in place: this runs after every move.
+    _statusLine.assign(" Level: ");
+    _statusLine += std::to_string(levelId);
+    _statusLine += "  Moves: ";
+    _statusLine += std::to_string(moveCount);
+    _statusLine += "  ";
+    _statusLine += _statusMessage;
+    _screen.text(0, 0, _statusLine, ECellStyle::STATUS, _screen.getColumns());
+}
+
+void Terminal_View::loadNextLevel() {
+    if (!_gameLogic) return;
+
+    // Nothing may be printed while the board is on screen, so failures only
+    // go to the status line.
+    int nextLevel = _gameLogic->getLevelId() + 1;
+    if (nextLevel > static_cast<int>(LevelIndex::shared().count())) {
+        _statusMessage = "You've completed all levels! Congratulations!";
+        return;
+    }
+
+    try {
+        _gameLogic->loadLevel(nextLevel);
+        _statusMessage = "Level " + std::to_string(nextLevel) + " loaded!";
+    } catch (const std::exception& e) {
+        _statusMessage = "Failed to load level " + std::to_string(nextLevel) + ": " + e.what();
+    }
+}
+
+void Terminal_View::reloadEditedLevel() {
+    int level = _gameLogic->getLevelId();
+    try {
+        _gameLogic->loadLevel(level);
+        _statusMessage = "Level " + std::to_string(level) + " changed on disk and was reloaded";
+    } catch (const std::exception&) {
+        _statusMessage = "Level " + std::to_string(level) + " was edited but failed to load";
+    }
+}
+
+bool Terminal_View::isInside(int row, int col) const {
+    return row >= 0 && col >= 0 && row < _levelHeight && col < _levelWidth;
+}
@@ -0,0 +1,29 @@
+#include "pch.h"
+#include "solver/Arena.h"
+
+TEST(ArenaTest, AllocationsComeFromSharedBlocks) {
+    BumpArena arena(4096);
+    for (int i = 0; i < 100; ++i) {
+        void* memory = arena.allocate(16, alignof(uint64_t));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % alignof(uint64_t), 0u);
+    }
+
+    EXPECT_EQ(arena.getAllocationCount(), 100u);
+    EXPECT_EQ(arena.getSystemAllocationCount(), 1u);
+
+    arena.release();
+    EXPECT_EQ(arena.getBytesReserved(), 0u);
+    EXPECT_EQ(arena.getPeakBytesReserved(), 4096u);
+}
+
+TEST(ArenaTest, NodePoolReusesFreedSlots) {
+    BumpArena arena;
+    NodePool pool(arena, 24, 8);
+
+    void* first = pool.allocate();
+    pool.free(first);
+    void* second = pool.allocate();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(pool.getLiveCount(), 1u);
+}
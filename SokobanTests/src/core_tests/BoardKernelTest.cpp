@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "BoardKernel.h"
+#include "Game.h"
+#include "TestLevels.h"
+
+namespace {
+    GameMap MakeRoom(int width, int height) {
+        std::vector<std::vector<int>> grid(height, std::vector<int>(width, 0));
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                if (row == 0 || col == 0 || row == height - 1 || col == width - 1) {
+                    grid[row][col] = 2;
+                }
+            }
+        }
+        grid[height - 2][width - 2] = 1;
+        grid[1][width - 2] = 1;
+        grid[height / 2][width / 2] = 2;
+        return MakeLevel(grid, Position(1, 1), {Position(2, 2), Position(height - 3, 3)}, 13);
+    }
+}
+
+TEST(BoardKernelTest, MatchesGameMoveRules) {
+    GameMap map = MakeRoom(8, 7);
+    Game game;
+    game.loadLevel(map);
+    BoardKernel<16, 16> kernel(map);
+
+    uint32_t state = 7;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1664525u + 1013904223u;
+        EFacing direction = static_cast<EFacing>(state >> 30);
+        int movesBefore = game.getMoveCount();
+        game.movePlayer(direction);
+        bool pushed;
+        bool moved = kernel.move(direction, pushed);
+        ASSERT_EQ(moved, game.getMoveCount() != movesBefore);
+        ASSERT_EQ(kernel.getPlayerPosition(), game.getPlayerPosition());
+        ASSERT_EQ(kernel.isSolved(), game.getCurrentState() == EGameState::LEVEL_COMPLETED);
+        if (kernel.isSolved()) {
+            game.restartLevel();
+            kernel.reset();
+        }
+    }
+
+    std::vector<Position> boxes = game.getBoxPositions();
+    std::vector<Position> kernelBoxes = kernel.getBoxPositions();
+    ASSERT_EQ(boxes.size(), kernelBoxes.size());
+    for (const auto& box : boxes) {
+        EXPECT_NE(std::find(kernelBoxes.begin(), kernelBoxes.end(), box), kernelBoxes.end());
+    }
+}
+
+TEST(BoardKernelTest, PicksSmallestKernelForMapSize) {
+    auto stride = [](const GameMap& map) {
+        return withBoardKernel(map, [](auto& kernel) { return std::decay_t<decltype(kernel)>::Stride; });
+    };
+    EXPECT_EQ(stride(MakeRoom(14, 14)), 16);
+    EXPECT_EQ(stride(MakeRoom(15, 10)), 32);
+    EXPECT_EQ(stride(MakeRoom(62, 40)), 64);
+    EXPECT_THROW(stride(MakeRoom(63, 10)), std::runtime_error);
+}
@@ -0,0 +1,19 @@
+#include "pch.h"
+#include "FixedTimestep.h"
+
+TEST(FixedTimestepTest, AccumulatesPartialFrames) {
+    FixedTimestep timestep(0.05, 8);
+
+    EXPECT_EQ(timestep.advance(0.02), 0);
+    EXPECT_EQ(timestep.advance(0.04), 1);
+    EXPECT_NEAR(timestep.getAlpha(), 0.2f, 1e-4f);
+    EXPECT_EQ(timestep.advance(0.1), 2);
+}
+
+TEST(FixedTimestepTest, CapsTicksAfterStall) {
+    FixedTimestep timestep(0.05, 8);
+
+    EXPECT_EQ(timestep.advance(10.0), 8);
+    EXPECT_FLOAT_EQ(timestep.getAlpha(), 0.0f);
+    EXPECT_EQ(timestep.advance(0.05), 1);
+}
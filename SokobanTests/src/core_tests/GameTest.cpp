@@ -79,4 +79,30 @@ TEST_F(GameTest, WinConditionIntegration) {
     game.movePlayer(EFacing::RIGHT);
     EXPECT_EQ(game.getCurrentState(), EGameState::PLAYING);
     EXPECT_EQ(observer.lastEvent, EGameEvent::PLAYER_MOVED);
-}
\ No newline at end of file
+}
+
+TEST_F(GameTest, SeekMoveRestoresAndBranchesHistory) {
+    game.loadLevel(99);
+    game.movePlayer(EFacing::RIGHT);
+    game.movePlayer(EFacing::UP);
+    game.movePlayer(EFacing::LEFT);
+    game.movePlayer(EFacing::DOWN);
+    ASSERT_EQ(game.getHistoryLength(), 4);
+
+    game.seekMove(1);
+    EXPECT_EQ(observer.lastEvent, EGameEvent::HISTORY_SEEKED);
+    EXPECT_EQ(game.getMoveCount(), 1);
+    EXPECT_EQ(game.getPlayerPosition(), Position(1, 2));
+    EXPECT_EQ(game.getBoxPositions()[0], Position(1, 3));
+
+    game.seekMove(0);
+    EXPECT_EQ(game.getBoxPositions()[0], Position(1, 2));
+    game.seekMove(4);
+    EXPECT_EQ(game.getPlayerPosition(), Position(1, 1));
+    EXPECT_EQ(game.getBoxPositions()[0], Position(1, 3));
+
+    game.seekMove(2);
+    game.movePlayer(EFacing::RIGHT);
+    EXPECT_EQ(game.getHistoryLength(), 3);
+    EXPECT_EQ(game.getPlayerPosition(), Position(0, 3));
+}
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "Game.h"
+#include "solver/HintEngine.h"
+#include "solver/SolutionCache.h"
+#include "TestLevels.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+    bool WaitForHint(const HintEngine& engine, Hint& hint) {
+        for (int i = 0; i < 500; ++i) {
+            if (engine.getHint(hint)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    GameMap MakeHintLevel() {
+        return MakeLevel({{2, 2, 2, 2, 2, 2, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 1, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 2, 2, 2, 2, 2, 2}},
+                         Position(2, 1), {Position(2, 3)}, 11);
+    }
+}
+
+TEST(HintEngineTest, SuggestsNextPushAndFollowsPlan) {
+    Game game;
+    game.loadLevel(MakeHintLevel());
+    HintEngine engine;
+
+    engine.request(GameMap::capture(game));
+    Hint hint;
+    ASSERT_TRUE(WaitForHint(engine, hint));
+    ASSERT_TRUE(hint.available);
+    EXPECT_EQ(hint.box, Position(2, 3));
+    EXPECT_EQ(hint.direction, EFacing::RIGHT);
+    EXPECT_EQ(hint.pushesLeft, 2);
+
+    game.movePlayer(EFacing::RIGHT);
+    game.movePlayer(EFacing::RIGHT);
+    engine.request(GameMap::capture(game));
+    ASSERT_TRUE(WaitForHint(engine, hint));
+    EXPECT_EQ(hint.box, Position(2, 4));
+    EXPECT_EQ(hint.pushesLeft, 1);
+}
+
+TEST(HintEngineTest, CancelDropsPendingHint) {
+    Game game;
+    game.loadLevel(MakeHintLevel());
+    HintEngine engine;
+
+    engine.request(GameMap::capture(game));
+    engine.cancel();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Hint hint;
+    EXPECT_FALSE(engine.getHint(hint));
+}
+
+TEST(HintEngineTest, StoresOnlyLevelStartInCache) {
+    std::remove("hint_cache_test.bin");
+    {
+        SolutionCache cache("hint_cache_test.bin");
+        Game game;
+        game.loadLevel(MakeHintLevel());
+        Hint hint;
+        {
+            HintEngine engine;
+            engine.setCache(&cache);
+            game.movePlayer(EFacing::RIGHT);
+            engine.request(GameMap::capture(game));
+            ASSERT_TRUE(WaitForHint(engine, hint));
+            ASSERT_TRUE(hint.available);
+            EXPECT_EQ(cache.size(), 0u);
+        }
+
+        // A new engine has no plan to answer from, so it searches again.
+        HintEngine engine;
+        engine.setCache(&cache);
+        game.restartLevel();
+        engine.request(GameMap::capture(game), true);
+        ASSERT_TRUE(WaitForHint(engine, hint));
+        EXPECT_EQ(cache.size(), 1u);
+        CacheEntry entry;
+        EXPECT_TRUE(cache.lookup(SolutionCache::contentHash(MakeHintLevel()), entry));
+    }
+    std::remove("hint_cache_test.bin");
+}
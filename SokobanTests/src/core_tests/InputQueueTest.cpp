@@ -0,0 +1,58 @@
+#include "pch.h"
+#include "InputQueue.h"
+
+TEST(InputQueueTest, KeepsCommandsInOrder) {
+    InputQueue queue;
+    queue.push(EInputCommand::MOVE_UP);
+    queue.push(EInputCommand::MOVE_UP);
+    queue.push(EInputCommand::RESTART);
+
+    EInputCommand command;
+    ASSERT_TRUE(queue.pop(command));
+    EXPECT_EQ(command, EInputCommand::MOVE_UP);
+    ASSERT_TRUE(queue.pop(command));
+    EXPECT_EQ(command, EInputCommand::MOVE_UP);
+    ASSERT_TRUE(queue.pop(command));
+    EXPECT_EQ(command, EInputCommand::RESTART);
+    EXPECT_FALSE(queue.pop(command));
+}
+
+TEST(InputQueueTest, DropsCommandsWhenFull) {
+    InputQueue queue;
+    for (size_t i = 0; i < InputQueue::Capacity; ++i) {
+        EXPECT_TRUE(queue.push(EInputCommand::MOVE_LEFT));
+    }
+
+    EXPECT_FALSE(queue.push(EInputCommand::MOVE_RIGHT));
+    EXPECT_EQ(queue.size(), InputQueue::Capacity);
+
+    EFacing direction;
+    EXPECT_TRUE(InputQueue::toFacing(EInputCommand::MOVE_LEFT, direction));
+    EXPECT_EQ(direction, EFacing::LEFT);
+    EXPECT_FALSE(InputQueue::toFacing(EInputCommand::NEXT_LEVEL, direction));
+}
+
+TEST(InputQueueTest, KeepsOrderAfterOverflowAndWrap) {
+    InputQueue queue;
+    EInputCommand command;
+    // Move the head off zero so the buffer has to wrap around.
+    queue.push(EInputCommand::RESTART);
+    ASSERT_TRUE(queue.pop(command));
+
+    for (size_t i = 0; i < InputQueue::Capacity; ++i) {
+        ASSERT_TRUE(queue.push(i % 2 == 0 ? EInputCommand::MOVE_UP : EInputCommand::MOVE_DOWN));
+    }
+    EXPECT_FALSE(queue.push(EInputCommand::NEXT_LEVEL));
+
+    ASSERT_TRUE(queue.pop(command));
+    EXPECT_EQ(command, EInputCommand::MOVE_UP);
+    EXPECT_TRUE(queue.push(EInputCommand::NEXT_LEVEL));
+
+    for (size_t i = 1; i < InputQueue::Capacity; ++i) {
+        ASSERT_TRUE(queue.pop(command));
+        EXPECT_EQ(command, i % 2 == 0 ? EInputCommand::MOVE_UP : EInputCommand::MOVE_DOWN);
+    }
+    ASSERT_TRUE(queue.pop(command));
+    EXPECT_EQ(command, EInputCommand::NEXT_LEVEL);
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,87 @@
+#include "pch.h"
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include "LevelIndex.h"
+
+namespace {
+    void WritePack(const std::string& filename, const std::string& secondLevel) {
+        std::ofstream file(filename);
+        file << R"({"name": "pack {with} \"braces\"", "levels": [
+            {"id": 1, "width": 3, "height": 1, "grid": [[0, 0, 1]],
+             "playerStart": {"row": 0, "col": 0}, "boxPositions": [{"row": 0, "col": 1}]},
+            )" << secondLevel << R"(
+        ]})";
+    }
+}
+
+TEST(LevelIndexTest, ParsesOnlyRequestedLevels) {
+    WritePack("level_index_test.json", R"({"id": 2, "width": -1, "height": 1})");
+    LevelIndex index("level_index_test.json");
+
+    GameMap first = index.get(1);
+
+    EXPECT_EQ(index.count(), 2u);
+    EXPECT_EQ(first.getWidth(), 3);
+    EXPECT_EQ(first.getTileAt(0, 2), ETileType::TARGET);
+    EXPECT_THROW(index.get(2), std::runtime_error);
+    EXPECT_THROW(index.get(3), std::runtime_error);
+    std::remove("level_index_test.json");
+}
+
+TEST(LevelIndexTest, RereadsChangedFile) {
+    WritePack("level_index_test.json", R"({"id": 2, "width": -1, "height": 1})");
+    LevelIndex index("level_index_test.json");
+    EXPECT_THROW(index.get(2), std::runtime_error);
+
+    WritePack("level_index_test.json",
+              R"({"id": 2, "width": 2, "height": 1, "grid": [[0, 1]],
+                  "playerStart": {"row": 0, "col": 0}, "boxPositions": []})");
+    index.prefetch(2);
+
+    EXPECT_EQ(index.get(2).getWidth(), 2);
+    std::remove("level_index_test.json");
+}
+
+TEST(LevelIndexTest, ReloadReparsesOnlyEditedLevels) {
+    const std::string secondLevel = R"({"id": 2, "width": 2, "height": 1, "grid": [[0, 1]],
+        "playerStart": {"row": 0, "col": 0}, "boxPositions": []})";
+    WritePack("level_index_reload.json", secondLevel);
+    LevelIndex index("level_index_reload.json");
+    index.get(2);
+
+    WritePack("level_index_reload.json", R"({"id": 2, "width": 3, "height": 1, "grid": [[0, 0, 1]],
+        "playerStart": {"row": 0, "col": 0}, "boxPositions": []})");
+    std::vector<int> changed = index.reload();
+
+    EXPECT_EQ(changed, std::vector<int>{2});
+    EXPECT_EQ(index.getRevision(1), 0u);
+    EXPECT_GT(index.getRevision(2), 0u);
+    EXPECT_EQ(index.get(2).getWidth(), 3);
+    EXPECT_TRUE(index.reload().empty());
+
+    // A save caught halfway keeps the last good version.
+    std::ofstream("level_index_reload.json") << R"({"levels": [{"id": 1, "width": )";
+    EXPECT_TRUE(index.reload().empty());
+    EXPECT_EQ(index.get(1).getWidth(), 3);
+    std::remove("level_index_reload.json");
+}
+
+TEST(LevelIndexTest, WatcherPicksUpSavedEdits) {
+    WritePack("level_index_watch.json", R"({"id": 2, "width": -1, "height": 1})");
+    LevelIndex index("level_index_watch.json");
+    EXPECT_EQ(index.count(), 2u);
+    index.startWatching();
+
+    WritePack("level_index_watch.json", R"({"id": 2, "width": 2, "height": 1, "grid": [[0, 1]],
+        "playerStart": {"row": 0, "col": 0}, "boxPositions": []})");
+    for (int i = 0; i < 300 && index.getRevision(2) == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    index.stopWatching();
+
+    EXPECT_GT(index.getRevision(2), 0u);
+    EXPECT_EQ(index.get(2).getWidth(), 2);
+    std::remove("level_index_watch.json");
+}
@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "MoveHistory.h"
+
+TEST(MoveHistoryTest, RestoresNearestCheckpoint) {
+    MoveHistory history(4);
+    history.reset(10, Position(1, 1), {Position(2, 2)});
+    for (int move = 1; move <= 10; ++move) {
+        if (history.record(EFacing::RIGHT, move == 3)) {
+            history.addCheckpoint(Position(1, 1 + move), {Position(2, 2 + move)});
+        }
+    }
+
+    Position player(0, 0);
+    std::vector<Position> boxes;
+    EXPECT_EQ(history.size(), 10);
+    EXPECT_EQ(history.getCheckpointCount(), 3u);
+    EXPECT_EQ(history.restore(7, player, boxes), 4);
+    EXPECT_EQ(player, Position(1, 5));
+    ASSERT_EQ(boxes.size(), 1u);
+    EXPECT_EQ(boxes[0], Position(2, 6));
+    EXPECT_EQ(history.restore(10, player, boxes), 8);
+    EXPECT_TRUE(history.isPush(2));
+    EXPECT_EQ(history.getDirection(2), EFacing::RIGHT);
+}
+
+TEST(MoveHistoryTest, TruncateDropsLaterCheckpoints) {
+    MoveHistory history(4);
+    history.reset(10, Position(1, 1), {});
+    for (int move = 1; move <= 10; ++move) {
+        if (history.record(EFacing::DOWN, false)) {
+            history.addCheckpoint(Position(1 + move, 1), {});
+        }
+    }
+
+    history.truncate(5);
+
+    Position player(0, 0);
+    std::vector<Position> boxes;
+    EXPECT_EQ(history.size(), 5);
+    EXPECT_EQ(history.getCheckpointCount(), 2u);
+    EXPECT_EQ(history.restore(5, player, boxes), 4);
+    EXPECT_EQ(player, Position(5, 1));
+}
+
+TEST(MoveHistoryTest, StoresCellsBeyondSixteenBits) {
+    MoveHistory history(1);
+    history.reset(1000, Position(900, 999), {Position(950, 3)});
+    history.record(EFacing::UP, false);
+    history.addCheckpoint(Position(899, 999), {Position(950, 3)});
+
+    Position player(0, 0);
+    std::vector<Position> boxes;
+    EXPECT_EQ(history.restore(0, player, boxes), 0);
+    EXPECT_EQ(player, Position(900, 999));
+    ASSERT_EQ(boxes.size(), 1u);
+    EXPECT_EQ(boxes[0], Position(950, 3));
+    EXPECT_EQ(history.restore(1, player, boxes), 1);
+    EXPECT_EQ(player, Position(899, 999));
+}
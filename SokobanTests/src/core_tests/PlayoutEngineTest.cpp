@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "solver/PlayoutEngine.h"
+#include "TestLevels.h"
+
+
+TEST(PlayoutEngineTest, CorridorIsSolvedByEveryPlayout) {
+    GameMap map = MakeLevel({{2, 2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 1, 2},
+                             {2, 2, 2, 2, 2, 2}},
+                            Position(1, 1), {Position(1, 2)});
+    PlayoutEngine engine(map);
+    PlayoutOptions options;
+    options.playouts = 1000;
+    options.threads = 2;
+
+    PlayoutResult result = engine.run(options);
+    EXPECT_EQ(result.playouts, 1000u);
+    EXPECT_EQ(result.solved, 1000u);
+    EXPECT_EQ(result.stuck, 0u);
+    EXPECT_DOUBLE_EQ(result.meanPushes(), 2.0);
+    EXPECT_DOUBLE_EQ(result.reachedFraction(1), 1.0);
+}
+
+TEST(PlayoutEngineTest, CorneredBoxNeverReachesTarget) {
+    GameMap map = MakeLevel({{2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 2},
+                             {2, 0, 0, 1, 2},
+                             {2, 2, 2, 2, 2}},
+                            Position(2, 2), {Position(1, 1)});
+    PlayoutEngine engine(map);
+    PlayoutOptions options;
+    options.playouts = 500;
+
+    PlayoutResult result = engine.run(options);
+    EXPECT_EQ(result.solved, 0u);
+    EXPECT_EQ(result.stuck, 500u);
+    EXPECT_EQ(result.bestOnTarget, 0);
+    EXPECT_DOUBLE_EQ(result.reachedFraction(0), 1.0);
+}
+
+TEST(PlayoutEngineTest, TreeSearchSolvesOpenRoom) {
+    GameMap map = MakeLevel({{2, 2, 2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 0, 0, 2},
+                             {2, 0, 0, 0, 0, 1, 2},
+                             {2, 0, 0, 0, 0, 1, 2},
+                             {2, 2, 2, 2, 2, 2, 2}},
+                            Position(2, 1), {Position(2, 3), Position(3, 2)});
+    PlayoutEngine engine(map);
+    PlayoutOptions options;
+    options.playouts = 2000;
+    options.threads = 1;
+    options.mcts = true;
+
+    PlayoutResult result = engine.run(options);
+    EXPECT_EQ(result.playouts, 2000u);
+    EXPECT_GT(result.solved, 0u);
+    EXPECT_EQ(result.bestOnTarget, 2);
+    EXPECT_EQ(result.reachedTargets[2], result.solved);
+}
@@ -0,0 +1,138 @@
+#include "pch.h"
+#include <cstdio>
+#include <filesystem>
+#include "replay/ReplayReader.h"
+#include "replay/ReplayWriter.h"
+#include "solver/Lurd.h"
+#include "solver/SolutionCache.h"
+#include "TestLevels.h"
+
+namespace {
+    GameMap MakeReplayLevel() {
+        return MakeLevel({{2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+                          {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2},
+                          {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                          {2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2}},
+                         Position(1, 1), {Position(1, 3)}, 9);
+    }
+
+    // Walks around the level without touching the box, length steps long.
+    std::string MakeWalk(size_t length) {
+        std::string walk;
+        const char* loop = "ddrruull";
+        for (size_t i = 0; i < length; ++i) {
+            walk += loop[i % 8];
+        }
+        return walk;
+    }
+}
+
+TEST(ReplayTest, RoundTripsMovesAndRestoresPushes) {
+    GameMap map = MakeReplayLevel();
+    uint64_t hash = SolutionCache::contentHash(map);
+    // Mixed steps are packed, long runs and short runs are run-length coded.
+    const std::vector<std::string> sessions = {"rRRR", "rRdrruLL", "ddrrrrrrrrruullllllLL", "", "ddrrrruurrrrddllll"};
+    {
+        ReplayWriter writer("replay_test.bin");
+        for (const auto& session : sessions) {
+            writer.add(hash, 9, session);
+        }
+        EXPECT_THROW(writer.add(hash, 9, "rx"), std::runtime_error);
+        writer.finish();
+        EXPECT_EQ(writer.getCount(), sessions.size());
+        EXPECT_EQ(writer.getBytesWritten(), std::filesystem::file_size("replay_test.bin"));
+    }
+
+    ReplayReader reader("replay_test.bin");
+    ASSERT_EQ(reader.size(), sessions.size());
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        ReplayInfo info = reader.get(i);
+        EXPECT_EQ(info.levelHash, hash);
+        EXPECT_EQ(info.levelId, 9);
+        EXPECT_EQ(info.moves, sessions[i].size());
+        EXPECT_EQ(info.pushes, static_cast<uint32_t>(Lurd::countPushes(sessions[i])));
+        std::string lurd = reader.decode(info);
+        ASSERT_TRUE(ReplayCodec::restorePushes(map, lurd));
+        EXPECT_EQ(lurd, sessions[i]);
+    }
+    EXPECT_EQ(reader.get(2).encoding, ReplayFormat::RunLength);
+    EXPECT_EQ(reader.get(1).encoding, ReplayFormat::Packed);
+    EXPECT_EQ(reader.get(4).encoding, ReplayFormat::ShortRuns);
+
+    std::string blocked = "uu";
+    EXPECT_FALSE(ReplayCodec::restorePushes(map, blocked));
+    std::remove("replay_test.bin");
+}
+
+TEST(ReplayTest, RestorePushesRejectsMovesAfterSolveOnAnyBoardSize) {
+    // The wide board is beyond the largest BoardKernel, so it goes through Game.
+    for (int width : {6, 70}) {
+        std::vector<std::vector<int>> grid(3, std::vector<int>(width, 2));
+        for (int col = 1; col < width - 1; ++col) {
+            grid[1][col] = 0;
+        }
+        grid[1][4] = 1;
+        GameMap map = MakeLevel(grid, Position(1, 1), {Position(1, 2)});
+
+        std::string solution = "rr";
+        EXPECT_TRUE(ReplayCodec::restorePushes(map, solution)) << width;
+        EXPECT_EQ(solution, "RR") << width;
+
+        std::string walkedOn = "rrl";
+        EXPECT_FALSE(ReplayCodec::restorePushes(map, walkedOn)) << width;
+    }
+}
+
+TEST(ReplayTest, SeeksAnyRecordThroughTheBlockIndex) {
+    const size_t count = 3 * ReplayFormat::RecordsPerBlock + 5;
+    {
+        ReplayWriter writer("replay_seek.bin");
+        for (size_t i = 0; i < count; ++i) {
+            writer.add(1000 + i % 3, static_cast<int>(i % 3) - 1, MakeWalk(i));
+        }
+    }
+
+    ReplayReader reader("replay_seek.bin");
+    ASSERT_EQ(reader.size(), count);
+    for (size_t index : {size_t(0), size_t(63), size_t(64), size_t(130), count - 1}) {
+        ReplayInfo info = reader.get(index);
+        EXPECT_EQ(reader.decode(info), MakeWalk(index));
+        EXPECT_EQ(info.levelHash, 1000 + index % 3);
+        EXPECT_EQ(info.levelId, static_cast<int>(index % 3) - 1);
+    }
+
+    size_t visited = 0;
+    reader.forEach(60, 70, [&](size_t index, const ReplayInfo& info) {
+        EXPECT_EQ(info.moves, index);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 10u);
+    EXPECT_THROW(reader.get(count), std::out_of_range);
+    std::remove("replay_seek.bin");
+}
+
+TEST(ReplayTest, RejectsUnfinishedAndCorruptArchives) {
+    {
+        ReplayWriter writer("replay_corrupt.bin");
+        writer.add(7, 1, MakeWalk(40));
+        writer.add(7, 1, MakeWalk(41));
+    }
+    std::string data;
+    {
+        std::ifstream file("replay_corrupt.bin", std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Cut before the footer, as if the writer had crashed.
+    std::ofstream("replay_corrupt.bin", std::ios::binary | std::ios::trunc).write(data.data(), data.size() - 4);
+    EXPECT_THROW(ReplayReader("replay_corrupt.bin"), std::runtime_error);
+
+    // A record claiming more moves than its payload holds.
+    std::string damaged = data;
+    damaged[ReplayFormat::HeaderSize + 1] = 120;
+    std::ofstream("replay_corrupt.bin", std::ios::binary | std::ios::trunc).write(damaged.data(), damaged.size());
+    ReplayReader reader("replay_corrupt.bin");
+    EXPECT_THROW(reader.get(0), std::runtime_error);
+    std::remove("replay_corrupt.bin");
+}
@@ -0,0 +1,83 @@
+#include "pch.h"
+#include <cstdio>
+#include "solver/Lurd.h"
+#include "solver/SolutionCache.h"
+#include "solver/Solver.h"
+#include "TestLevels.h"
+
+namespace {
+    const std::vector<std::vector<int>> CacheGrid = {{2, 2, 2, 2, 2, 2},
+                                                     {2, 0, 0, 0, 1, 2},
+                                                     {2, 2, 2, 2, 2, 2}};
+}
+
+TEST(SolutionCacheTest, HashIgnoresIdButNotContent) {
+    GameMap original = MakeLevel(CacheGrid, Position(1, 1), {Position(1, 2)}, 13);
+    GameMap renumbered = MakeLevel(CacheGrid, Position(1, 1), {Position(1, 2)}, 99);
+    GameMap edited = MakeLevel(CacheGrid, Position(1, 1), {Position(1, 3)}, 99);
+
+    EXPECT_EQ(SolutionCache::contentHash(original), SolutionCache::contentHash(renumbered));
+    EXPECT_NE(SolutionCache::contentHash(original), SolutionCache::contentHash(edited));
+}
+
+TEST(SolutionCacheTest, SolverReusesPersistedSolution) {
+    std::remove("solution_cache_test.bin");
+    GameMap map = MakeLevel(CacheGrid, Position(1, 1), {Position(1, 2)}, 13);
+
+    SolverResult first;
+    {
+        SolutionCache cache("solution_cache_test.bin");
+        SolverOptions options;
+        options.cache = &cache;
+        first = Solver(map).solve(options);
+    }
+
+    SolutionCache reopened("solution_cache_test.bin");
+    SolverOptions options;
+    options.cache = &reopened;
+    SolverResult second = Solver(map).solve(options);
+
+    ASSERT_TRUE(first.solved);
+    EXPECT_FALSE(first.fromCache);
+    ASSERT_TRUE(second.fromCache);
+    EXPECT_EQ(second.solution, first.solution);
+    EXPECT_EQ(second.pushes, first.pushes);
+    EXPECT_GT(second.nodesExpanded, 0u);
+    EXPECT_EQ(second.nodesExpanded, first.nodesExpanded);
+    EXPECT_EQ(second.nodesGenerated, first.nodesGenerated);
+
+    CacheEntry entry;
+    ASSERT_TRUE(reopened.lookup(SolutionCache::contentHash(map), entry));
+    EXPECT_TRUE(entry.has(CacheEntry::Optimal));
+    EXPECT_EQ(entry.lowerBound, 2);
+    EXPECT_EQ(entry.deadSquares.size(), 18u);
+    std::remove("solution_cache_test.bin");
+}
+
+TEST(SolutionCacheTest, DropsTornRecordOnOpen) {
+    std::remove("solution_cache_torn.bin");
+    CacheEntry entry;
+    entry.flags = CacheEntry::Solved;
+    entry.solution = "rRR";
+    {
+        SolutionCache cache("solution_cache_torn.bin");
+        cache.store(1, entry);
+    }
+    {
+        std::ofstream file("solution_cache_torn.bin", std::ios::binary | std::ios::app);
+        file.write("\0\0\0\x40partial", 11);
+    }
+
+    SolutionCache cache("solution_cache_torn.bin");
+    entry.solution = "RR";
+    cache.store(2, entry);
+    SolutionCache reopened("solution_cache_torn.bin");
+
+    CacheEntry found;
+    EXPECT_EQ(reopened.size(), 2u);
+    ASSERT_TRUE(reopened.lookup(1, found));
+    EXPECT_EQ(found.solution, "rRR");
+    ASSERT_TRUE(reopened.lookup(2, found));
+    EXPECT_EQ(found.solution, "RR");
+    std::remove("solution_cache_torn.bin");
+}
@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "solver/Lurd.h"
+#include "solver/SolutionOptimizer.h"
+#include "TestLevels.h"
+
+namespace {
+    GameMap MakeRoomLevel() {
+        return MakeLevel({{2, 2, 2, 2, 2, 2, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 1, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 2, 2, 2, 2, 2, 2}},
+                         Position(3, 1), {Position(3, 3)}, 12);
+    }
+}
+
+TEST(SolutionOptimizerTest, RemovesPushCycles) {
+    GameMap map = MakeRoomLevel();
+    // Pushes the box right, walks round it, pushes it back and starts over.
+    std::string solution = "udrRurrdLdlluRR";
+    ASSERT_TRUE(Lurd::verify(map, solution));
+
+    OptimizationResult result = SolutionOptimizer(map).optimize(solution);
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.solution, "rRR");
+    EXPECT_EQ(result.pushes, 2);
+    EXPECT_GT(result.cyclesRemoved, 0);
+    EXPECT_TRUE(Lurd::verify(map, result.solution));
+}
+
+TEST(SolutionOptimizerTest, ResearchesDetourWindow) {
+    GameMap map = MakeRoomLevel();
+    // Takes the box up, across and back down instead of straight across.
+    std::string solution = "drrUluRurDldR";
+    ASSERT_TRUE(Lurd::verify(map, solution));
+
+    OptimizationResult result = SolutionOptimizer(map).optimize(solution);
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.originalPushes, 4);
+    EXPECT_EQ(result.pushes, 2);
+    EXPECT_EQ(result.moves, 3);
+    EXPECT_GT(result.windowsImproved, 0);
+}
+
+TEST(SolutionOptimizerTest, RejectsInvalidSolution) {
+    GameMap map = MakeRoomLevel();
+
+    OptimizationResult result = SolutionOptimizer(map).optimize("rR");
+
+    EXPECT_FALSE(result.valid);
+    EXPECT_EQ(result.solution, "rR");
+}
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "solver/Solver.h"
+#include "solver/LevelValidator.h"
+#include "solver/Lurd.h"
+#include "TestLevels.h"
+
+namespace {
+    const std::vector<std::vector<int>> CorridorGrid = {{2, 2, 2, 2, 2, 2},
+                                                        {2, 0, 0, 0, 1, 2},
+                                                        {2, 2, 2, 2, 2, 2}};
+
+    // Two boxes, two targets and a pillar in the middle of the room.
+    const std::vector<std::vector<int>> PillarGrid = {{2, 2, 2, 2, 2, 2, 2},
+                                                      {2, 0, 0, 0, 0, 0, 2},
+                                                      {2, 0, 0, 0, 0, 0, 2},
+                                                      {2, 0, 0, 2, 0, 0, 2},
+                                                      {2, 1, 0, 0, 0, 1, 2},
+                                                      {2, 2, 2, 2, 2, 2, 2}};
+}
+
+TEST(SolverTest, FindsPushOptimalSolution) {
+    GameMap map = MakeLevel(CorridorGrid, Position(1, 1), {Position(1, 2)}, 7);
+
+    Solver solver(map);
+    SolverResult result = solver.solve();
+
+    ASSERT_TRUE(result.solved);
+    EXPECT_EQ(result.solution, "RR");
+    EXPECT_EQ(result.pushes, 2);
+    EXPECT_TRUE(Lurd::verify(map, result.solution));
+}
+
+TEST(SolverTest, ReportsUnsolvableLevel) {
+    GameMap map = MakeLevel(CorridorGrid, Position(1, 3), {Position(1, 2)}, 7);
+
+    SolverResult result = Solver(map).solve();
+
+    EXPECT_FALSE(result.solved);
+    EXPECT_TRUE(result.exhausted);
+}
+
+TEST(SolverTest, VerifyRejectsMiscasedSteps) {
+    GameMap map = MakeLevel(CorridorGrid, Position(1, 1), {Position(1, 3)}, 7);
+
+    EXPECT_TRUE(Lurd::verify(map, "rR"));
+    EXPECT_FALSE(Lurd::verify(map, "rr"));
+    EXPECT_FALSE(Lurd::verify(map, "RR"));
+}
+
+TEST(SolverTest, ValidatorRejectsMismatchedBoxCount) {
+    GameMap map = MakeLevel(CorridorGrid, Position(1, 1), {Position(1, 2), Position(1, 3)}, 7);
+
+    ValidationReport report = LevelValidator::validate(map);
+
+    EXPECT_FALSE(report.isValid());
+}
+
+TEST(SolverTest, TunnelMacrosCollapseCorridorPushes) {
+    GameMap map = MakeLevel({{2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 2, 2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 0, 0, 0, 0, 1, 2},
+                             {2, 0, 0, 0, 2, 2, 2, 2, 2, 2},
+                             {2, 2, 2, 2, 2, 2, 2, 2, 2, 2}},
+                            Position(1, 1), {Position(2, 2)}, 8);
+
+    SolverOptions plain;
+    plain.useTunnelMacros = false;
+    SolverResult withoutMacros = Solver(map).solve(plain);
+    SolverResult withMacros = Solver(map).solve();
+
+    ASSERT_TRUE(withMacros.solved);
+    EXPECT_GT(withMacros.macroPushes, 0u);
+    EXPECT_LT(withMacros.nodesExpanded, withoutMacros.nodesExpanded);
+    EXPECT_EQ(withMacros.pushes, withoutMacros.pushes);
+    EXPECT_TRUE(Lurd::verify(map, withMacros.solution));
+}
+
+TEST(SolverTest, BidirectionalSearchReplaysThroughGame) {
+    GameMap map = MakeLevel(PillarGrid, Position(1, 1), {Position(2, 2), Position(2, 4)}, 9);
+
+    SolverOptions options;
+    options.bidirectional = true;
+    SolverResult result = Solver(map).solve(options);
+
+    ASSERT_TRUE(result.solved);
+    EXPECT_EQ(result.pushes, Lurd::countPushes(result.solution));
+    EXPECT_TRUE(Lurd::verify(map, result.solution));
+}
+
+TEST(SolverTest, BidirectionalSearchHandlesSpareTarget) {
+    // The spare target sits in a pocket a box can never be pulled out of.
+    GameMap map = MakeLevel({{2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+                             {2, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+                             {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+                             {2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2},
+                             {2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2}},
+                            Position(2, 2), {Position(3, 3), Position(4, 4)}, 10);
+
+    SolverOptions options;
+    options.bidirectional = true;
+    SolverResult result = Solver(map).solve(options);
+
+    ASSERT_TRUE(result.solved);
+    EXPECT_TRUE(Lurd::verify(map, result.solution));
+}
+
+TEST(SolverTest, ExternalSearchResumesFromCheckpoint) {
+    GameMap map = MakeLevel(PillarGrid, Position(1, 1), {Position(2, 2), Position(2, 4)}, 10);
+
+    SolverOptions options;
+    options.spillDirectory = "solver_spill_test";
+    options.memoryBudgetBytes = 256;
+    options.maxNodes = 20;
+    SolverResult interrupted = Solver(map).solve(options);
+    EXPECT_FALSE(interrupted.solved);
+    EXPECT_TRUE(std::ifstream("solver_spill_test/checkpoint.json").good());
+
+    options.maxNodes = 100000;
+    SolverResult resumed = Solver(map).solve(options);
+    SolverResult optimal = Solver(map).solve();
+
+    ASSERT_TRUE(resumed.solved);
+    EXPECT_EQ(resumed.pushes, optimal.pushes);
+    EXPECT_GT(resumed.bytesSpilled, 0u);
+    EXPECT_TRUE(Lurd::verify(map, resumed.solution));
+    EXPECT_FALSE(std::ifstream("solver_spill_test/checkpoint.json").good());
+}
@@ -0,0 +1,168 @@
+#include "pch.h"
+#ifndef _WIN32
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Game.h"
+#include "spectator/SpectatorGame.h"
+#include "spectator/SpectatorPublisher.h"
+#include "TestLevels.h"
+
+namespace {
+    GameMap MakeSpectatorLevel() {
+        return MakeLevel({{2, 2, 2, 2, 2, 2, 2},
+                          {2, 0, 0, 0, 0, 1, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 0, 0, 0, 0, 0, 2},
+                          {2, 2, 2, 2, 2, 2, 2}},
+                         Position(2, 1), {Position(1, 3)}, 21);
+    }
+
+    class EventCounter : public IGameObserver {
+    public:
+        void onNotify(EGameEvent event) override { ++counts[static_cast<int>(event)]; }
+        int count(EGameEvent event) const { return counts[static_cast<int>(event)]; }
+
+    private:
+        int counts[8] = {};
+    };
+
+    bool WaitFor(SpectatorGame& spectator, const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            spectator.receive();
+            if (done()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return false;
+    }
+
+    // Reads the raw stream of a publisher until it holds expected bytes or
+    // five seconds have passed.
+    std::vector<uint8_t> ReadStream(const char* socketPath, const std::function<bool(const std::vector<uint8_t>&)>& done) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, socketPath);
+        int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        std::vector<uint8_t> stream;
+        if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(socket);
+            return stream;
+        }
+        uint8_t buffer[4096];
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done(stream) && std::chrono::steady_clock::now() < deadline) {
+            ssize_t count = ::recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (count > 0) {
+                stream.insert(stream.end(), buffer, buffer + count);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        ::close(socket);
+        return stream;
+    }
+}
+
+TEST(SpectatorTest, LateViewerFollowsKeyframeAndMoves) {
+    Game game;
+    game.loadLevel(MakeSpectatorLevel());
+    SpectatorPublisher publisher(&game, "spectator_test.sock");
+    game.addObserver(&publisher);
+
+    game.movePlayer(EFacing::UP);
+    game.movePlayer(EFacing::RIGHT);
+
+    // Joins after the keyframe and the first moves were sent.
+    SpectatorGame spectator;
+    EventCounter events;
+    spectator.addObserver(&events);
+    spectator.connect("spectator_test.sock");
+    ASSERT_TRUE(WaitFor(spectator, [&]() { return spectator.getMoveCount() == 2; }));
+    EXPECT_EQ(spectator.getLevelId(), 21);
+    EXPECT_EQ(spectator.getLevelWidth(), 7);
+    EXPECT_EQ(spectator.getTileAt(Position(1, 5)), ETileType::TARGET);
+    EXPECT_EQ(spectator.getPlayerPosition(), Position(1, 2));
+
+    game.movePlayer(EFacing::RIGHT);
+    game.movePlayer(EFacing::RIGHT);
+    ASSERT_TRUE(WaitFor(spectator, [&]() { return spectator.getMoveCount() == 4; }));
+    EXPECT_EQ(spectator.getBoxPositions(), game.getBoxPositions());
+    EXPECT_EQ(spectator.getPlayerPosition(), game.getPlayerPosition());
+    EXPECT_EQ(spectator.getCurrentState(), EGameState::LEVEL_COMPLETED);
+    EXPECT_EQ(events.count(EGameEvent::BOX_MOVED), 2);
+    EXPECT_EQ(events.count(EGameEvent::LEVEL_WON), 1);
+
+    game.restartLevel();
+    ASSERT_TRUE(WaitFor(spectator, [&]() { return spectator.getMoveCount() == 0; }));
+    EXPECT_EQ(spectator.getBoxPositions(), game.getBoxPositions());
+    EXPECT_EQ(publisher.getSubscriberCount(), 1u);
+    game.removeObserver(&publisher);
+}
+
+TEST(SpectatorTest, AppliesStreamSplitAtAnyByte) {
+    Game game;
+    game.loadLevel(MakeSpectatorLevel());
+    SpectatorPublisher publisher(&game, "spectator_split.sock");
+    game.addObserver(&publisher);
+    game.movePlayer(EFacing::UP);
+    game.movePlayer(EFacing::RIGHT);
+    game.movePlayer(EFacing::RIGHT);
+
+    // Reads the raw stream, then feeds it one byte at a time.
+    // Keyframe with 35 tiles and one box, then a byte per move.
+    const size_t expected = SpectatorFormat::KeyframeHeaderSize + SpectatorFormat::KeyframeFixedSize + 35 + 4 + 3;
+    std::vector<uint8_t> stream = ReadStream(
+        "spectator_split.sock", [&](const std::vector<uint8_t>& received) { return received.size() >= expected; });
+    game.removeObserver(&publisher);
+    ASSERT_EQ(stream.size(), expected);
+
+    SpectatorGame spectator;
+    for (uint8_t byte : stream) {
+        spectator.feed(&byte, 1);
+    }
+    EXPECT_TRUE(spectator.hasKeyframe());
+    EXPECT_EQ(spectator.getMoveCount(), 3);
+    EXPECT_EQ(spectator.getBoxPositions(), game.getBoxPositions());
+    EXPECT_EQ(spectator.getPlayerPosition(), game.getPlayerPosition());
+
+    const uint8_t garbage[] = {0x01, 0x02};
+    EXPECT_THROW(spectator.feed(garbage, sizeof(garbage)), std::runtime_error);
+}
+
+TEST(SpectatorTest, LongSessionKeepsLateViewerBacklogSmall) {
+    Game game;
+    game.loadLevel(MakeSpectatorLevel());
+    SpectatorPublisher publisher(&game, "spectator_long.sock");
+    game.addObserver(&publisher);
+    for (int i = 0; i < 1000; ++i) {
+        game.movePlayer(i % 2 == 0 ? EFacing::DOWN : EFacing::UP);
+    }
+
+    // Once a first viewer has every move, the sender has taken them all.
+    SpectatorGame first;
+    first.connect("spectator_long.sock");
+    ASSERT_TRUE(WaitFor(first, [&]() { return first.getMoveCount() == 1000; }));
+
+    SpectatorGame spectator;
+    std::vector<uint8_t> stream = ReadStream("spectator_long.sock", [&](const std::vector<uint8_t>& received) {
+        SpectatorGame replica;
+        replica.feed(received.data(), received.size());
+        return replica.getMoveCount() == game.getMoveCount();
+    });
+    game.removeObserver(&publisher);
+    spectator.feed(stream.data(), stream.size());
+
+    // At most one keyframe plus as many moves as it has bytes.
+    const size_t keyframe = SpectatorFormat::KeyframeHeaderSize + SpectatorFormat::KeyframeFixedSize + 35 + 4;
+    EXPECT_LE(stream.size(), 2 * keyframe);
+    EXPECT_EQ(spectator.getMoveCount(), 1000);
+    EXPECT_EQ(spectator.getPlayerPosition(), game.getPlayerPosition());
+}
+
+#endif
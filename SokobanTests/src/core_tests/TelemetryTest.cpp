@@ -0,0 +1,65 @@
+#include "pch.h"
+#include <cstdio>
+#include "Game.h"
+#include "telemetry/TelemetryReader.h"
+#include "telemetry/TelemetryRecorder.h"
+#include "TestLevels.h"
+
+namespace {
+    GameMap MakeTelemetryLevel() {
+        return MakeLevel({{2, 2, 2, 2, 2, 2},
+                          {2, 0, 0, 0, 1, 2},
+                          {2, 2, 2, 2, 2, 2}},
+                         Position(1, 1), {Position(1, 2)}, 14);
+    }
+}
+
+TEST(TelemetryTest, RecordsGameEventsToDecodableFile) {
+    std::remove("telemetry_test.bin");
+    uint64_t recorded;
+    {
+        TelemetryRecorder recorder("telemetry_test.bin", 64, 5);
+        Game game;
+        game.setTelemetry(&recorder);
+        game.loadLevel(MakeTelemetryLevel());
+        game.movePlayer(EFacing::RIGHT);
+        game.movePlayer(EFacing::RIGHT);
+        recorded = recorder.getRecordedCount();
+        EXPECT_EQ(recorder.getDroppedCount(), 0u);
+    }
+
+    TelemetryLog log = TelemetryReader::read("telemetry_test.bin");
+
+    ASSERT_EQ(log.events.size(), recorded);
+    ASSERT_EQ(log.events.size(), 6u);
+    EXPECT_FALSE(log.truncated);
+    EXPECT_STREQ(TelemetryReader::eventName(log.events[0].type), "LEVEL_RELOADED");
+    EXPECT_STREQ(TelemetryReader::eventName(log.events[1].type), "BOX_MOVED");
+    EXPECT_EQ(log.events[1].boxCol, 3);
+    EXPECT_EQ(log.events[1].moveCount, 1u);
+    EXPECT_EQ(log.events[2].moveCount, 1u);
+    EXPECT_EQ(log.events[2].playerCol, 2);
+    EXPECT_EQ(log.events[2].boxRow, -1);
+    EXPECT_STREQ(TelemetryReader::eventName(log.events.back().type), "LEVEL_WON");
+    EXPECT_EQ(log.events.back().level, 14);
+    EXPECT_LE(log.events[1].timestampNs, log.events.back().timestampNs);
+    std::remove("telemetry_test.bin");
+}
+
+TEST(TelemetryTest, DropsEventsWhenRingIsFull) {
+    std::remove("telemetry_full.bin");
+    {
+        // A long flush interval keeps the flusher from draining mid-test.
+        TelemetryRecorder recorder("telemetry_full.bin", 4, 60000);
+        for (int i = 0; i < 10; ++i) {
+            recorder.record(EGameEvent::PLAYER_MOVED, 1, i, Position(1, i), Position(-1, -1));
+        }
+        EXPECT_EQ(recorder.getRecordedCount(), 10u);
+        EXPECT_EQ(recorder.getDroppedCount(), 6u);
+    }
+
+    TelemetryLog log = TelemetryReader::read("telemetry_full.bin");
+    ASSERT_EQ(log.events.size(), 4u);
+    EXPECT_EQ(log.events[3].playerCol, 3);
+    std::remove("telemetry_full.bin");
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include <cstring>
+#include "Game.h"
+#include "TerminalScreen.h"
+#include "Terminal_View.h"
+#include "TestLevels.h"
+
+namespace {
+    // Plays escape sequences onto a grid of characters the way a terminal
+    // would, counting the cursor addresses it was sent.
+    class FakeTerminal {
+    public:
+        FakeTerminal(int columns, int rows)
+            : _columns(columns), _lines(rows, std::string(columns, ' ')) {}
+
+        void write(const std::string& bytes) {
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                if (bytes[i] != '\x1b') {
+                    if (_col >= _columns) {
+                        ++pastLastColumn;
+                    } else {
+                        _lines[_row][_col] = bytes[i];
+                    }
+                    ++_col;
+                    continue;
+                }
+                // CSI: parameters up to a final byte in '@'..'~'.
+                size_t end = i + 2;
+                while (end < bytes.size() && (bytes[end] < '@' || bytes[end] > '~')) {
+                    ++end;
+                }
+                std::string parameters = bytes.substr(i + 2, end - i - 2);
+                if (bytes[end] == 'H') {
+                    int row = 1;
+                    int col = 1;
+                    std::sscanf(parameters.c_str(), "%d;%d", &row, &col);
+                    _row = row - 1;
+                    _col = col - 1;
+                    ++addresses;
+                } else if (bytes[end] == 'J') {
+                    for (auto& line : _lines) {
+                        line.assign(_columns, ' ');
+                    }
+                }
+                i = end;
+            }
+        }
+
+        const std::string& line(int row) const { return _lines[row]; }
+
+        int addresses = 0;
+        int pastLastColumn = 0;
+
+    private:
+        int _columns;
+        std::vector<std::string> _lines;
+        int _row = 0;
+        int _col = 0;
+    };
+
+    void Render(Terminal_View& view, FakeTerminal& terminal) {
+        std::string out;
+        view.render(out);
+        terminal.write(out);
+    }
+}
+
+TEST(TerminalScreenTest, PresentsOnlyChangedCells) {
+    TerminalScreen screen;
+    screen.resize(4, 3);
+    FakeTerminal terminal(4, 3);
+    std::string out;
+    ASSERT_TRUE(screen.present(out));
+    terminal.write(out);
+
+    // A contiguous run needs a single cursor address.
+    screen.set(1, 1, Cell{'x', ECellStyle::BOX});
+    screen.set(1, 2, Cell{'y', ECellStyle::BOX});
+    out.clear();
+    ASSERT_TRUE(screen.present(out));
+    terminal.write(out);
+    EXPECT_EQ(terminal.addresses, 1);
+    EXPECT_EQ(terminal.line(1), " xy ");
+
+    // Writing what is already shown sends nothing.
+    screen.set(1, 1, Cell{'x', ECellStyle::BOX});
+    out.clear();
+    EXPECT_FALSE(screen.present(out));
+    EXPECT_TRUE(out.empty());
+
+    // The cell after the last column is addressed again, not wrapped to.
+    screen.set(0, 3, Cell{'a', ECellStyle::BOX});
+    screen.set(1, 0, Cell{'b', ECellStyle::BOX});
+    out.clear();
+    ASSERT_TRUE(screen.present(out));
+    terminal.write(out);
+    EXPECT_EQ(terminal.addresses, 3);
+    EXPECT_EQ(terminal.pastLastColumn, 0);
+    EXPECT_EQ(terminal.line(0), "   a");
+    EXPECT_EQ(terminal.line(1), "bxy ");
+}
+
+TEST(Terminal_ViewTest, ArrowKeysMoveAndLoneEscapeQuits) {
+    Game game;
+    Terminal_View view(&game);
+    game.addObserver(&view);
+    view.resize(40, 10);
+    game.loadLevel(MakeLevel({{2, 2, 2, 2, 2, 2, 2},
+                              {2, 0, 0, 0, 0, 0, 2},
+                              {2, 0, 0, 0, 0, 0, 2},
+                              {2, 0, 0, 0, 0, 1, 2},
+                              {2, 2, 2, 2, 2, 2, 2}},
+                             Position(2, 2), {Position(3, 3)}));
+
+    // Normal and application cursor mode, in one read.
+    const char* keys = "\x1b[A\x1b[C\x1bOB";
+    view.handleInput(keys, std::strlen(keys));
+    view.update();
+    EXPECT_EQ(game.getPlayerPosition(), Position(2, 3));
+    EXPECT_EQ(game.getMoveCount(), 3);
+    EXPECT_FALSE(view.shouldClose());
+
+    view.handleInput("\x1b", 1);
+    EXPECT_TRUE(view.shouldClose());
+}
+
+TEST(Terminal_ViewTest, ViewportScrollsOnBoardLargerThanScreen) {
+    std::vector<std::vector<int>> grid(4, std::vector<int>(40, 0));
+    for (int col = 0; col < 40; ++col) {
+        grid[0][col] = 2;
+        grid[3][col] = 2;
+    }
+    grid[1][0] = grid[2][0] = grid[1][39] = grid[2][39] = 2;
+    grid[2][38] = 1;
+
+    Game game;
+    Terminal_View view(&game);
+    game.addObserver(&view);
+    // Ten tiles across, so the board needs four screens.
+    view.resize(20, 7);
+    game.loadLevel(MakeLevel(grid, Position(1, 1), {Position(2, 37)}));
+    FakeTerminal terminal(20, 7);
+    Render(view, terminal);
+
+    // Board row 1 is screen row 2: the view is centred in five rows.
+    EXPECT_EQ(terminal.line(2).substr(0, 4), "##@@");
+    for (int step = 0; step < 35; ++step) {
+        view.handleInput("d", 1);
+        view.update();
+        Render(view, terminal);
+        ASSERT_NE(terminal.line(2).find("@@"), std::string::npos) << "step " << step;
+    }
+
+    EXPECT_EQ(game.getPlayerPosition(), Position(1, 36));
+    EXPECT_EQ(terminal.line(2).substr(12), "@@    ##");
+    EXPECT_EQ(terminal.line(3).substr(12), "  []..##");
+    EXPECT_EQ(terminal.pastLastColumn, 0);
+}
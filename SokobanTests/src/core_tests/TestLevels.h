@@ -0,0 +1,29 @@
+#ifndef SOKOBANTESTS_TESTLEVELS_H
+#define SOKOBANTESTS_TESTLEVELS_H
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "GameMap.h"
+#include "Position.h"
+
+// Loads a level from rows of ETileType values (0 path, 1 target, 2 wall)
+// the way a level pack entry would be loaded.
+inline GameMap MakeLevel(const std::vector<std::vector<int>>& grid, const Position& player,
+                         const std::vector<Position>& boxes, int id = 1) {
+    nlohmann::json boxJson = nlohmann::json::array();
+    for (const auto& box : boxes) {
+        boxJson.push_back({{"row", box.getRow()}, {"col", box.getCol()}});
+    }
+    nlohmann::json level = {
+        {"id", id},
+        {"width", grid.empty() ? 0 : static_cast<int>(grid[0].size())},
+        {"height", static_cast<int>(grid.size())},
+        {"grid", grid},
+        {"playerStart", {{"row", player.getRow()}, {"col", player.getCol()}}},
+        {"boxPositions", boxJson}
+    };
+    GameMap map;
+    map.loadFromJson(level);
+    return map;
+}
+
+#endif
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <BoardKernel.h>
+#include <Game.h>
+#include <GameMap.h>
+
+using json = nlohmann::json;
+
+namespace {
+    struct ToolOptions {
+        std::string packPath = "levels.json";
+        uint64_t moves = 1000000;
+        uint64_t seed = 1;
+    };
+
+    struct RunResult {
+        double nsPerMove = 0.0;
+        uint64_t solves = 0;
+        Position player = Position(0, 0);
+        std::vector<Position> boxes;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: SokobanKernelBench [levels.json] [--moves N] [--seed N]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, ToolOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--moves" && hasValue) {
+                options.moves = std::stoull(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (!arg.empty() && arg[0] != '-') {
+                options.packPath = arg;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<EFacing> randomMoves(uint64_t count, uint64_t seed) {
+        std::vector<EFacing> moves(count);
+        uint64_t state = seed;
+        for (auto& move : moves) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            move = static_cast<EFacing>(state >> 62);
+        }
+        return moves;
+    }
+
+    std::vector<Position> sorted(std::vector<Position> positions) {
+        std::sort(positions.begin(), positions.end(), [](const Position& a, const Position& b) {
+            return a.getRow() != b.getRow() ? a.getRow() < b.getRow() : a.getCol() < b.getCol();
+        });
+        return positions;
+    }
+
+    // The generic path: every move goes through the virtual IGame interface,
+    // with history and observer notifications as in the real game.
+    RunResult runGame(const GameMap& map, const std::vector<EFacing>& moves) {
+        Game game;
+        game.loadLevel(map);
+        IGame& generic = game;
+        RunResult result;
+
+        auto start = std::chrono::steady_clock::now();
+        for (EFacing move : moves) {
+            generic.movePlayer(move);
+            if (generic.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                ++result.solves;
+                generic.restartLevel();
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        result.nsPerMove = elapsed.count() / static_cast<double>(std::max<size_t>(1, moves.size()));
+        result.player = generic.getPlayerPosition();
+        result.boxes = sorted(generic.getBoxPositions());
+        return result;
+    }
+
+    RunResult runKernel(const GameMap& map, const std::vector<EFacing>& moves, std::string& kernelSize) {
+        return withBoardKernel(map, [&](auto& kernel) {
+            using Kernel = std::decay_t<decltype(kernel)>;
+            kernelSize = std::to_string(Kernel::Stride) + "x" + std::to_string(Kernel::CellCount / Kernel::Stride);
+            RunResult result;
+
+            auto start = std::chrono::steady_clock::now();
+            bool pushed;
+            for (EFacing move : moves) {
+                if (kernel.move(move, pushed) && pushed && kernel.isSolved()) {
+                    ++result.solves;
+                    kernel.reset();
+                }
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            result.nsPerMove = elapsed.count() / static_cast<double>(std::max<size_t>(1, moves.size()));
+            result.player = kernel.getPlayerPosition();
+            result.boxes = kernel.getBoxPositions();
+            return result;
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    json pack;
+    std::ifstream file(options.packPath);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open " << options.packPath << std::endl;
+        return 1;
+    }
+    try {
+        file >> pack;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<EFacing> moves = randomMoves(options.moves, options.seed);
+    json reports = json::array();
+    bool allMatch = true;
+    for (const auto& level : pack["levels"]) {
+        json report;
+        report["id"] = level.value("id", 0);
+        try {
+            GameMap map;
+            map.loadFromJson(level);
+            RunResult game = runGame(map, moves);
+            std::string kernelSize;
+            RunResult kernel = runKernel(map, moves, kernelSize);
+
+            // Both paths replay the same moves, so they must end in the same position.
+            bool match = game.player == kernel.player && game.boxes == kernel.boxes && game.solves == kernel.solves;
+            allMatch = allMatch && match;
+            report["kernel"] = kernelSize;
+            report["gameNsPerMove"] = game.nsPerMove;
+            report["kernelNsPerMove"] = kernel.nsPerMove;
+            report["speedup"] = kernel.nsPerMove > 0.0 ? game.nsPerMove / kernel.nsPerMove : 0.0;
+            report["solves"] = kernel.solves;
+            report["match"] = match;
+        } catch (const std::exception& e) {
+            report["error"] = e.what();
+            allMatch = false;
+        }
+        reports.push_back(report);
+    }
+
+    json output;
+    output["pack"] = options.packPath;
+    output["moves"] = options.moves;
+    output["levels"] = reports;
+    std::cout << output.dump(2) << std::endl;
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <GameMap.h>
+#include <solver/Board.h>
+#include <solver/LevelValidator.h>
+#include <solver/Lurd.h>
+#include <solver/SolutionCache.h>
+#include <solver/Solver.h>
+
+using json = nlohmann::json;
+
+namespace {
+    struct AnalyzerOptions {
+        std::string packPath = "levels.json";
+        std::string outputPath;
+        std::string spillDirectory;
+        std::string cachePath;
+        unsigned threads = 0;
+        SolverOptions solver;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: SokobanAnalyzer [levels.json] [--threads N] [--max-nodes N]"
+                     " [--time-limit MS] [--no-macros] [--bidirectional]"
+                     " [--spill-dir DIR] [--memory-budget MB] [--cache FILE] [--output FILE]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, AnalyzerOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--threads" && hasValue) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--max-nodes" && hasValue) {
+                options.solver.maxNodes = std::stoull(argv[++i]);
+            } else if (arg == "--time-limit" && hasValue) {
+                options.solver.timeLimitMs = std::stod(argv[++i]);
+            } else if (arg == "--bidirectional") {
+                options.solver.bidirectional = true;
+            } else if (arg == "--spill-dir" && hasValue) {
+                options.spillDirectory = argv[++i];
+            } else if (arg == "--memory-budget" && hasValue) {
+                options.solver.memoryBudgetBytes = std::stoull(argv[++i]) * 1024 * 1024;
+            } else if (arg == "--cache" && hasValue) {
+                options.cachePath = argv[++i];
+            } else if (arg == "--no-macros") {
+                options.solver.useTunnelMacros = false;
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (!arg.empty() && arg[0] != '-') {
+                options.packPath = arg;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    json analyzeLevel(const json& level, SolverOptions solverOptions, const std::string& spillDirectory) {
+        json report;
+        report["id"] = level.value("id", 0);
+        report["name"] = level.value("name", "");
+
+        GameMap map;
+        try {
+            map.loadFromJson(level);
+        } catch (const std::exception& e) {
+            report["valid"] = false;
+            report["errors"] = json::array({std::string("Malformed level: ") + e.what()});
+            return report;
+        }
+
+        ValidationReport validation = LevelValidator::validate(map, solverOptions.cache);
+        report["valid"] = validation.isValid();
+        report["errors"] = validation.errors;
+        if (!validation.isValid()) {
+            return report;
+        }
+
+        Solver solver(map);
+        const Board& board = solver.getBoard();
+        report["boxes"] = board.getInitialBoxes().size();
+        report["floorCells"] = board.getFloorCount();
+        report["tunnelCells"] = board.getTunnelCount();
+        report["articulationPoints"] = board.getArticulationCount();
+        report["deadSquareRatio"] = board.getFloorCount() > 0
+            ? static_cast<double>(board.getDeadCount()) / board.getFloorCount()
+            : 0.0;
+
+        if (!spillDirectory.empty()) {
+            solverOptions.spillDirectory = spillDirectory + "/level-" + std::to_string(map.getId());
+        }
+        SolverResult result = solver.solve(solverOptions);
+        report["solved"] = result.solved;
+        report["fromCache"] = result.fromCache;
+        report["provenUnsolvable"] = result.exhausted;
+        report["nodesExpanded"] = result.nodesExpanded;
+        report["nodesGenerated"] = result.nodesGenerated;
+        report["macroPushes"] = result.macroPushes;
+        report["branchingFactor"] = result.branchingFactor;
+        report["solveTimeMs"] = result.solveTimeMs;
+        report["peakMemoryBytes"] = result.peakMemoryBytes;
+        report["arenaAllocations"] = result.arenaAllocations;
+        report["systemAllocations"] = result.systemAllocations;
+        if (!spillDirectory.empty()) {
+            report["bytesSpilled"] = result.bytesSpilled;
+        }
+        if (result.solved) {
+            bool optimal = !solverOptions.bidirectional || !solverOptions.spillDirectory.empty();
+            report[optimal ? "optimalPushes" : "pushes"] = result.pushes;
+            report["moves"] = result.moves;
+            report["solution"] = result.solution;
+            report["verified"] = Lurd::verify(map, result.solution);
+        }
+        return report;
+    }
+
+    // A level the solver chokes on is reported as broken rather than letting
+    // the exception escape its worker thread and abort the whole pack.
+    json analyzeLevelSafely(const json& level, const SolverOptions& solverOptions, const std::string& spillDirectory) {
+        try {
+            return analyzeLevel(level, solverOptions, spillDirectory);
+        } catch (const std::exception& e) {
+            json report;
+            bool hasId = level.is_object() && level.contains("id") && level["id"].is_number_integer();
+            bool hasName = level.is_object() && level.contains("name") && level["name"].is_string();
+            report["id"] = hasId ? level["id"] : json(0);
+            report["name"] = hasName ? level["name"] : json("");
+            report["valid"] = false;
+            report["errors"] = json::array({std::string("Analysis failed: ") + e.what()});
+            return report;
+        }
+    }
+
+    std::vector<int> difficultyOrder(const json& reports) {
+        std::vector<const json*> ranked;
+        for (const auto& report : reports) {
+            ranked.push_back(&report);
+        }
+        // Search effort is the best difficulty signal we have; unsolved and
+        // broken levels go last since they cannot be ranked.
+        std::stable_sort(ranked.begin(), ranked.end(), [](const json* a, const json* b) {
+            bool aSolved = a->value("solved", false);
+            bool bSolved = b->value("solved", false);
+            if (aSolved != bSolved) {
+                return aSolved;
+            }
+            if (!aSolved) {
+                return false;
+            }
+            uint64_t aNodes = a->value("nodesExpanded", uint64_t(0));
+            uint64_t bNodes = b->value("nodesExpanded", uint64_t(0));
+            if (aNodes != bNodes) {
+                return aNodes < bNodes;
+            }
+            return a->value("optimalPushes", 0) < b->value("optimalPushes", 0);
+        });
+
+        std::vector<int> order;
+        for (const json* report : ranked) {
+            order.push_back(report->value("id", 0));
+        }
+        return order;
+    }
+}
+
+int main(int argc, char** argv) {
+    AnalyzerOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    json pack;
+    try {
+        std::ifstream file(options.packPath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + options.packPath);
+        }
+        file >> pack;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<SolutionCache> cache;
+    if (!options.cachePath.empty()) {
+        try {
+            cache = std::make_unique<SolutionCache>(options.cachePath);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        options.solver.cache = cache.get();
+    }
+
+    const json& levels = pack["levels"];
+    std::vector<json> reports(levels.size());
+    std::atomic<size_t> nextLevel(0);
+
+    unsigned threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min<unsigned>(threadCount, static_cast<unsigned>(std::max<size_t>(1, levels.size())));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = nextLevel++; i < levels.size(); i = nextLevel++) {
+                reports[i] = analyzeLevelSafely(levels[i], options.solver, options.spillDirectory);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    json output;
+    output["pack"] = options.packPath;
+    output["levels"] = reports;
+    output["difficultyOrder"] = difficultyOrder(output["levels"]);
+
+    bool allValid = true;
+    for (const auto& report : reports) {
+        allValid = allValid && report.value("valid", false) && !report.value("provenUnsolvable", false);
+    }
+
+    if (options.outputPath.empty()) {
+        std::cout << output.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.outputPath);
+        out << output.dump(2) << std::endl;
+    }
+    return allValid ? 0 : 1;
+}
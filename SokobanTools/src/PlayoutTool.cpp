@@ -0,0 +1,141 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <GameMap.h>
+#include <solver/PlayoutEngine.h>
+
+using json = nlohmann::json;
+
+namespace {
+    struct ToolOptions {
+        std::string packPath = "levels.json";
+        std::string outputPath;
+        int level = 0;
+        PlayoutOptions playout;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: SokobanPlayout [levels.json] [--level ID] [--playouts N] [--threads N]"
+                     " [--max-pushes N] [--mcts] [--exploration C] [--seed N] [--output FILE]\n"
+                     "Levels with more than 64 boxes or 32767 cells are reported with an error.\n";
+    }
+
+    bool parseArguments(int argc, char** argv, ToolOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--level" && hasValue) {
+                options.level = std::stoi(argv[++i]);
+            } else if (arg == "--playouts" && hasValue) {
+                options.playout.playouts = std::stoull(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                options.playout.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--max-pushes" && hasValue) {
+                options.playout.maxPushes = std::stoi(argv[++i]);
+            } else if (arg == "--mcts") {
+                options.playout.mcts = true;
+            } else if (arg == "--exploration" && hasValue) {
+                options.playout.exploration = std::stod(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.playout.seed = std::stoull(argv[++i]);
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (!arg.empty() && arg[0] != '-') {
+                options.packPath = arg;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    json estimateLevel(const json& level, const PlayoutOptions& options) {
+        json report;
+        report["id"] = level.value("id", 0);
+        report["name"] = level.value("name", "");
+
+        GameMap map;
+        try {
+            map.loadFromJson(level);
+        } catch (const std::exception& e) {
+            report["error"] = std::string("Malformed level: ") + e.what();
+            return report;
+        }
+        if (map.getBoxPositions().size() > static_cast<size_t>(PlayoutEngine::MaxBoxes)) {
+            report["error"] = "Too many boxes for playouts";
+            return report;
+        }
+
+        // The engine rejects boards of more cells than its 16-bit indices hold.
+        try {
+            PlayoutEngine engine(map);
+            PlayoutResult result = engine.run(options);
+            std::vector<double> reached;
+            for (int k = 0; k <= engine.getBoxCount(); ++k) {
+                reached.push_back(result.reachedFraction(k));
+            }
+            double placed = 0.0;
+            for (int k = 1; k <= engine.getBoxCount(); ++k) {
+                placed += reached[k];
+            }
+
+            report["boxes"] = engine.getBoxCount();
+            report["playouts"] = result.playouts;
+            report["solvedFraction"] = result.reachedFraction(engine.getBoxCount());
+            report["stuckFraction"] = result.playouts ? static_cast<double>(result.stuck) / result.playouts : 0.0;
+            report["reachedTargets"] = reached;
+            report["bestOnTarget"] = result.bestOnTarget;
+            report["meanPushes"] = result.meanPushes();
+            // Expected share of boxes a playout never gets onto a target.
+            report["difficulty"] = engine.getBoxCount() ? 1.0 - placed / engine.getBoxCount() : 0.0;
+            report["elapsedMs"] = result.elapsedMs;
+            report["playoutsPerSecond"] = result.playoutsPerSecond();
+        } catch (const std::exception& e) {
+            report["error"] = e.what();
+        }
+        return report;
+    }
+}
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    json pack;
+    std::ifstream file(options.packPath);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open " << options.packPath << std::endl;
+        return 1;
+    }
+    try {
+        file >> pack;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    json reports = json::array();
+    for (const auto& level : pack["levels"]) {
+        if (options.level == 0 || level.value("id", 0) == options.level) {
+            reports.push_back(estimateLevel(level, options.playout));
+        }
+    }
+
+    json output;
+    output["pack"] = options.packPath;
+    output["mode"] = options.playout.mcts ? "mcts" : "random";
+    output["levels"] = reports;
+
+    if (options.outputPath.empty()) {
+        std::cout << output.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.outputPath);
+        out << output.dump(2) << std::endl;
+    }
+    return 0;
+}
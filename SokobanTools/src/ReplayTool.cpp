@@ -0,0 +1,593 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <BoardKernel.h>
+#include <Game.h>
+#include <GameMap.h>
+#include <replay/ReplayReader.h>
+#include <replay/ReplayWriter.h>
+#include <solver/Lurd.h>
+#include <solver/SolutionCache.h>
+
+using json = nlohmann::json;
+
+namespace {
+    // Records or sessions handed to a worker at a time; a multiple of the
+    // block size so every range of an archive starts on an indexed record.
+    const size_t RecordsPerTask = 16 * ReplayFormat::RecordsPerBlock;
+
+    struct ToolOptions {
+        std::string command;
+        std::string inputPath;
+        std::string packPath = "levels.json";
+        std::string outputPath;
+        bool asJson = false;
+        unsigned threads = 0;
+        uint64_t sessions = 200000;
+        uint64_t seed = 1;
+    };
+
+    struct PackLevel {
+        int id = 0;
+        GameMap map;
+    };
+
+    using LevelsByHash = std::unordered_map<uint64_t, PackLevel>;
+
+    void printUsage() {
+        std::cout << "Usage: SokobanReplay encode <sessions.json|sessions.txt> --output FILE [--levels levels.json]"
+                     " [--threads N]\n"
+                     "       SokobanReplay decode <replays.bin> [--levels levels.json] [--format text|json]"
+                     " [--threads N] [--output FILE]\n"
+                     "       SokobanReplay verify <replays.bin> [--levels levels.json] [--threads N]"
+                     " [--output FILE]\n"
+                     "       SokobanReplay bench [--levels levels.json] [--sessions N] [--threads N] [--seed N]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, ToolOptions& options) {
+        if (argc < 2) {
+            return false;
+        }
+        options.command = argv[1];
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--levels" && hasValue) {
+                options.packPath = argv[++i];
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (arg == "--format" && hasValue) {
+                std::string format = argv[++i];
+                if (format != "text" && format != "json") {
+                    return false;
+                }
+                options.asJson = format == "json";
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--sessions" && hasValue) {
+                options.sessions = std::stoull(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (!arg.empty() && arg[0] != '-' && options.inputPath.empty()) {
+                options.inputPath = arg;
+            } else {
+                return false;
+            }
+        }
+        if (options.command == "encode") {
+            return !options.inputPath.empty() && !options.outputPath.empty();
+        }
+        if (options.command == "decode" || options.command == "verify") {
+            return !options.inputPath.empty();
+        }
+        return options.command == "bench" && options.inputPath.empty();
+    }
+
+    json readJson(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + path);
+        }
+        json data;
+        file >> data;
+        return data;
+    }
+
+    // Malformed levels are left out; their replays show up as unknown.
+    LevelsByHash loadLevels(const std::string& packPath, std::unordered_map<int, uint64_t>* hashes = nullptr) {
+        LevelsByHash levels;
+        json pack = readJson(packPath);
+        for (const auto& level : pack["levels"]) {
+            PackLevel entry;
+            try {
+                entry.map.loadFromJson(level);
+            } catch (const std::exception&) {
+                continue;
+            }
+            entry.id = level.value("id", 0);
+            if (hashes) {
+                (*hashes)[entry.id] = SolutionCache::contentHash(entry.map);
+            }
+            levels.emplace(SolutionCache::contentHash(entry.map), std::move(entry));
+        }
+        return levels;
+    }
+
+    unsigned workerCount(unsigned requested, size_t tasks) {
+        unsigned count = requested;
+        if (count == 0) {
+            count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return std::min<unsigned>(count, static_cast<unsigned>(std::max<size_t>(1, tasks)));
+    }
+
+    // Calls work(worker, first, last) for ranges of count items on all
+    // workers. The first exception a worker throws is rethrown once all of
+    // them finished.
+    template <typename Work>
+    void forEachChunk(size_t count, unsigned threads, Work&& work) {
+        size_t tasks = (count + RecordsPerTask - 1) / RecordsPerTask;
+        std::atomic<size_t> nextTask(0);
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        std::vector<std::thread> workers;
+        unsigned workerTotal = workerCount(threads, tasks);
+        for (unsigned t = 0; t < workerTotal; ++t) {
+            workers.emplace_back([&, t]() {
+                try {
+                    for (size_t task = nextTask++; task < tasks; task = nextTask++) {
+                        size_t first = task * RecordsPerTask;
+                        work(t, first, std::min(first + RecordsPerTask, count));
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    template <typename Work>
+    void forEachRange(const ReplayReader& reader, unsigned threads, Work&& work) {
+        forEachChunk(reader.size(), threads, std::forward<Work>(work));
+    }
+
+    // Replays through Game. A replay is legal when every step moves the
+    // player and it pushes as often as its header says.
+    class ReplayChecker : public IGameObserver {
+    public:
+        void onNotify(EGameEvent event) override {
+            if (event == EGameEvent::BOX_MOVED) {
+                ++_pushes;
+            }
+        }
+
+        bool check(const GameMap& map, const std::string& lurd, uint32_t pushes, bool& solved) {
+            _game.removeObserver(this);
+            _game.loadLevel(map);
+            _game.addObserver(this);
+            _pushes = 0;
+            solved = false;
+            for (char step : lurd) {
+                EFacing direction;
+                int movesBefore = _game.getMoveCount();
+                if (!Lurd::toFacing(step, direction)) {
+                    return false;
+                }
+                _game.movePlayer(direction);
+                if (_game.getMoveCount() == movesBefore) {
+                    return false;
+                }
+            }
+            solved = _game.getCurrentState() == EGameState::LEVEL_COMPLETED;
+            return _pushes == pushes;
+        }
+
+    private:
+        Game _game;
+        uint32_t _pushes = 0;
+    };
+
+    struct EncodedSession {
+        bool known = false;
+        ReplayInfo info;
+        std::vector<uint8_t> payload;
+    };
+
+    int runEncode(const ToolOptions& options) {
+        std::unordered_map<int, uint64_t> hashes;
+        LevelsByHash pack = loadLevels(options.packPath, &hashes);
+
+        // A solutions archive, or one "<level> <lurd>" line per session.
+        std::vector<std::pair<int, std::string>> sessions;
+        if (std::filesystem::path(options.inputPath).extension() == ".json") {
+            json archive = readJson(options.inputPath);
+            for (const auto& entry : archive["solutions"]) {
+                sessions.emplace_back(entry.value("level", 0), entry.value("solution", ""));
+            }
+        } else {
+            std::ifstream file(options.inputPath);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open " + options.inputPath);
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                std::istringstream fields(line);
+                int level;
+                std::string lurd;
+                if (fields >> level) {
+                    fields >> lurd;
+                    sessions.emplace_back(level, lurd);
+                }
+            }
+        }
+
+        // Replaying and encoding run on the workers; the records are then
+        // written in input order.
+        std::vector<EncodedSession> encoded(sessions.size());
+        forEachChunk(sessions.size(), options.threads, [&](unsigned, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const auto& session = sessions[i];
+                auto hash = hashes.find(session.first);
+                if (hash == hashes.end()) {
+                    continue;
+                }
+                // The header's push count comes from the level, not from the
+                // case of the input, which is often all lowercase.
+                std::string lurd = session.second;
+                if (!ReplayCodec::restorePushes(pack.at(hash->second).map, lurd)) {
+                    lurd = session.second;
+                }
+                EncodedSession& record = encoded[i];
+                if (!ReplayCodec::encode(lurd, record.payload, record.info.encoding)) {
+                    throw std::runtime_error("Replay is not a LURD string");
+                }
+                record.known = true;
+                record.info.levelHash = hash->second;
+                record.info.levelId = session.first;
+                record.info.moves = static_cast<uint32_t>(lurd.size());
+                record.info.pushes = static_cast<uint32_t>(Lurd::countPushes(lurd));
+            }
+        });
+
+        ReplayWriter writer(options.outputPath);
+        size_t unknown = 0;
+        size_t textBytes = 0;
+        for (size_t i = 0; i < sessions.size(); ++i) {
+            EncodedSession& record = encoded[i];
+            if (!record.known) {
+                ++unknown;
+                continue;
+            }
+            record.info.payload = record.payload.data();
+            record.info.payloadSize = record.payload.size();
+            writer.add(record.info);
+            textBytes += std::to_string(sessions[i].first).size() + sessions[i].second.size() + 2;
+        }
+        writer.finish();
+
+        json report;
+        report["replays"] = writer.getCount();
+        report["unknownLevels"] = unknown;
+        report["textBytes"] = textBytes;
+        report["archiveBytes"] = writer.getBytesWritten();
+        report["ratio"] = writer.getBytesWritten() ? static_cast<double>(textBytes) / writer.getBytesWritten() : 0.0;
+        std::cout << report.dump(2) << std::endl;
+        return unknown == 0 ? 0 : 1;
+    }
+
+    int runDecode(const ToolOptions& options) {
+        ReplayReader reader(options.inputPath);
+        LevelsByHash pack;
+        if (std::filesystem::exists(options.packPath)) {
+            pack = loadLevels(options.packPath);
+        }
+
+        std::ofstream file;
+        if (!options.outputPath.empty()) {
+            file.open(options.outputPath);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to create " + options.outputPath);
+            }
+        }
+        std::ostream& out = options.outputPath.empty() ? std::cout : file;
+
+        // Each range decodes into its own buffer; the buffers are joined in
+        // record order. Steps stay lowercase when the level is not in the pack.
+        size_t ranges = (reader.size() + RecordsPerTask - 1) / RecordsPerTask;
+        std::vector<std::string> text(options.asJson ? 0 : ranges);
+        std::vector<json> solutions(options.asJson ? ranges : 0, json::array());
+        forEachRange(reader, options.threads, [&](unsigned, size_t first, size_t last) {
+            size_t range = first / RecordsPerTask;
+            reader.forEach(first, last, [&](size_t, const ReplayInfo& info) {
+                std::string lurd = reader.decode(info);
+                auto level = pack.find(info.levelHash);
+                if (level != pack.end()) {
+                    ReplayCodec::restorePushes(level->second.map, lurd);
+                }
+                if (options.asJson) {
+                    solutions[range].push_back({{"level", info.levelId}, {"solution", lurd}});
+                } else {
+                    text[range] += std::to_string(info.levelId);
+                    text[range] += ' ';
+                    text[range] += lurd;
+                    text[range] += '\n';
+                }
+            });
+        });
+
+        if (options.asJson) {
+            json joined = json::array();
+            for (auto& range : solutions) {
+                for (auto& solution : range) {
+                    joined.push_back(std::move(solution));
+                }
+            }
+            out << json{{"solutions", joined}}.dump(2) << std::endl;
+        } else {
+            for (const auto& range : text) {
+                out << range;
+            }
+        }
+        return 0;
+    }
+
+    int runVerify(const ToolOptions& options) {
+        ReplayReader reader(options.inputPath);
+        LevelsByHash pack = loadLevels(options.packPath);
+
+        unsigned threads = workerCount(options.threads, reader.size());
+        std::vector<ReplayChecker> checkers(threads);
+        std::vector<json> failures(threads, json::array());
+        std::atomic<uint64_t> legal(0);
+        std::atomic<uint64_t> solved(0);
+        std::atomic<uint64_t> unknown(0);
+        auto start = std::chrono::steady_clock::now();
+        forEachRange(reader, threads, [&](unsigned worker, size_t first, size_t last) {
+            uint64_t legalCount = 0;
+            uint64_t solvedCount = 0;
+            uint64_t unknownCount = 0;
+            size_t next = first;
+            try {
+                reader.forEach(first, last, [&](size_t index, const ReplayInfo& info) {
+                    next = index + 1;
+                    auto level = pack.find(info.levelHash);
+                    if (level == pack.end()) {
+                        ++unknownCount;
+                        failures[worker].push_back(
+                            {{"index", index}, {"level", info.levelId}, {"error", "Unknown level"}});
+                        return;
+                    }
+                    bool won;
+                    bool ok;
+                    try {
+                        ok = checkers[worker].check(level->second.map, reader.decode(info), info.pushes, won);
+                    } catch (const std::exception& e) {
+                        failures[worker].push_back({{"index", index}, {"level", info.levelId}, {"error", e.what()}});
+                        return;
+                    }
+                    if (ok) {
+                        ++legalCount;
+                        solvedCount += won;
+                    } else {
+                        failures[worker].push_back(
+                            {{"index", index}, {"level", info.levelId}, {"error", "Illegal replay"}});
+                    }
+                });
+            } catch (const std::exception& e) {
+                // A corrupt record header hides where the next one starts, so
+                // the rest of the range cannot be read.
+                failures[worker].push_back({{"index", next}, {"error", e.what()}, {"unread", last - next}});
+            }
+            legal += legalCount;
+            solved += solvedCount;
+            unknown += unknownCount;
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        json invalid = json::array();
+        for (auto& list : failures) {
+            for (auto& failure : list) {
+                invalid.push_back(std::move(failure));
+            }
+        }
+        std::sort(invalid.begin(), invalid.end(),
+                  [](const json& a, const json& b) { return a["index"] < b["index"]; });
+
+        json report;
+        report["replays"] = reader.size();
+        report["legal"] = legal.load();
+        report["solved"] = solved.load();
+        report["unknownLevels"] = unknown.load();
+        report["threads"] = threads;
+        report["replaysPerSecond"] = seconds > 0.0 ? reader.size() / seconds : 0.0;
+        report["invalid"] = invalid;
+        if (!options.outputPath.empty()) {
+            std::ofstream file(options.outputPath);
+            file << report.dump(2) << std::endl;
+        } else {
+            std::cout << report.dump(2) << std::endl;
+        }
+        return invalid.empty() ? 0 : 1;
+    }
+
+    // Random sessions on the pack levels: players mostly keep walking the
+    // way they were going, so a move repeats the previous one half the time.
+    std::vector<std::pair<const PackLevel*, std::string>> makeSessions(const LevelsByHash& pack, uint64_t count,
+                                                                      uint64_t seed) {
+        std::vector<const PackLevel*> levels;
+        for (const auto& level : pack) {
+            levels.push_back(&level.second);
+        }
+        std::sort(levels.begin(), levels.end(), [](const PackLevel* a, const PackLevel* b) { return a->id < b->id; });
+
+        std::vector<std::pair<const PackLevel*, std::string>> sessions;
+        sessions.reserve(count);
+        uint64_t state = seed;
+        auto next = [&state]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return state >> 33;
+        };
+        for (uint64_t i = 0; i < count; ++i) {
+            const PackLevel* level = levels[i % levels.size()];
+            size_t length = 20 + next() % 600;
+            std::string lurd;
+            withBoardKernel(level->map, [&](auto& kernel) {
+                int previous = static_cast<int>(next() % 4);
+                for (size_t attempts = 0; lurd.size() < length && attempts < 8 * length && !kernel.isSolved(); ++attempts) {
+                    int direction = next() % 2 ? previous : static_cast<int>(next() % 4);
+                    bool pushed;
+                    if (kernel.move(static_cast<EFacing>(direction), pushed)) {
+                        lurd += Lurd::toChar(static_cast<EFacing>(direction), pushed);
+                        previous = direction;
+                    }
+                }
+            });
+            sessions.emplace_back(level, std::move(lurd));
+        }
+        return sessions;
+    }
+
+    int runBenchmark(const ToolOptions& options) {
+        LevelsByHash pack = loadLevels(options.packPath);
+        if (pack.empty()) {
+            throw std::runtime_error("No playable levels in " + options.packPath);
+        }
+        auto sessions = makeSessions(pack, options.sessions, options.seed);
+        uint64_t moves = 0;
+        size_t textBytes = 0;
+        json archive = {{"solutions", json::array()}};
+        for (const auto& session : sessions) {
+            moves += session.second.size();
+            textBytes += std::to_string(session.first->id).size() + session.second.size() + 2;
+            archive["solutions"].push_back({{"level", session.first->id}, {"solution", session.second}});
+        }
+        size_t jsonBytes = archive.dump().size();
+        archive = json();
+
+        std::string path = (std::filesystem::temp_directory_path() / "sokoban-replay-bench.bin").string();
+        auto start = std::chrono::steady_clock::now();
+        size_t archiveBytes;
+        {
+            ReplayWriter writer(path);
+            for (const auto& session : sessions) {
+                writer.add(SolutionCache::contentHash(session.first->map), session.first->id, session.second);
+            }
+            writer.finish();
+            archiveBytes = writer.getBytesWritten();
+        }
+        double encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        json report;
+        {
+            ReplayReader reader(path);
+            // Decodes into one buffer per worker, so only decoding is timed.
+            auto decodeAll = [&](unsigned threads) {
+                unsigned count = workerCount(threads, reader.size());
+                std::vector<std::string> buffers(count);
+                std::atomic<uint64_t> decoded(0);
+                auto begin = std::chrono::steady_clock::now();
+                forEachRange(reader, count, [&](unsigned worker, size_t first, size_t last) {
+                    uint64_t steps = 0;
+                    reader.forEach(first, last, [&](size_t, const ReplayInfo& info) {
+                        std::string& buffer = buffers[worker];
+                        buffer.resize(info.moves);
+                        ReplayCodec::decode(info.payload, info.payloadSize, info.encoding, info.moves, &buffer[0]);
+                        steps += info.moves;
+                    });
+                    decoded += steps;
+                });
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                if (decoded != moves) {
+                    throw std::runtime_error("Decoded a different number of moves than were encoded");
+                }
+                return seconds > 0.0 ? moves / seconds / 1e9 : 0.0;
+            };
+
+            // Spot check that the archive decodes to the sessions.
+            for (size_t i = 0; i < reader.size(); i += 997) {
+                std::string lurd = reader.decode(reader.get(i));
+                if (!ReplayCodec::restorePushes(sessions[i].first->map, lurd) || lurd != sessions[i].second) {
+                    throw std::runtime_error("Replay " + std::to_string(i) + " does not round-trip");
+                }
+            }
+
+            unsigned threads = workerCount(options.threads, reader.size());
+            std::vector<ReplayChecker> checkers(threads);
+            std::atomic<uint64_t> legal(0);
+            start = std::chrono::steady_clock::now();
+            forEachRange(reader, threads, [&](unsigned worker, size_t first, size_t last) {
+                uint64_t count = 0;
+                reader.forEach(first, last, [&](size_t, const ReplayInfo& info) {
+                    bool won;
+                    const PackLevel& level = pack.at(info.levelHash);
+                    count += checkers[worker].check(level.map, reader.decode(info), info.pushes, won);
+                });
+                legal += count;
+            });
+            double verifySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            report["sessions"] = sessions.size();
+            report["moves"] = moves;
+            report["textBytes"] = textBytes;
+            report["jsonBytes"] = jsonBytes;
+            report["archiveBytes"] = archiveBytes;
+            report["ratioToText"] = static_cast<double>(textBytes) / archiveBytes;
+            report["ratioToJson"] = static_cast<double>(jsonBytes) / archiveBytes;
+            report["bitsPerMove"] = 8.0 * archiveBytes / std::max<uint64_t>(1, moves);
+            report["encodeMBPerSecond"] = encodeSeconds > 0.0 ? textBytes / encodeSeconds / 1e6 : 0.0;
+            report["decodeGBPerSecondOneThread"] = decodeAll(1);
+            report["decodeGBPerSecond"] = decodeAll(options.threads);
+            report["threads"] = threads;
+            report["verifiedLegal"] = legal.load();
+            report["verifyReplaysPerSecond"] = verifySeconds > 0.0 ? reader.size() / verifySeconds : 0.0;
+        }
+        std::filesystem::remove(path);
+        std::cout << report.dump(2) << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    try {
+        if (options.command == "encode") {
+            return runEncode(options);
+        }
+        if (options.command == "decode") {
+            return runDecode(options);
+        }
+        if (options.command == "verify") {
+            return runVerify(options);
+        }
+        return runBenchmark(options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
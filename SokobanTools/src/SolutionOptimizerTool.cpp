@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <GameMap.h>
+#include <solver/SolutionOptimizer.h>
+
+using json = nlohmann::json;
+
+namespace {
+    struct ToolOptions {
+        std::string archivePath;
+        std::string packPath = "levels.json";
+        std::string outputPath;
+        unsigned threads = 0;
+        OptimizerOptions optimizer;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: SokobanOptimizer <solutions.json> [--levels levels.json] [--threads N]"
+                     " [--window PUSHES] [--window-nodes N] [--passes N] [--output FILE]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, ToolOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--levels" && hasValue) {
+                options.packPath = argv[++i];
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--window" && hasValue) {
+                options.optimizer.windowPushes = std::stoi(argv[++i]);
+            } else if (arg == "--window-nodes" && hasValue) {
+                options.optimizer.windowNodes = std::stoull(argv[++i]);
+            } else if (arg == "--passes" && hasValue) {
+                options.optimizer.maxPasses = std::stoi(argv[++i]);
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (!arg.empty() && arg[0] != '-' && options.archivePath.empty()) {
+                options.archivePath = arg;
+            } else {
+                return false;
+            }
+        }
+        return !options.archivePath.empty();
+    }
+
+    json readJson(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + path);
+        }
+        json data;
+        file >> data;
+        return data;
+    }
+
+    json optimizeEntry(const json& entry, const std::map<int, const json*>& levels, const OptimizerOptions& options) {
+        json report;
+        int levelId = entry.value("level", 0);
+        std::string solution = entry.value("solution", "");
+        report["level"] = levelId;
+
+        auto level = levels.find(levelId);
+        if (level == levels.end()) {
+            report["valid"] = false;
+            report["error"] = "Unknown level";
+            return report;
+        }
+
+        GameMap map;
+        try {
+            map.loadFromJson(*level->second);
+        } catch (const std::exception& e) {
+            report["valid"] = false;
+            report["error"] = std::string("Malformed level: ") + e.what();
+            return report;
+        }
+
+        SolutionOptimizer optimizer(map);
+        OptimizationResult result = optimizer.optimize(solution, options);
+        report["valid"] = result.valid;
+        report["originalMoves"] = result.originalMoves;
+        report["originalPushes"] = result.originalPushes;
+        if (!result.valid) {
+            report["error"] = "Solution does not solve the level";
+            return report;
+        }
+        report["moves"] = result.moves;
+        report["pushes"] = result.pushes;
+        report["movesSaved"] = result.originalMoves - result.moves;
+        report["pushesSaved"] = result.originalPushes - result.pushes;
+        report["cyclesRemoved"] = result.cyclesRemoved;
+        report["windowsImproved"] = result.windowsImproved;
+        report["optimizeTimeMs"] = result.optimizeTimeMs;
+        report["solution"] = result.solution;
+        return report;
+    }
+
+    // An entry that throws is reported as invalid rather than letting the
+    // exception escape its worker thread and abort the whole archive.
+    json optimizeEntrySafely(const json& entry, const std::map<int, const json*>& levels,
+                             const OptimizerOptions& options) {
+        try {
+            return optimizeEntry(entry, levels, options);
+        } catch (const std::exception& e) {
+            json report;
+            bool hasLevel = entry.is_object() && entry.contains("level") && entry["level"].is_number_integer();
+            report["level"] = hasLevel ? entry["level"] : json(0);
+            report["valid"] = false;
+            report["error"] = std::string("Optimization failed: ") + e.what();
+            return report;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    json archive;
+    json pack;
+    try {
+        archive = readJson(options.archivePath);
+        pack = readJson(options.packPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::map<int, const json*> levels;
+    for (const auto& level : pack["levels"]) {
+        // Levels without a numeric id cannot be referenced by any entry.
+        if (level.is_object() && level.contains("id") && level["id"].is_number_integer()) {
+            levels[level["id"].get<int>()] = &level;
+        }
+    }
+
+    const json& entries = archive["solutions"];
+    std::vector<json> reports(entries.size());
+    std::atomic<size_t> nextEntry(0);
+
+    unsigned threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min<unsigned>(threadCount, static_cast<unsigned>(std::max<size_t>(1, entries.size())));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = nextEntry++; i < entries.size(); i = nextEntry++) {
+                reports[i] = optimizeEntrySafely(entries[i], levels, options.optimizer);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    long long originalMoves = 0;
+    long long moves = 0;
+    long long originalPushes = 0;
+    long long pushes = 0;
+    bool allValid = true;
+    for (const auto& report : reports) {
+        if (!report.value("valid", false)) {
+            allValid = false;
+            continue;
+        }
+        originalMoves += report.value("originalMoves", 0);
+        moves += report.value("moves", 0);
+        originalPushes += report.value("originalPushes", 0);
+        pushes += report.value("pushes", 0);
+    }
+
+    json output;
+    output["archive"] = options.archivePath;
+    output["solutions"] = reports;
+    output["summary"] = {
+        {"originalMoves", originalMoves},
+        {"moves", moves},
+        {"originalPushes", originalPushes},
+        {"pushes", pushes}
+    };
+
+    if (options.outputPath.empty()) {
+        std::cout << output.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.outputPath);
+        out << output.dump(2) << std::endl;
+    }
+    return allValid ? 0 : 1;
+}
@@ -0,0 +1,915 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <BoardKernel.h>
+#include <Game.h>
+#include <GameMap.h>
+#include <solver/Lurd.h>
+#include <spectator/SpectatorGame.h>
+#include <spectator/SpectatorEncoder.h>
+
+using json = nlohmann::json;
+
+namespace {
+    // Boxes are compared on every push and at this interval; the history
+    // engine seeks at the same interval so its seeks are always checked.
+    const size_t FullCheckInterval = 32;
+    // Failures shrunk and reported per engine; the rest are only counted.
+    const int MaxReportsPerEngine = 4;
+
+    struct ToolOptions {
+        std::string packPath = "levels.json";
+        uint64_t sequences = 20000;
+        size_t length = 512;
+        int synthetic = 48;
+        unsigned threads = 0;
+        uint64_t seed = 1;
+        double seconds = 0.0;
+        std::string baselinePath;
+        double tolerance = 20.0;
+        std::string outputPath;
+        bool selfTest = false;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: SokobanStress [levels.json] [--sequences N] [--length MOVES] [--synthetic N]"
+                     " [--threads N] [--seed N] [--seconds S] [--baseline FILE] [--tolerance PERCENT]"
+                     " [--output FILE] [--self-test]\n";
+    }
+
+    bool parseArguments(int argc, char** argv, ToolOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--sequences" && hasValue) {
+                options.sequences = std::stoull(argv[++i]);
+            } else if (arg == "--length" && hasValue) {
+                options.length = static_cast<size_t>(std::stoul(argv[++i]));
+            } else if (arg == "--synthetic" && hasValue) {
+                options.synthetic = std::stoi(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (arg == "--seconds" && hasValue) {
+                options.seconds = std::stod(argv[++i]);
+            } else if (arg == "--baseline" && hasValue) {
+                options.baselinePath = argv[++i];
+            } else if (arg == "--tolerance" && hasValue) {
+                options.tolerance = std::stod(argv[++i]);
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (arg == "--self-test") {
+                options.selfTest = true;
+            } else if (!arg.empty() && arg[0] != '-') {
+                options.packPath = arg;
+            } else {
+                return false;
+            }
+        }
+        return options.length > 0;
+    }
+
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : _state(seed) {}
+
+        uint64_t next() {
+            // splitmix64
+            uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        int below(int bound) { return static_cast<int>(next() % static_cast<uint64_t>(bound)); }
+
+    private:
+        uint64_t _state;
+    };
+
+    struct TestLevel {
+        int id = 0;
+        bool synthetic = false;
+        GameMap map;
+        // The level as JSON, so a synthetic level can be reported with a repro.
+        json source;
+    };
+
+    std::string describe(const Position& pos) {
+        return "(" + std::to_string(pos.getRow()) + "," + std::to_string(pos.getCol()) + ")";
+    }
+
+    std::vector<Position> sorted(std::vector<Position> positions) {
+        std::sort(positions.begin(), positions.end(), [](const Position& a, const Position& b) {
+            return a.getRow() != b.getRow() ? a.getRow() < b.getRow() : a.getCol() < b.getCol();
+        });
+        return positions;
+    }
+
+    std::string describe(const std::vector<Position>& boxes) {
+        std::string text = "[";
+        for (const auto& box : boxes) {
+            text += (text.size() > 1 ? " " : "") + describe(box);
+        }
+        return text + "]";
+    }
+
+    // Rooms with random walls, boxes and targets. Sizes straddle the limits
+    // of every BoardKernel and go past the largest one, and half of the
+    // rooms have no wall border, so moves run into the edge of the grid.
+    TestLevel makeSyntheticLevel(int index, Random& random) {
+        static const int Widths[] = {3, 8, 14, 15, 30, 31, 62, 70};
+        int width = index < 16 ? Widths[index % 8] : 3 + random.below(60);
+        int height = index < 16 ? Widths[(index / 2 + 3) % 8] : 3 + random.below(60);
+        bool walled = random.below(2) == 0;
+        int wallPercent = random.below(36);
+
+        std::vector<std::vector<int>> grid(height, std::vector<int>(width, 0));
+        std::vector<Position> floor;
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                bool border = row == 0 || col == 0 || row == height - 1 || col == width - 1;
+                if ((walled && border) || random.below(100) < wallPercent) {
+                    grid[row][col] = static_cast<int>(ETileType::WALL);
+                } else {
+                    floor.push_back(Position(row, col));
+                }
+            }
+        }
+        if (floor.empty()) {
+            grid[height / 2][width / 2] = static_cast<int>(ETileType::PATH);
+            floor.push_back(Position(height / 2, width / 2));
+        }
+        for (size_t i = floor.size() - 1; i > 0; --i) {
+            std::swap(floor[i], floor[static_cast<size_t>(random.below(static_cast<int>(i + 1)))]);
+        }
+
+        // The first cell is the player; boxes and targets come after it and
+        // sometimes share cells, so some boxes start on a target.
+        size_t boxes = std::min<size_t>(floor.size() - 1, 1 + random.below(20));
+        size_t targets = std::min<size_t>(floor.size() - 1, boxes + random.below(3));
+        size_t overlap = random.below(static_cast<int>(boxes) + 1) / 2;
+        json boxPositions = json::array();
+        for (size_t i = 0; i < boxes; ++i) {
+            const Position& box = floor[1 + i];
+            boxPositions.push_back({{"row", box.getRow()}, {"col", box.getCol()}});
+        }
+        for (size_t i = 0; i < targets; ++i) {
+            size_t cell = std::min(floor.size() - 1, 1 + boxes - overlap + i);
+            grid[floor[cell].getRow()][floor[cell].getCol()] = static_cast<int>(ETileType::TARGET);
+        }
+
+        TestLevel level;
+        level.id = 100000 + index;
+        level.synthetic = true;
+        level.source = {
+            {"id", level.id},
+            {"width", width},
+            {"height", height},
+            {"grid", grid},
+            {"playerStart", {{"row", floor[0].getRow()}, {"col", floor[0].getCol()}}},
+            {"boxPositions", boxPositions}
+        };
+        level.map.loadFromJson(level.source);
+        return level;
+    }
+
+    enum class EGenerator { RANDOM, RUNS, PUSHY };
+    const char* GeneratorNames[] = {"random", "runs", "pushy"};
+
+    Position step(const Position& from, EFacing direction) {
+        switch (direction) {
+            case EFacing::LEFT: return Position(from.getRow(), from.getCol() - 1);
+            case EFacing::UP: return Position(from.getRow() - 1, from.getCol());
+            case EFacing::DOWN: return Position(from.getRow() + 1, from.getCol());
+            case EFacing::RIGHT: return Position(from.getRow(), from.getCol() + 1);
+        }
+        return from;
+    }
+
+    // Move sequences. RUNS repeats a direction up to 16 times, driving boxes
+    // into walls, corners and each other; PUSHY follows its own simple model
+    // of the level and pushes a box whenever one is next to the player.
+    std::vector<EFacing> generateMoves(const GameMap& map, EGenerator generator, size_t length, Random& random) {
+        std::vector<EFacing> moves;
+        moves.reserve(length);
+        if (generator == EGenerator::RANDOM) {
+            for (size_t i = 0; i < length; ++i) {
+                moves.push_back(static_cast<EFacing>(random.below(4)));
+            }
+            return moves;
+        }
+        if (generator == EGenerator::RUNS) {
+            while (moves.size() < length) {
+                EFacing direction = static_cast<EFacing>(random.below(4));
+                for (int run = 1 + random.below(16); run > 0 && moves.size() < length; --run) {
+                    moves.push_back(direction);
+                }
+            }
+            return moves;
+        }
+
+        int width = map.getWidth();
+        int height = map.getHeight();
+        auto inside = [&](const Position& pos) {
+            return pos.getRow() >= 0 && pos.getCol() >= 0 && pos.getRow() < height && pos.getCol() < width;
+        };
+        auto index = [width](const Position& pos) { return pos.getRow() * width + pos.getCol(); };
+        std::vector<uint8_t> boxes;
+        Position player(0, 0);
+        auto reset = [&]() {
+            boxes.assign(static_cast<size_t>(width) * height, 0);
+            for (const auto& box : map.getBoxPositions()) {
+                boxes[index(box)] = 1;
+            }
+            player = map.getPlayerStart();
+        };
+        reset();
+
+        EFacing previous = EFacing::RIGHT;
+        while (moves.size() < length) {
+            std::vector<EFacing> pushes;
+            for (int d = 0; d < 4; ++d) {
+                Position next = step(player, static_cast<EFacing>(d));
+                if (inside(next) && boxes[index(next)]) {
+                    pushes.push_back(static_cast<EFacing>(d));
+                }
+            }
+            EFacing direction;
+            if (!pushes.empty() && random.below(4) != 0) {
+                direction = pushes[random.below(static_cast<int>(pushes.size()))];
+            } else {
+                direction = random.below(2) ? previous : static_cast<EFacing>(random.below(4));
+            }
+            moves.push_back(direction);
+            previous = direction;
+
+            Position next = step(player, direction);
+            if (!inside(next) || map.getTileAt(next.getRow(), next.getCol()) == ETileType::WALL) {
+                continue;
+            }
+            if (boxes[index(next)]) {
+                Position beyond = step(next, direction);
+                if (!inside(beyond) || map.getTileAt(beyond.getRow(), beyond.getCol()) == ETileType::WALL ||
+                    boxes[index(beyond)]) {
+                    continue;
+                }
+                boxes[index(next)] = 0;
+                boxes[index(beyond)] = 1;
+            }
+            player = next;
+        }
+        return moves;
+    }
+
+    struct Sequence {
+        std::vector<EFacing> moves;
+    };
+
+    // A fast path that must behave exactly like Game. step() runs in lockstep
+    // with the reference; run() replays a whole sequence as fast as it can,
+    // restarting where the reference won, and is what gets timed.
+    class Engine {
+    public:
+        virtual ~Engine() = default;
+        virtual const char* getName() const = 0;
+        virtual void reset() = 0;
+        virtual bool step(EFacing direction, bool& pushed) = 0;
+        virtual Position getPlayer() = 0;
+        virtual std::vector<Position> getBoxes() = 0;
+        virtual bool isSolved() = 0;
+        // Untimed setup before run().
+        virtual void prepare(const Sequence&) {}
+        // Starts from a freshly built engine. Returns a checksum so the work
+        // cannot be optimized away.
+        virtual uint64_t run(const Sequence& sequence) = 0;
+    };
+
+    class GameEngine : public Engine {
+    public:
+        explicit GameEngine(const GameMap& map) : _map(map) { reset(); }
+
+        const char* getName() const override { return "game"; }
+        void reset() override { _game.loadLevel(_map); }
+
+        bool step(EFacing direction, bool& pushed) override {
+            int movesBefore = _game.getMoveCount();
+            _game.movePlayer(direction);
+            pushed = _game.getMoveCount() != movesBefore && _game.getHistory().isPush(movesBefore);
+            return _game.getMoveCount() != movesBefore;
+        }
+
+        Position getPlayer() override { return _game.getPlayerPosition(); }
+        std::vector<Position> getBoxes() override { return sorted(_game.getBoxPositions()); }
+        bool isSolved() override { return _game.getCurrentState() == EGameState::LEVEL_COMPLETED; }
+
+        uint64_t run(const Sequence& sequence) override {
+            IGame& generic = _game;
+            uint64_t checksum = 0;
+            for (EFacing move : sequence.moves) {
+                generic.movePlayer(move);
+                if (generic.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                    ++checksum;
+                    generic.restartLevel();
+                }
+            }
+            return checksum + static_cast<uint64_t>(generic.getMoveCount());
+        }
+
+    private:
+        GameMap _map;
+        Game _game;
+    };
+
+    template <int MaxW, int MaxH>
+    class KernelEngine : public Engine {
+    public:
+        explicit KernelEngine(const GameMap& map)
+            : _kernel(map),
+              _name("kernel" + std::to_string(MaxW) + "x" + std::to_string(MaxH))
+        {
+            // A level that starts solved is won by its first move, pushed or not.
+            _startSolved = _kernel.isSolved();
+        }
+
+        const char* getName() const override { return _name.c_str(); }
+        void reset() override { _kernel.reset(); }
+        bool step(EFacing direction, bool& pushed) override { return _kernel.move(direction, pushed); }
+        Position getPlayer() override { return _kernel.getPlayerPosition(); }
+        std::vector<Position> getBoxes() override { return _kernel.getBoxPositions(); }
+        bool isSolved() override { return _kernel.isSolved(); }
+
+        uint64_t run(const Sequence& sequence) override {
+            uint64_t checksum = 0;
+            bool pushed;
+            for (EFacing move : sequence.moves) {
+                if (_kernel.move(move, pushed) && (pushed || _startSolved) && _kernel.isSolved()) {
+                    ++checksum;
+                    _kernel.reset();
+                }
+            }
+            return checksum + static_cast<uint64_t>(_kernel.getPlayerPosition().getCol());
+        }
+
+    protected:
+        BoardKernel<MaxW, MaxH> _kernel;
+
+    private:
+        std::string _name;
+        bool _startSolved;
+    };
+
+    // Planted bug for --self-test: the third push in a row in the same
+    // direction is refused.
+    class BrokenKernelEngine : public KernelEngine<64, 64> {
+    public:
+        explicit BrokenKernelEngine(const GameMap& map) : KernelEngine<64, 64>(map) {}
+
+        const char* getName() const override { return "broken-kernel"; }
+
+        void reset() override {
+            KernelEngine<64, 64>::reset();
+            _streak = 0;
+        }
+
+        bool step(EFacing direction, bool& pushed) override {
+            if (_streak == 2 && direction == _last) {
+                pushed = false;
+                _streak = 0;
+                return false;
+            }
+            bool moved = _kernel.move(direction, pushed);
+            if (!pushed) {
+                _streak = 0;
+            } else if (direction == _last) {
+                ++_streak;
+            } else {
+                _streak = 1;
+            }
+            _last = direction;
+            return moved;
+        }
+
+    private:
+        int _streak = 0;
+        EFacing _last = EFacing::LEFT;
+    };
+
+    // Encodes a Game driven by the same moves with the publisher's own
+    // SpectatorEncoder and applies the stream to a SpectatorGame, which keeps
+    // its own box index and target count. Acceptance and pushes are read
+    // back from what the spectator did with the stream.
+    class SpectatorEngine : public Engine, private IGameObserver {
+    public:
+        explicit SpectatorEngine(const GameMap& map) : _map(map), _encoder(&_game), _pushes(0) {
+            _game.addObserver(this);
+            _spectator.addObserver(&_pushCounter);
+            reset();
+        }
+
+        ~SpectatorEngine() override {
+            _spectator.removeObserver(&_pushCounter);
+            _game.removeObserver(this);
+        }
+
+        const char* getName() const override { return "spectator"; }
+
+        void reset() override {
+            _game.loadLevel(_map);
+            flush();
+        }
+
+        bool step(EFacing direction, bool& pushed) override {
+            int movesBefore = _spectator.getMoveCount();
+            int pushesBefore = _pushes;
+            _game.movePlayer(direction);
+            if (!flush()) {
+                // Reported as a refused move, which the reference never makes
+                // with a packet.
+                pushed = false;
+                return false;
+            }
+            pushed = _pushes != pushesBefore;
+            return _spectator.getMoveCount() != movesBefore;
+        }
+
+        Position getPlayer() override { return _spectator.getPlayerPosition(); }
+        std::vector<Position> getBoxes() override { return sorted(_spectator.getBoxPositions()); }
+        bool isSolved() override { return _spectator.getCurrentState() == EGameState::LEVEL_COMPLETED; }
+
+        // Only decoding is timed; the stream is encoded here.
+        void prepare(const Sequence& sequence) override {
+            _stream.clear();
+            _game.loadLevel(_map);
+            for (EFacing move : sequence.moves) {
+                _game.movePlayer(move);
+                if (_game.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                    _game.loadLevel(_map);
+                }
+            }
+            _stream.swap(_pending);
+        }
+
+        uint64_t run(const Sequence&) override {
+            try {
+                _spectator.feed(_stream.data(), _stream.size());
+            } catch (const std::runtime_error&) {
+                // Already reported by the lockstep run.
+            }
+            return static_cast<uint64_t>(_spectator.getMoveCount());
+        }
+
+    private:
+        class PushCounter : public IGameObserver {
+        public:
+            explicit PushCounter(int& pushes) : _pushes(pushes) {}
+            void onNotify(EGameEvent event) override {
+                if (event == EGameEvent::BOX_MOVED) {
+                    ++_pushes;
+                }
+            }
+
+        private:
+            int& _pushes;
+        };
+
+        void onNotify(EGameEvent event) override { _encoder.encode(event, _pending); }
+
+        // False when the spectator rejected the stream as corrupt.
+        bool flush() {
+            bool accepted = true;
+            try {
+                _spectator.feed(_pending.data(), _pending.size());
+            } catch (const std::runtime_error&) {
+                accepted = false;
+            }
+            _pending.clear();
+            return accepted;
+        }
+
+        GameMap _map;
+        Game _game;
+        SpectatorEncoder _encoder;
+        SpectatorGame _spectator;
+        int _pushes;
+        PushCounter _pushCounter{_pushes};
+        std::vector<uint8_t> _pending;
+        std::vector<uint8_t> _stream;
+    };
+
+    // Game rebuilt from its move history: every FullCheckInterval moves it
+    // seeks back to a random earlier move and then forward to the latest,
+    // going through the checkpoints and replaying the deltas after them.
+    class HistoryEngine : public Engine {
+    public:
+        explicit HistoryEngine(const GameMap& map) : _map(map), _random(map.getId()), _steps(0) { reset(); }
+
+        const char* getName() const override { return "history"; }
+
+        void reset() override {
+            _game.loadLevel(_map);
+            _steps = 0;
+        }
+
+        bool step(EFacing direction, bool& pushed) override {
+            int movesBefore = _game.getMoveCount();
+            _game.movePlayer(direction);
+            bool moved = _game.getMoveCount() != movesBefore;
+            pushed = moved && _game.getHistory().isPush(movesBefore);
+            roundTrip();
+            return moved;
+        }
+
+        Position getPlayer() override { return _game.getPlayerPosition(); }
+        std::vector<Position> getBoxes() override { return sorted(_game.getBoxPositions()); }
+        bool isSolved() override { return _game.getCurrentState() == EGameState::LEVEL_COMPLETED; }
+
+        uint64_t run(const Sequence& sequence) override {
+            uint64_t checksum = 0;
+            for (EFacing move : sequence.moves) {
+                _game.movePlayer(move);
+                roundTrip();
+                if (_game.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                    ++checksum;
+                    reset();
+                }
+            }
+            return checksum + static_cast<uint64_t>(_game.getMoveCount());
+        }
+
+    private:
+        void roundTrip() {
+            if (++_steps % FullCheckInterval != 0 || _game.getCurrentState() != EGameState::PLAYING) {
+                return;
+            }
+            int latest = _game.getHistoryLength();
+            _game.seekMove(_random.below(latest + 1));
+            _game.seekMove(latest);
+        }
+
+        GameMap _map;
+        Game _game;
+        Random _random;
+        size_t _steps;
+    };
+
+    std::vector<std::unique_ptr<Engine>> makeEngines(const GameMap& map, bool selfTest) {
+        std::vector<std::unique_ptr<Engine>> engines;
+        if (BoardKernel<16, 16>::fits(map)) {
+            engines.push_back(std::make_unique<KernelEngine<16, 16>>(map));
+        }
+        if (BoardKernel<32, 32>::fits(map)) {
+            engines.push_back(std::make_unique<KernelEngine<32, 32>>(map));
+        }
+        if (BoardKernel<64, 64>::fits(map)) {
+            engines.push_back(std::make_unique<KernelEngine<64, 64>>(map));
+            if (selfTest) {
+                engines.push_back(std::make_unique<BrokenKernelEngine>(map));
+            }
+        }
+        engines.push_back(std::make_unique<SpectatorEngine>(map));
+        engines.push_back(std::make_unique<HistoryEngine>(map));
+        return engines;
+    }
+
+    struct Mismatch {
+        std::string engine;
+        size_t step = 0;
+        std::string expected;
+        std::string actual;
+    };
+
+    std::string describeMove(bool accepted, bool pushed, const Position& player) {
+        return std::string(accepted ? "moved" : "blocked") + (pushed ? " with push" : "") + ", player " + describe(player);
+    }
+
+    // Replays moves on the reference and the engines side by side and
+    // returns the first divergence of each engine; an engine that diverged
+    // sits out the rest. only limits the run to one engine by name.
+    std::vector<Mismatch> lockstep(const GameMap& map, const std::vector<EFacing>& moves, bool selfTest,
+                                   const std::string& only) {
+        GameEngine reference(map);
+        std::vector<std::unique_ptr<Engine>> engines = makeEngines(map, selfTest);
+        if (!only.empty()) {
+            engines.erase(std::remove_if(engines.begin(), engines.end(),
+                                         [&only](const std::unique_ptr<Engine>& e) { return only != e->getName(); }),
+                          engines.end());
+        }
+        std::vector<uint8_t> live(engines.size(), 1);
+        std::vector<Mismatch> mismatches;
+
+        for (size_t i = 0; i < moves.size(); ++i) {
+            bool pushed;
+            bool accepted = reference.step(moves[i], pushed);
+            bool won = accepted && reference.isSolved();
+            Position player = reference.getPlayer();
+            bool fullCheck = pushed || (i + 1) % FullCheckInterval == 0 || i + 1 == moves.size();
+            std::vector<Position> boxes;
+            if (fullCheck) {
+                boxes = reference.getBoxes();
+            }
+
+            for (size_t e = 0; e < engines.size(); ++e) {
+                if (!live[e]) {
+                    continue;
+                }
+                Engine& engine = *engines[e];
+                bool enginePushed;
+                bool engineAccepted = engine.step(moves[i], enginePushed);
+                Position enginePlayer = engine.getPlayer();
+                Mismatch mismatch;
+                if (engineAccepted != accepted || enginePushed != pushed || !(enginePlayer == player)) {
+                    mismatch.expected = describeMove(accepted, pushed, player);
+                    mismatch.actual = describeMove(engineAccepted, enginePushed, enginePlayer);
+                } else if (accepted && engine.isSolved() != won) {
+                    mismatch.expected = won ? "solved" : "not solved";
+                    mismatch.actual = won ? "not solved" : "solved";
+                } else if (fullCheck) {
+                    std::vector<Position> engineBoxes = engine.getBoxes();
+                    if (engineBoxes != boxes) {
+                        mismatch.expected = "boxes " + describe(boxes);
+                        mismatch.actual = "boxes " + describe(engineBoxes);
+                    }
+                }
+                if (!mismatch.expected.empty()) {
+                    mismatch.engine = engine.getName();
+                    mismatch.step = i;
+                    mismatches.push_back(mismatch);
+                    live[e] = 0;
+                } else if (won) {
+                    engine.reset();
+                }
+            }
+            if (won) {
+                reference.reset();
+            }
+        }
+        return mismatches;
+    }
+
+    // Delta debugging: drops ever smaller chunks of moves while the engine
+    // still diverges, after cutting everything past the first divergence.
+    std::vector<EFacing> shrink(const GameMap& map, std::vector<EFacing> moves, Mismatch& mismatch, bool selfTest) {
+        auto fails = [&](const std::vector<EFacing>& candidate) {
+            std::vector<Mismatch> found = lockstep(map, candidate, selfTest, mismatch.engine);
+            if (found.empty()) {
+                return false;
+            }
+            mismatch = found.front();
+            return true;
+        };
+        moves.resize(mismatch.step + 1);
+        for (size_t chunk = std::max<size_t>(1, moves.size() / 2); chunk > 0; chunk /= 2) {
+            for (size_t start = 0; start < moves.size();) {
+                std::vector<EFacing> candidate(moves.begin(), moves.begin() + static_cast<std::ptrdiff_t>(start));
+                size_t end = std::min(moves.size(), start + chunk);
+                candidate.insert(candidate.end(), moves.begin() + static_cast<std::ptrdiff_t>(end), moves.end());
+                if (!candidate.empty() && fails(candidate)) {
+                    candidate.resize(mismatch.step + 1);
+                    moves = candidate;
+                } else {
+                    start += chunk;
+                }
+            }
+        }
+        fails(moves);
+        return moves;
+    }
+
+    std::string toLurd(const std::vector<EFacing>& moves) {
+        std::string lurd;
+        for (EFacing move : moves) {
+            lurd += Lurd::toChar(move, false);
+        }
+        return lurd;
+    }
+
+    struct EngineStats {
+        uint64_t moves = 0;
+        double nanoseconds = 0.0;
+        uint64_t sequences = 0;
+        uint64_t mismatches = 0;
+    };
+
+    struct Totals {
+        std::mutex mutex;
+        std::map<std::string, EngineStats> engines;
+        json failures = json::array();
+        std::map<std::string, int> reported;
+        uint64_t checksum = 0;
+    };
+
+    void runSequence(const TestLevel& level, uint64_t index, const ToolOptions& options, Totals& totals,
+                     std::map<std::string, EngineStats>& stats, uint64_t& checksum) {
+        EGenerator generator = static_cast<EGenerator>(index % 3);
+        uint64_t seed = options.seed * 0x100000001B3ull + index;
+        Random random(seed);
+        Sequence sequence;
+        sequence.moves = generateMoves(level.map, generator, options.length, random);
+        std::vector<Mismatch> mismatches = lockstep(level.map, sequence.moves, options.selfTest, "");
+
+        auto measure = [&](Engine& engine) {
+            engine.prepare(sequence);
+            auto start = std::chrono::steady_clock::now();
+            checksum += engine.run(sequence);
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            EngineStats& entry = stats[engine.getName()];
+            entry.moves += sequence.moves.size();
+            entry.nanoseconds += elapsed.count();
+            ++entry.sequences;
+        };
+        GameEngine reference(level.map);
+        measure(reference);
+        for (auto& engine : makeEngines(level.map, options.selfTest)) {
+            measure(*engine);
+        }
+
+        for (auto& mismatch : mismatches) {
+            ++stats[mismatch.engine].mismatches;
+            {
+                std::lock_guard<std::mutex> lock(totals.mutex);
+                if (totals.reported[mismatch.engine]++ >= MaxReportsPerEngine) {
+                    continue;
+                }
+            }
+            std::vector<EFacing> minimal = shrink(level.map, sequence.moves, mismatch, options.selfTest);
+            json failure = {
+                {"engine", mismatch.engine},
+                {"level", level.id},
+                {"generator", GeneratorNames[static_cast<int>(generator)]},
+                {"seed", seed},
+                {"originalMoves", sequence.moves.size()},
+                {"moves", toLurd(minimal)},
+                {"step", mismatch.step},
+                {"expected", mismatch.expected},
+                {"actual", mismatch.actual}
+            };
+            if (level.synthetic) {
+                failure["levelJson"] = level.source;
+            }
+            std::lock_guard<std::mutex> lock(totals.mutex);
+            totals.failures.push_back(failure);
+        }
+    }
+
+    json readJson(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + path);
+        }
+        json data;
+        file >> data;
+        return data;
+    }
+}
+
+int main(int argc, char** argv) {
+    ToolOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<TestLevel> levels;
+    json baseline = json::object();
+    try {
+        json pack = readJson(options.packPath);
+        for (const auto& source : pack["levels"]) {
+            TestLevel level;
+            level.id = source.value("id", 0);
+            level.source = source;
+            level.map.loadFromJson(source);
+            levels.push_back(std::move(level));
+        }
+        Random random(options.seed);
+        for (int i = 0; i < options.synthetic; ++i) {
+            levels.push_back(makeSyntheticLevel(i, random));
+        }
+        if (!options.baselinePath.empty()) {
+            baseline = readJson(options.baselinePath);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (levels.empty()) {
+        std::cerr << "Error: No levels to test" << std::endl;
+        return 1;
+    }
+
+    unsigned threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min<unsigned>(threadCount, static_cast<unsigned>(std::max<uint64_t>(1, options.sequences)));
+
+    Totals totals;
+    std::atomic<uint64_t> nextSequence(0);
+    std::atomic<uint64_t> finished(0);
+    auto start = std::chrono::steady_clock::now();
+    auto outOfTime = [&]() {
+        return options.seconds > 0.0 &&
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= options.seconds;
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            std::map<std::string, EngineStats> stats;
+            uint64_t checksum = 0;
+            for (uint64_t index = nextSequence++; index < options.sequences && !outOfTime(); index = nextSequence++) {
+                runSequence(levels[index % levels.size()], index, options, totals, stats, checksum);
+                ++finished;
+            }
+            std::lock_guard<std::mutex> lock(totals.mutex);
+            for (const auto& entry : stats) {
+                EngineStats& total = totals.engines[entry.first];
+                total.moves += entry.second.moves;
+                total.nanoseconds += entry.second.nanoseconds;
+                total.sequences += entry.second.sequences;
+                total.mismatches += entry.second.mismatches;
+            }
+            totals.checksum += checksum;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Engines run on different subsets of levels (kernels only where the
+    // level fits), so each is compared with the game on its own levels
+    // through ns per move rather than on totals.
+    const EngineStats& game = totals.engines["game"];
+    double gameNs = game.moves ? game.nanoseconds / game.moves : 0.0;
+    json engines = json::array();
+    json regressions = json::array();
+    uint64_t mismatches = 0;
+    for (const auto& entry : totals.engines) {
+        const EngineStats& stats = entry.second;
+        double nsPerMove = stats.moves ? stats.nanoseconds / stats.moves : 0.0;
+        json report = {
+            {"name", entry.first},
+            {"sequences", stats.sequences},
+            {"moves", stats.moves},
+            {"nsPerMove", nsPerMove},
+            {"movesPerSecondPerThread", nsPerMove > 0.0 ? 1e9 / nsPerMove : 0.0},
+            {"speedupOverGame", nsPerMove > 0.0 ? gameNs / nsPerMove : 0.0},
+            {"mismatches", stats.mismatches}
+        };
+        mismatches += stats.mismatches;
+
+        for (const auto& previous : baseline.value("engines", json::array())) {
+            if (previous.value("name", "") != entry.first || nsPerMove <= 0.0) {
+                continue;
+            }
+            double before = previous.value("movesPerSecondPerThread", 0.0);
+            double now = 1e9 / nsPerMove;
+            if (before > 0.0 && now < before * (1.0 - options.tolerance / 100.0)) {
+                regressions.push_back({{"name", entry.first}, {"movesPerSecondPerThread", now}, {"baseline", before}});
+            }
+        }
+        engines.push_back(report);
+    }
+
+    json output;
+    output["pack"] = options.packPath;
+    output["levels"] = levels.size();
+    output["syntheticLevels"] = options.synthetic;
+    output["sequences"] = finished.load();
+    output["movesPerSequence"] = options.length;
+    output["threads"] = threadCount;
+    output["seconds"] = seconds;
+    output["engines"] = engines;
+    output["mismatches"] = mismatches;
+    output["failures"] = totals.failures;
+    if (!options.baselinePath.empty()) {
+        output["tolerancePercent"] = options.tolerance;
+        output["regressions"] = regressions;
+    }
+    output["checksum"] = totals.checksum;
+    if (!options.outputPath.empty()) {
+        std::ofstream file(options.outputPath);
+        file << output.dump(2) << std::endl;
+    }
+    std::cout << output.dump(2) << std::endl;
+
+    // The planted bug must be caught, and nothing else may diverge.
+    if (options.selfTest) {
+        bool caught = totals.engines["broken-kernel"].mismatches > 0;
+        return caught && mismatches == totals.engines["broken-kernel"].mismatches && regressions.empty() ? 0 : 1;
+    }
+    return mismatches == 0 && regressions.empty() ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include <telemetry/TelemetryReader.h>
+#include <telemetry/TelemetryRecorder.h>
+
+using json = nlohmann::json;
+
+namespace {
+    void printUsage() {
+        std::cout << "Usage: SokobanTelemetry <telemetry.bin> [--format csv|json] [--summary]\n"
+                     "       SokobanTelemetry --benchmark [EVENTS]\n";
+    }
+
+    void printEvents(const TelemetryLog& log, bool asJson) {
+        if (!asJson) {
+            std::cout << "timeNs,event,level,moveCount,playerRow,playerCol,boxRow,boxCol\n";
+        }
+        for (const auto& event : log.events) {
+            if (asJson) {
+                json line = {
+                    {"timeNs", event.timestampNs},
+                    {"event", TelemetryReader::eventName(event.type)},
+                    {"level", event.level},
+                    {"moveCount", event.moveCount},
+                    {"player", {event.playerRow, event.playerCol}}
+                };
+                if (event.boxRow >= 0) {
+                    line["box"] = {event.boxRow, event.boxCol};
+                }
+                std::cout << line.dump() << "\n";
+            } else {
+                std::cout << event.timestampNs << ',' << TelemetryReader::eventName(event.type) << ','
+                          << event.level << ',' << event.moveCount << ',' << event.playerRow << ','
+                          << event.playerCol << ',' << event.boxRow << ',' << event.boxCol << "\n";
+            }
+        }
+    }
+
+    void printSummary(const TelemetryLog& log) {
+        std::map<std::string, uint64_t> counts;
+        std::set<int> levels;
+        for (const auto& event : log.events) {
+            ++counts[TelemetryReader::eventName(event.type)];
+            levels.insert(event.level);
+        }
+        double seconds = log.events.empty() ? 0.0 : log.events.back().timestampNs / 1e9;
+
+        json summary;
+        summary["startEpochNs"] = log.startEpochNs;
+        summary["events"] = log.events.size();
+        summary["eventCounts"] = counts;
+        summary["levels"] = levels;
+        summary["durationSeconds"] = seconds;
+        summary["movesPerSecond"] = seconds > 0.0 ? counts["PLAYER_MOVED"] / seconds : 0.0;
+        summary["truncated"] = log.truncated;
+        std::cout << summary.dump(2) << std::endl;
+    }
+
+    int runBenchmark(uint64_t events) {
+        std::string path = (std::filesystem::temp_directory_path() / "sokoban-telemetry-bench.bin").string();
+        const uint64_t capacity = 1 << 16;
+        double recordNs = 0.0;
+        uint64_t dropped;
+        {
+            TelemetryRecorder recorder(path, capacity, 1000);
+            // Bursts of half the ring, flushing in between, so only record()
+            // is timed and nothing is dropped.
+            for (uint64_t done = 0; done < events;) {
+                uint64_t burst = std::min(capacity / 2, events - done);
+                auto start = std::chrono::steady_clock::now();
+                for (uint64_t i = done; i < done + burst; ++i) {
+                    int col = static_cast<int>(i % 16);
+                    recorder.record(EGameEvent::PLAYER_MOVED, 1, static_cast<int>(i), Position(3, col),
+                                    Position(-1, -1));
+                }
+                std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                recordNs += elapsed.count();
+                done += burst;
+                recorder.flush();
+                while (recorder.getWrittenCount() + recorder.getDroppedCount() < done) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+            dropped = recorder.getDroppedCount();
+        }
+        double nsPerEvent = recordNs / static_cast<double>(std::max<uint64_t>(events, 1));
+        uint64_t bytes = std::filesystem::file_size(path);
+        std::filesystem::remove(path);
+
+        std::cout << "record(): " << nsPerEvent << " ns/event, " << dropped << " of " << events
+                  << " dropped, " << bytes << " bytes on disk\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    bool asJson = false;
+    bool summary = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--benchmark") {
+            uint64_t events = i + 1 < argc ? std::stoull(argv[i + 1]) : 10000000;
+            return runBenchmark(events);
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format != "csv" && format != "json") {
+                printUsage();
+                return 2;
+            }
+            asJson = format == "json";
+        } else if (arg == "--summary") {
+            summary = true;
+        } else if (!arg.empty() && arg[0] != '-' && path.empty()) {
+            path = arg;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    try {
+        TelemetryLog log = TelemetryReader::read(path);
+        if (summary) {
+            printSummary(log);
+        } else {
+            printEvents(log, asJson);
+        }
+        if (log.truncated) {
+            std::cerr << "Warning: last record is incomplete\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -4,21 +4,33 @@
 #include <interfaces/IGame.h>
 #include <interfaces/IGameObserver.h>
 #include <enums/EGameEvent.h>
+#include <FixedTimestep.h>
+#include <InputQueue.h>
+#include <solver/HintEngine.h>
 #include <raylib.h>
+#include "SpriteAtlas.h"
+#include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 class GUI_View : public IGameObserver {
 public:
     explicit GUI_View(IGame* game);
     ~GUI_View();
     
-    void initialize(int screenWidth, int screenHeight);
+    // Uncapped rendering draws as fast as possible and shows the frame rate.
+    void initialize(int screenWidth, int screenHeight, bool uncapped = false);
     
     void onNotify(EGameEvent event) override;
     
     void render();
     
+    // Queues every key pressed since the last frame.
     void handleInput();
+
+    // Runs the logic ticks due after frameSeconds, applying every queued command.
+    void update(float frameSeconds);
     
     bool shouldClose() const;
     
@@ -41,20 +53,50 @@ private:
     Color _boxOnTargetColor;
     Color _playerColor;
 
-    Texture2D _carTexture;
-    Texture2D _parkingTexture;
+    // Decoded on worker threads while the window opens; only packing them
+    // into the atlas and the upload happen on the main thread.
+    std::future<Image> _carImage;
+    std::future<Image> _parkingImage;
+    std::future<void> _levelPrefetch;
+    SpriteAtlas _atlas;
+    // Reused every frame for the tile, box and player layers.
+    SpriteBatch _batch;
 
     std::string _statusMessage;
     bool _isInitialized;
+    bool _uncapped;
     int _currentLevel;
+
+    InputQueue _inputQueue;
+    FixedTimestep _timestep;
+    // Positions before the last tick; drawing blends them with the current ones.
+    Position _previousPlayer;
+    std::vector<Position> _previousBoxes;
+
+    // Declared before the engine so it outlives the worker thread.
+    std::unique_ptr<SolutionCache> _solutionCache;
+    HintEngine _hintEngine;
+    bool _hintsEnabled;
+    bool _hintRequestPending;
+    // The timeline slider is being dragged.
+    bool _scrubbing;
     
-    void drawTile(int row, int col, ETileType tileType);
-    void drawPlayer(Position playerPos);
-    void drawBox(Position boxPos, bool onTarget);
+    void buildAtlas();
+    void drawHint();
+    void drawTimeline();
     void drawUI();
+    void handleTimelineInput();
+    Rectangle getTimelineBounds() const;
+    void updateHints();
+    void applyCommand(EInputCommand command);
+    void snapAnimation();
     void calculateOffsets();
     void loadNextLevel();
+    void reloadEditedLevel();
+    void fitTileSize();
+    void prefetchNextLevel();
     Vector2 getTileScreenPosition(int row, int col) const;
+    Vector2 getInterpolatedScreenPosition(Position from, Position to, float alpha) const;
 };
 
 #endif
\ No newline at end of file
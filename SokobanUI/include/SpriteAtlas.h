@@ -0,0 +1,72 @@
+#ifndef SOKOBANGAME_SPRITEATLAS_H
+#define SOKOBANGAME_SPRITEATLAS_H
+
+#include <raylib.h>
+#include <array>
+#include <vector>
+
+enum class ESprite {
+    WALL,
+    FLOOR,
+    TARGET,
+    BOX,
+    BOX_ON_TARGET,
+    PLAYER,
+};
+
+struct SpritePalette {
+    Color wall;
+    Color floor;
+    Color target;
+    Color box;
+    Color boxOnTarget;
+    Color player;
+};
+
+// Every sprite the board needs, painted once at startup into a single
+// texture: tiles, boxes and the player. The car and parking-spot images are
+// copied in when they loaded; otherwise the shapes drawn in their place are.
+class SpriteAtlas {
+public:
+    static constexpr int SpriteSize = 64;
+    static constexpr int SpriteCount = 6;
+
+    SpriteAtlas();
+
+    // Needs the window; the images are only read.
+    void build(const Image& car, const Image& parking, const SpritePalette& palette);
+    void unload();
+
+    bool isReady() const { return _texture.id != 0; }
+    const Texture2D& getTexture() const { return _texture; }
+    Rectangle getSource(ESprite sprite) const { return _sources[static_cast<int>(sprite)]; }
+
+private:
+    Texture2D _texture;
+    std::array<Rectangle, SpriteCount> _sources;
+};
+
+// Collects the quads of one layer and hands them to rlgl in one run, so a
+// layer costs one texture bind and as few draw calls as the batch buffer
+// allows, however many sprites it has. Quads outside the view are dropped.
+class SpriteBatch {
+public:
+    explicit SpriteBatch(const SpriteAtlas& atlas);
+
+    void begin(float viewWidth, float viewHeight);
+    void add(ESprite sprite, Rectangle dest);
+    void flush();
+
+private:
+    struct Quad {
+        Rectangle source;
+        Rectangle dest;
+    };
+
+    const SpriteAtlas& _atlas;
+    std::vector<Quad> _quads;
+    float _viewWidth;
+    float _viewHeight;
+};
+
+#endif
@@ -1,40 +1,189 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include "include/GUI_View.h"
 #include <Game.h>
+#include <FixedTimestep.h>
+#include <InputQueue.h>
+#include <LevelIndex.h>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <spectator/SpectatorPublisher.h>
+#include <telemetry/TelemetryRecorder.h>
 
-int main()
+namespace {
+    // An open room with the given number of boxes on a diagonal lattice and
+    // as many targets next to them, for checking frame times on huge levels.
+    GameMap makeStressLevel(int boxes) {
+        int side = static_cast<int>(std::ceil(std::sqrt(boxes * 3.0))) + 4;
+        nlohmann::json grid = nlohmann::json::array();
+        nlohmann::json boxPositions = nlohmann::json::array();
+        int targets = 0;
+        for (int row = 0; row < side; ++row) {
+            nlohmann::json line = nlohmann::json::array();
+            for (int col = 0; col < side; ++col) {
+                bool border = row == 0 || col == 0 || row == side - 1 || col == side - 1;
+                bool interior = row > 1 && col > 1 && row < side - 2 && col < side - 2;
+                int tile = border ? 2 : 0;
+                if (interior && (row + col) % 3 == 0 && static_cast<int>(boxPositions.size()) < boxes) {
+                    boxPositions.push_back({{"row", row}, {"col", col}});
+                } else if (interior && (row + col) % 3 == 1 && targets < boxes) {
+                    tile = 1;
+                    ++targets;
+                }
+                line.push_back(tile);
+            }
+            grid.push_back(line);
+        }
+
+        GameMap map;
+        map.loadFromJson({
+            {"id", 1},
+            {"name", "Generated"},
+            {"width", side},
+            {"height", side},
+            {"grid", grid},
+            {"playerStart", {{"row", 1}, {"col", 1}}},
+            {"boxPositions", boxPositions}
+        });
+        return map;
+    }
+
+    // Drives the logic loop without a window, feeding pseudo-random moves as
+    // fast as possible, to profile the game logic on its own.
+    void runHeadless(Game& game, long ticks) {
+        FixedTimestep timestep;
+        InputQueue queue;
+        uint32_t seed = 12345;
+        long moves = 0;
+        long wins = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (long tick = 0; tick < ticks; tick += timestep.advance(timestep.getTickSeconds())) {
+            seed = seed * 1664525u + 1013904223u;
+            queue.push(static_cast<EInputCommand>((seed >> 16) % 4));
+
+            EInputCommand command;
+            EFacing direction;
+            if (queue.pop(command) && InputQueue::toFacing(command, direction)) {
+                int before = game.getMoveCount();
+                game.movePlayer(direction);
+                moves += game.getMoveCount() - before;
+            }
+            if (game.getCurrentState() == EGameState::LEVEL_COMPLETED) {
+                ++wins;
+                game.restartLevel();
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Headless: " << ticks << " ticks, " << moves << " moves, " << wins << " wins in "
+                  << elapsed.count() << " s (" << ticks / std::max(elapsed.count(), 1e-9) << " ticks/s)\n";
+    }
+}
+
+int main(int argc, char** argv)
 {
+    bool headless = false;
+    bool uncapped = false;
+    long headlessTicks = 1000000;
+    int generatedBoxes = 0;
+    std::string telemetryPath;
+    std::string broadcastPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--uncapped") == 0) {
+            uncapped = true;
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            headlessTicks = std::stol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            generatedBoxes = std::stoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--broadcast") == 0 && i + 1 < argc) {
+            broadcastPath = argv[++i];
+        } else {
+            std::cerr << "Usage: SokobanUI [--uncapped] [--headless [--ticks N]] [--telemetry FILE]"
+                         " [--generate BOXES] [--broadcast SOCKET]\n";
+            return 2;
+        }
+    }
+
     try {
+        std::unique_ptr<TelemetryRecorder> telemetry;
+        if (!telemetryPath.empty()) {
+            telemetry = std::make_unique<TelemetryRecorder>(telemetryPath);
+        }
+
+        if (headless) {
+            Game game;
+            game.setTelemetry(telemetry.get());
+            if (generatedBoxes > 0) {
+                game.loadLevel(makeStressLevel(generatedBoxes));
+            } else {
+                game.loadLevel(1);
+            }
+            runHeadless(game, headlessTicks);
+            return 0;
+        }
+
+
         std::cout << "=== Sokoban Game - Observer Pattern Demo ===\n";
         std::cout << "Backend developed by your colleague\n";
         std::cout << "Frontend (Observer) implementation\n\n";
         
         Game game;
+        game.setTelemetry(telemetry.get());
         std::cout << "Game (Subject) created\n";
         
-        game.loadLevel(1);
-        std::cout << "Level 1 loaded\n";
-        
+        // Created first so its textures decode while the level loads.
         GUI_View view(&game);
         std::cout << "GUI_View (Observer) created\n";
         
+        if (generatedBoxes > 0) {
+            game.loadLevel(makeStressLevel(generatedBoxes));
+            std::cout << "Generated level with " << generatedBoxes << " boxes loaded\n";
+        } else {
+            game.loadLevel(1);
+            std::cout << "Level 1 loaded\n";
+        }
+        
         game.addObserver(&view);
         std::cout << "Observer registered with Subject\n\n";
+
+        // Spectators connect with SokobanTerminal --watch.
+        std::unique_ptr<SpectatorPublisher> publisher;
+        if (!broadcastPath.empty()) {
+            publisher = std::make_unique<SpectatorPublisher>(&game, broadcastPath);
+            game.addObserver(publisher.get());
+            std::cout << "Broadcasting to spectators on " << broadcastPath << "\n";
+        }
+
+        // Edits to levels.json show up without restarting.
+        LevelIndex::shared().startWatching();
         
-        view.initialize(800, 600);
+        view.initialize(800, 600, uncapped);
         
         std::cout << "Controls:\n";
         std::cout << "  Arrow Keys / WASD - Move player\n";
         std::cout << "  R - Restart level\n";
+        std::cout << "  N - Next level\n";
+        std::cout << "  H - Toggle hints\n";
         std::cout << "  ESC - Exit game\n\n";
         
         while (!view.shouldClose()) {
             view.handleInput();
+
+            view.update(GetFrameTime());
             
             view.render();
         }
         
         game.removeObserver(&view);
+        game.removeObserver(publisher.get());
         std::cout << "\nObserver unregistered from Subject\n";
         
         view.cleanup();
@@ -1,4 +1,6 @@
 #include "GUI_View.h"
+#include <GameMap.h>
+#include <LevelIndex.h>
 #include <iostream>
 #include <algorithm>
 
@@ -9,9 +11,15 @@ GUI_View::GUI_View(IGame* game)
       _tileSize(48),
       _offsetX(0),
       _offsetY(0),
+      _batch(_atlas),
       _isInitialized(false),
+      _uncapped(false),
       _currentLevel(1),
-      _statusMessage("Use Arrow Keys to move. R to restart.")
+      _previousPlayer(0, 0),
+      _statusMessage("Use Arrow Keys to move. R to restart."),
+      _hintsEnabled(false),
+      _hintRequestPending(false),
+      _scrubbing(false)
 {
     _wallColor = Color{100, 100, 100, 255};
     _floorColor = Color{220, 200, 150, 255};
@@ -19,45 +27,51 @@ GUI_View::GUI_View(IGame* game)
     _boxColor = Color{255, 165, 0, 255};
     _boxOnTargetColor = Color{200, 100, 0, 255};
     _playerColor = Color{70, 130, 180, 255};
+
+    // Image decoding needs no GL context, so it can start before the window exists.
+    _carImage = std::async(std::launch::async, LoadImage, "assets/car.png");
+    _parkingImage = std::async(std::launch::async, LoadImage, "assets/parking_spot.png");
 }
 
 GUI_View::~GUI_View() {
     cleanup();
 }
 
-void GUI_View::initialize(int screenWidth, int screenHeight) {
+void GUI_View::initialize(int screenWidth, int screenHeight, bool uncapped) {
     _screenWidth = screenWidth;
     _screenHeight = screenHeight;
+    _uncapped = uncapped;
     
     InitWindow(_screenWidth, _screenHeight, "Sokoban Game - Observer Pattern Demo");
-    SetTargetFPS(60);
+    SetTargetFPS(_uncapped ? 0 : 60);
 
-    _carTexture = LoadTexture("assets/car.png");
-    _parkingTexture = LoadTexture("assets/parking_spot.png");
+    buildAtlas();
 
-    if (_carTexture.id == 0) std::cout << "WARNING: assets/car.png not found" << std::endl;
-    if (_parkingTexture.id == 0) std::cout << "WARNING: assets/parking_spot.png not found" << std::endl;
+    try {
+        _solutionCache = std::make_unique<SolutionCache>("solutions.cache");
+        _hintEngine.setCache(_solutionCache.get());
+    } catch (const std::exception& e) {
+        std::cout << "WARNING: hints will not be cached: " << e.what() << std::endl;
+    }
 
     if (_gameLogic) {
-        int mapWidth = _gameLogic->getLevelWidth();
-        int mapHeight = _gameLogic->getLevelLength();
-
-        int maxTileWidth = (_screenWidth - 100) / mapWidth;
-        int maxTileHeight = (_screenHeight - 150) / mapHeight;
-        _tileSize = std::min(maxTileWidth, maxTileHeight);
-        _tileSize = std::max(32, std::min(_tileSize, 64));
-
-        calculateOffsets();
+        fitTileSize();
+        snapAnimation();
     }
 
+    prefetchNextLevel();
+
     _isInitialized = true;
     std::cout << "GUI_View initialized as Observer\n";
 }
 
 void GUI_View::cleanup() {
+    // Never uploaded when the window was not opened.
+    if (_carImage.valid()) UnloadImage(_carImage.get());
+    if (_parkingImage.valid()) UnloadImage(_parkingImage.get());
+
     if (_isInitialized && IsWindowReady()) {
-        UnloadTexture(_carTexture);
-        UnloadTexture(_parkingTexture);
+        _atlas.unload();
 
         CloseWindow();
         _isInitialized = false;
@@ -74,15 +88,30 @@ void GUI_View::onNotify(EGameEvent event) {
 
         case EGameEvent::LEVEL_RELOADED:
             _statusMessage = "Level Loaded! Use Arrow Keys to move.";
+            _hintEngine.cancel();
+            _hintRequestPending = _hintsEnabled;
             calculateOffsets();
+            snapAnimation();
             std::cout << "Observer notified: LEVEL_RELOADED\n";
             break;
 
         case EGameEvent::PLAYER_MOVED:
+            _hintRequestPending = _hintsEnabled;
             break;
 
         case EGameEvent::BOX_MOVED:
             break;
+
+        case EGameEvent::HISTORY_SEEKED:
+            _statusMessage = "Move " + std::to_string(_gameLogic->getMoveCount()) + " of " +
+                             std::to_string(_gameLogic->getHistoryLength());
+            _hintRequestPending = _hintsEnabled;
+            snapAnimation();
+            break;
+
+        case EGameEvent::LEVEL_SOURCE_CHANGED:
+            reloadEditedLevel();
+            break;
     }
 }
 
@@ -96,122 +125,126 @@ void GUI_View::render() {
 
     int mapWidth = _gameLogic->getLevelWidth();
     int mapHeight = _gameLogic->getLevelLength();
+    const float tileSize = (float)_tileSize;
 
+    // One batched submission per layer: tiles, boxes, then the player.
+    _batch.begin((float)_screenWidth, (float)_screenHeight);
     for (int row = 0; row < mapHeight; row++) {
         for (int col = 0; col < mapWidth; col++) {
-            Position pos(row, col);
-            ETileType tileType = _gameLogic->getTileAt(pos);
-            drawTile(row, col, tileType);
+            ETileType tileType = _gameLogic->getTileAt(Position(row, col));
+            ESprite sprite = tileType == ETileType::WALL ? ESprite::WALL
+                           : tileType == ETileType::TARGET ? ESprite::TARGET
+                           : ESprite::FLOOR;
+            Vector2 screenPos = getTileScreenPosition(row, col);
+            _batch.add(sprite, Rectangle{screenPos.x, screenPos.y, tileSize, tileSize});
         }
     }
-
-    auto boxPositions = _gameLogic->getBoxPositions();
-    for (const auto& boxPos : boxPositions) {
-        ETileType tileType = _gameLogic->getTileAt(boxPos);
-        bool onTarget = (tileType == ETileType::TARGET);
-        drawBox(boxPos, onTarget);
+    _batch.flush();
+
+    float alpha = _timestep.getAlpha();
+    const auto& boxPositions = _gameLogic->getBoxPositions();
+    bool animateBoxes = boxPositions.size() == _previousBoxes.size();
+    for (size_t i = 0; i < boxPositions.size(); ++i) {
+        const Position& boxPos = boxPositions[i];
+        bool onTarget = _gameLogic->getTileAt(boxPos) == ETileType::TARGET;
+        Position from = animateBoxes ? _previousBoxes[i] : boxPos;
+        Vector2 screenPos = getInterpolatedScreenPosition(from, boxPos, alpha);
+        _batch.add(onTarget ? ESprite::BOX_ON_TARGET : ESprite::BOX, Rectangle{screenPos.x, screenPos.y, tileSize, tileSize});
     }
+    _batch.flush();
 
     Position playerPos = _gameLogic->getPlayerPosition();
-    drawPlayer(playerPos);
+    Vector2 playerScreenPos = getInterpolatedScreenPosition(_previousPlayer, playerPos, alpha);
+    _batch.add(ESprite::PLAYER, Rectangle{playerScreenPos.x, playerScreenPos.y, tileSize, tileSize});
+    _batch.flush();
 
+    drawHint();
+    drawTimeline();
     drawUI();
 
     EndDrawing();
 }
 
-void GUI_View::drawTile(int row, int col, ETileType tileType) {
-    Vector2 screenPos = getTileScreenPosition(row, col);
-    Rectangle tileRect = {screenPos.x, screenPos.y, (float)_tileSize, (float)_tileSize};
-
-    Vector2 origin = {0,0};
-
-    switch(tileType) {
-        case ETileType::WALL:
-            DrawRectangleRec(tileRect, _wallColor);
-            for (int i = 0; i < 3; i++) {
-                for (int j = 0; j < 3; j++) {
-                    int stoneSize = _tileSize / 4;
-                    Rectangle stone = {
-                        screenPos.x + (i * stoneSize * 1.1f) + 2,
-                        screenPos.y + (j * stoneSize * 1.1f) + 2,
-                        (float)stoneSize - 2,
-                        (float)stoneSize - 2
-                    };
-                    DrawRectangleRec(stone, Color{80, 80, 80, 255});
-                    DrawRectangleLinesEx(stone, 1, Color{60, 60, 60, 255});
-                }
-            }
-            break;
-
-        case ETileType::PATH:
-            DrawRectangleRec(tileRect, _floorColor);
-            DrawRectangleLinesEx(tileRect, 1, Color{200, 180, 130, 255});
-            break;
-
-        case ETileType::TARGET:
-            DrawRectangleRec(tileRect, _floorColor);
+void GUI_View::buildAtlas() {
+    Image car = _carImage.get();
+    Image parking = _parkingImage.get();
+    if (car.data == nullptr) std::cout << "WARNING: assets/car.png not found" << std::endl;
+    if (parking.data == nullptr) std::cout << "WARNING: assets/parking_spot.png not found" << std::endl;
 
-            if (_parkingTexture.id != 0) {
-                Rectangle sourceRec = { 0.0f, 0.0f, (float)_parkingTexture.width, (float)_parkingTexture.height };
-                DrawTexturePro(_parkingTexture, sourceRec, tileRect, origin, 0.0f, WHITE);
-            } else {
-                Vector2 center = {screenPos.x + _tileSize/2.0f, screenPos.y + _tileSize/2.0f};
-                DrawCircle(center.x, center.y, _tileSize/3.0f, _targetColor);
-            }
+    SpritePalette palette = {_wallColor, _floorColor, _targetColor, _boxColor, _boxOnTargetColor, _playerColor};
+    _atlas.build(car, parking, palette);
 
-            DrawRectangleLinesEx(tileRect, 1, Color{200, 180, 130, 255});
-            break;
-    }
+    if (car.data != nullptr) UnloadImage(car);
+    if (parking.data != nullptr) UnloadImage(parking);
 }
 
-void GUI_View::drawPlayer(Position playerPos) {
-    Vector2 screenPos = getTileScreenPosition(playerPos.getRow(), playerPos.getCol());
-    Vector2 center = {screenPos.x + _tileSize/2.0f, screenPos.y + _tileSize/2.0f};
-
-    float playerSize = _tileSize * 0.6f;
+void GUI_View::drawHint() {
+    if (!_hintsEnabled) {
+        return;
+    }
 
-    DrawCircle(center.x, center.y + playerSize/6, playerSize/3, _playerColor);
+    Hint hint;
+    if (!_hintEngine.getHint(hint)) {
+        return;
+    }
+    if (hint.deadlocked) {
+        DrawText("Hint: this position can no longer be solved, press R", 10, 50, 20, RED);
+        return;
+    }
+    if (!hint.available) {
+        return;
+    }
 
-    DrawCircle(center.x, center.y - playerSize/4, playerSize/4, BROWN);
+    Vector2 screenPos = getTileScreenPosition(hint.box.getRow(), hint.box.getCol());
+    Rectangle boxRect = {screenPos.x, screenPos.y, (float)_tileSize, (float)_tileSize};
+    DrawRectangleLinesEx(boxRect, 3, GREEN);
 
-    DrawCircle(center.x - playerSize/10, center.y - playerSize/4 - 2, 2, BLACK);
-    DrawCircle(center.x + playerSize/10, center.y - playerSize/4 - 2, 2, BLACK);
+    Vector2 center = {screenPos.x + _tileSize/2.0f, screenPos.y + _tileSize/2.0f};
+    Vector2 tip = center;
+    switch (hint.direction) {
+        case EFacing::UP:
+            tip.y -= _tileSize;
+            break;
+        case EFacing::DOWN:
+            tip.y += _tileSize;
+            break;
+        case EFacing::LEFT:
+            tip.x -= _tileSize;
+            break;
+        case EFacing::RIGHT:
+            tip.x += _tileSize;
+            break;
+    }
+    DrawLineEx(center, tip, 4, GREEN);
+    DrawCircleV(tip, _tileSize/8.0f, GREEN);
 
-    DrawRectangle(center.x - playerSize/8, center.y + playerSize/3, playerSize/7, playerSize/4, _playerColor);
-    DrawRectangle(center.x + playerSize/16, center.y + playerSize/3, playerSize/7, playerSize/4, _playerColor);
+    std::string hintText = "Hint: " + std::to_string(hint.pushesLeft) + " pushes left";
+    DrawText(hintText.c_str(), 10, 50, 20, GREEN);
 }
 
-void GUI_View::drawBox(Position boxPos, bool onTarget) {
-    Vector2 screenPos = getTileScreenPosition(boxPos.getRow(), boxPos.getCol());
-
-    Rectangle boxRect = {
-        screenPos.x,
-        screenPos.y,
-        (float)_tileSize,
-        (float)_tileSize
-    };
-
-    DrawRectangleRec(boxRect, _floorColor);
+void GUI_View::updateHints() {
+    if (_hintRequestPending && _gameLogic) {
+        _hintEngine.request(GameMap::capture(*_gameLogic), _gameLogic->getMoveCount() == 0);
+        _hintRequestPending = false;
+    }
+}
 
-    if (_carTexture.id != 0) {
-        Rectangle sourceRec = { 0.0f, 0.0f, (float)_carTexture.width, (float)_carTexture.height };
-        Vector2 origin = { 0.0f, 0.0f };
+void GUI_View::drawTimeline() {
+    int historyLength = _gameLogic->getHistoryLength();
+    if (historyLength == 0) {
+        return;
+    }
 
-        Color tint = onTarget ? GREEN : WHITE;
+    Rectangle bounds = getTimelineBounds();
+    float fraction = static_cast<float>(_gameLogic->getMoveCount()) / historyLength;
+    Rectangle played = {bounds.x, bounds.y, bounds.width * fraction, bounds.height};
+    DrawRectangleRec(bounds, Color{30, 30, 30, 200});
+    DrawRectangleRec(played, _scrubbing ? YELLOW : BLUE);
+    DrawCircleV(Vector2{bounds.x + played.width, bounds.y + bounds.height / 2}, bounds.height, WHITE);
+}
 
-        DrawTexturePro(_carTexture, sourceRec, boxRect, origin, 0.0f, WHITE);
-    }
-    else {
-        Color boxColor = onTarget ? _boxOnTargetColor : _boxColor;
-        float boxPadding = _tileSize * 0.1f;
-        Rectangle innerRect = {
-             screenPos.x + boxPadding, screenPos.y + boxPadding,
-             _tileSize - 2*boxPadding, _tileSize - 2*boxPadding
-        };
-        DrawRectangleRec(innerRect, boxColor);
-        DrawRectangleLinesEx(innerRect, 2, Color{150, 80, 0, 255});
-    }
+Rectangle GUI_View::getTimelineBounds() const {
+    return Rectangle{20.0f, (float)(_screenHeight - 58), (float)(_screenWidth - 40), 8.0f};
 }
 
 void GUI_View::drawUI() {
@@ -227,32 +260,138 @@ void GUI_View::drawUI() {
     DrawText(_statusMessage.c_str(), 300, 10, 20, YELLOW);
 
     DrawRectangle(0, _screenHeight - 40, _screenWidth, 40, Color{30, 30, 30, 255});
-    DrawText("Arrow/WASD: Move | R: Restart | N: Next Level | ESC: Exit", 10, _screenHeight - 30, 20, LIGHTGRAY);
+    DrawText("Arrow/WASD: Move | R: Restart | N: Next Level | H: Hint | ESC: Exit", 10, _screenHeight - 30, 20, LIGHTGRAY);
+
+    if (_uncapped) {
+        std::string fpsText = "FPS: " + std::to_string(GetFPS());
+        DrawText(fpsText.c_str(), _screenWidth - 110, _screenHeight - 30, 20, GREEN);
+    }
 }
 
 void GUI_View::handleInput() {
     if (!_gameLogic) return;
 
-    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
-        _gameLogic->movePlayer(EFacing::UP);
+    // GetKeyPressed returns every press since the last frame in order, so
+    // several keys in one frame are all kept.
+    for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+        switch (key) {
+            case KEY_UP:
+            case KEY_W:
+                _inputQueue.push(EInputCommand::MOVE_UP);
+                break;
+            case KEY_DOWN:
+            case KEY_S:
+                _inputQueue.push(EInputCommand::MOVE_DOWN);
+                break;
+            case KEY_LEFT:
+            case KEY_A:
+                _inputQueue.push(EInputCommand::MOVE_LEFT);
+                break;
+            case KEY_RIGHT:
+            case KEY_D:
+                _inputQueue.push(EInputCommand::MOVE_RIGHT);
+                break;
+            case KEY_R:
+                _inputQueue.push(EInputCommand::RESTART);
+                break;
+            case KEY_N:
+                _inputQueue.push(EInputCommand::NEXT_LEVEL);
+                break;
+            case KEY_H:
+                _inputQueue.push(EInputCommand::TOGGLE_HINT);
+                break;
+            default:
+                break;
+        }
     }
-    else if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
-        _gameLogic->movePlayer(EFacing::DOWN);
+
+    handleTimelineInput();
+}
+
+void GUI_View::handleTimelineInput() {
+    int historyLength = _gameLogic->getHistoryLength();
+    if (historyLength == 0) {
+        _scrubbing = false;
+        return;
     }
-    else if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) {
-        _gameLogic->movePlayer(EFacing::LEFT);
+
+    Rectangle bounds = getTimelineBounds();
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        _scrubbing = mouse.x >= bounds.x && mouse.x <= bounds.x + bounds.width &&
+                     mouse.y >= bounds.y - 6 && mouse.y <= bounds.y + bounds.height + 6;
+    } else if (!IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+        _scrubbing = false;
     }
-    else if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) {
-        _gameLogic->movePlayer(EFacing::RIGHT);
+    if (!_scrubbing) {
+        return;
     }
 
-    if (IsKeyPressed(KEY_R)) {
-        _gameLogic->restartLevel();
+    // Seeking costs one checkpoint restore plus a short replay, so it is
+    // cheap enough to do on every frame of the drag.
+    float fraction = std::max(0.0f, std::min(1.0f, (mouse.x - bounds.x) / bounds.width));
+    int moveIndex = static_cast<int>(fraction * historyLength + 0.5f);
+    if (moveIndex != _gameLogic->getMoveCount()) {
+        _gameLogic->seekMove(moveIndex);
     }
+}
+
+void GUI_View::update(float frameSeconds) {
+    if (!_gameLogic) return;
 
-    if (IsKeyPressed(KEY_N)) {
-        loadNextLevel();
+    _gameLogic->checkLevelSource();
+
+    int ticks = _timestep.advance(frameSeconds);
+    for (int tick = 0; tick < ticks; ++tick) {
+        _previousPlayer = _gameLogic->getPlayerPosition();
+        _previousBoxes = _gameLogic->getBoxPositions();
+
+        // Every key queued since the last tick is applied, so fast typing
+        // never falls behind; earlier steps of a burst snap into place and
+        // only the last one is animated.
+        EInputCommand command;
+        while (_inputQueue.pop(command)) {
+            _previousPlayer = _gameLogic->getPlayerPosition();
+            _previousBoxes = _gameLogic->getBoxPositions();
+            applyCommand(command);
+        }
     }
+
+    updateHints();
+}
+
+void GUI_View::applyCommand(EInputCommand command) {
+    EFacing direction;
+    if (InputQueue::toFacing(command, direction)) {
+        _gameLogic->movePlayer(direction);
+        return;
+    }
+
+    switch (command) {
+        case EInputCommand::RESTART:
+            _gameLogic->restartLevel();
+            break;
+        case EInputCommand::NEXT_LEVEL:
+            loadNextLevel();
+            break;
+        case EInputCommand::TOGGLE_HINT:
+            _hintsEnabled = !_hintsEnabled;
+            if (_hintsEnabled) {
+                _hintRequestPending = true;
+            } else {
+                _hintEngine.cancel();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void GUI_View::snapAnimation() {
+    if (!_gameLogic) return;
+
+    _previousPlayer = _gameLogic->getPlayerPosition();
+    _previousBoxes = _gameLogic->getBoxPositions();
 }
 
 bool GUI_View::shouldClose() const {
@@ -274,6 +413,8 @@ void GUI_View::calculateOffsets() {
 
 void GUI_View::loadNextLevel() {
     if (!_gameLogic) return;
+
+    _hintEngine.cancel();
     
     _currentLevel++;
     
@@ -286,19 +427,11 @@ void GUI_View::loadNextLevel() {
     
     try {
         _gameLogic->loadLevel(_currentLevel);
-        
-        int mapWidth = _gameLogic->getLevelWidth();
-        int mapHeight = _gameLogic->getLevelLength();
-        
-        int maxTileWidth = (_screenWidth - 100) / mapWidth;
-        int maxTileHeight = (_screenHeight - 150) / mapHeight;
-        _tileSize = std::min(maxTileWidth, maxTileHeight);
-        _tileSize = std::max(32, std::min(_tileSize, 64));
-        
-        calculateOffsets();
+        fitTileSize();
         
         _statusMessage = "Level " + std::to_string(_currentLevel) + " loaded!";
         std::cout << "Loaded level " << _currentLevel << "\n";
+        prefetchNextLevel();
         
     } catch (const std::exception& e) {
         _statusMessage = "Failed to load level " + std::to_string(_currentLevel);
@@ -307,9 +440,53 @@ void GUI_View::loadNextLevel() {
     }
 }
 
+void GUI_View::reloadEditedLevel() {
+    // The game keeps its own copy of the map, so an edit only takes effect
+    // here; a level that no longer loads leaves the current game running.
+    try {
+        _gameLogic->loadLevel(_currentLevel);
+        fitTileSize();
+        _statusMessage = "Level " + std::to_string(_currentLevel) + " changed on disk and was reloaded";
+        std::cout << "Reloaded edited level " << _currentLevel << "\n";
+    } catch (const std::exception& e) {
+        _statusMessage = "Level " + std::to_string(_currentLevel) + " was edited but failed to load";
+        std::cerr << "Error reloading level: " << e.what() << "\n";
+    }
+}
+
+void GUI_View::fitTileSize() {
+    int mapWidth = _gameLogic->getLevelWidth();
+    int mapHeight = _gameLogic->getLevelLength();
+
+    int maxTileWidth = (_screenWidth - 100) / mapWidth;
+    int maxTileHeight = (_screenHeight - 150) / mapHeight;
+    _tileSize = std::min(maxTileWidth, maxTileHeight);
+    _tileSize = std::max(32, std::min(_tileSize, 64));
+
+    calculateOffsets();
+}
+
+void GUI_View::prefetchNextLevel() {
+    // Parses the next level while this one is played so pressing N only
+    // copies an already built map.
+    int nextLevel = _currentLevel + 1;
+    _levelPrefetch = std::async(std::launch::async, [nextLevel]() {
+        LevelIndex::shared().prefetch(nextLevel);
+    });
+}
+
 Vector2 GUI_View::getTileScreenPosition(int row, int col) const {
     return Vector2{
         (float)(_offsetX + col * _tileSize),
         (float)(_offsetY + row * _tileSize)
     };
+}
+
+Vector2 GUI_View::getInterpolatedScreenPosition(Position from, Position to, float alpha) const {
+    Vector2 start = getTileScreenPosition(from.getRow(), from.getCol());
+    Vector2 end = getTileScreenPosition(to.getRow(), to.getCol());
+    return Vector2{
+        start.x + (end.x - start.x) * alpha,
+        start.y + (end.y - start.y) * alpha
+    };
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "SpriteAtlas.h"
+#include <rlgl.h>
+#include <algorithm>
+
+namespace {
+    // Empty pixels around every sprite so bilinear filtering never samples
+    // a neighbour when the board is scaled.
+    const int Gutter = 2;
+    // rlgl flushes its vertex buffer by itself; this only bounds how much
+    // is reserved at once.
+    const int QuadsPerRun = 1024;
+
+    const Color TileBorder = Color{200, 180, 130, 255};
+
+    void paintFloor(Image& atlas, Rectangle cell, Color floor) {
+        ImageDrawRectangleRec(&atlas, cell, floor);
+        ImageDrawRectangleLines(&atlas, cell, 1, TileBorder);
+    }
+
+    void paintImage(Image& atlas, const Image& source, Rectangle cell) {
+        Rectangle sourceRec = {0.0f, 0.0f, (float)source.width, (float)source.height};
+        ImageDraw(&atlas, source, sourceRec, cell, WHITE);
+    }
+}
+
+SpriteAtlas::SpriteAtlas()
+    : _texture(Texture2D{}),
+      _sources() {}
+
+void SpriteAtlas::build(const Image& car, const Image& parking, const SpritePalette& palette) {
+    unload();
+
+    const int stride = SpriteSize + 2 * Gutter;
+    Image atlas = GenImageColor(stride * SpriteCount, stride, BLANK);
+    for (int i = 0; i < SpriteCount; ++i) {
+        _sources[i] = Rectangle{(float)(i * stride + Gutter), (float)Gutter, (float)SpriteSize, (float)SpriteSize};
+    }
+    const float size = (float)SpriteSize;
+
+    // The shapes are the ones the board used to draw tile by tile, at the
+    // largest tile size.
+    Rectangle wall = getSource(ESprite::WALL);
+    ImageDrawRectangleRec(&atlas, wall, palette.wall);
+    const int stoneSize = SpriteSize / 4;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            Rectangle stone = {
+                wall.x + (i * stoneSize * 1.1f) + 2,
+                wall.y + (j * stoneSize * 1.1f) + 2,
+                (float)stoneSize - 2,
+                (float)stoneSize - 2
+            };
+            ImageDrawRectangleRec(&atlas, stone, Color{80, 80, 80, 255});
+            ImageDrawRectangleLines(&atlas, stone, 1, Color{60, 60, 60, 255});
+        }
+    }
+
+    paintFloor(atlas, getSource(ESprite::FLOOR), palette.floor);
+
+    Rectangle target = getSource(ESprite::TARGET);
+    ImageDrawRectangleRec(&atlas, target, palette.floor);
+    if (parking.data != nullptr) {
+        paintImage(atlas, parking, target);
+    } else {
+        ImageDrawCircle(&atlas, (int)(target.x + size / 2), (int)(target.y + size / 2), (int)(size / 3), palette.target);
+    }
+    ImageDrawRectangleLines(&atlas, target, 1, TileBorder);
+
+    const ESprite boxes[2] = {ESprite::BOX, ESprite::BOX_ON_TARGET};
+    for (ESprite sprite : boxes) {
+        Rectangle box = getSource(sprite);
+        ImageDrawRectangleRec(&atlas, box, palette.floor);
+        if (car.data != nullptr) {
+            paintImage(atlas, car, box);
+        } else {
+            float padding = size * 0.1f;
+            Rectangle inner = {box.x + padding, box.y + padding, size - 2 * padding, size - 2 * padding};
+            ImageDrawRectangleRec(&atlas, inner, sprite == ESprite::BOX_ON_TARGET ? palette.boxOnTarget : palette.box);
+            ImageDrawRectangleLines(&atlas, inner, 2, Color{150, 80, 0, 255});
+        }
+    }
+
+    Rectangle player = getSource(ESprite::PLAYER);
+    Vector2 center = {player.x + size / 2, player.y + size / 2};
+    float playerSize = size * 0.6f;
+    ImageDrawCircle(&atlas, (int)center.x, (int)(center.y + playerSize / 6), (int)(playerSize / 3), palette.player);
+    ImageDrawCircle(&atlas, (int)center.x, (int)(center.y - playerSize / 4), (int)(playerSize / 4), BROWN);
+    ImageDrawCircle(&atlas, (int)(center.x - playerSize / 10), (int)(center.y - playerSize / 4 - 2), 2, BLACK);
+    ImageDrawCircle(&atlas, (int)(center.x + playerSize / 10), (int)(center.y - playerSize / 4 - 2), 2, BLACK);
+    ImageDrawRectangleRec(&atlas, Rectangle{center.x - playerSize / 8, center.y + playerSize / 3, playerSize / 7, playerSize / 4},
+                          palette.player);
+    ImageDrawRectangleRec(&atlas, Rectangle{center.x + playerSize / 16, center.y + playerSize / 3, playerSize / 7, playerSize / 4},
+                          palette.player);
+
+    _texture = LoadTextureFromImage(atlas);
+    SetTextureFilter(_texture, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(atlas);
+}
+
+void SpriteAtlas::unload() {
+    if (_texture.id != 0) {
+        UnloadTexture(_texture);
+        _texture = Texture2D{};
+    }
+}
+
+SpriteBatch::SpriteBatch(const SpriteAtlas& atlas)
+    : _atlas(atlas),
+      _viewWidth(0.0f),
+      _viewHeight(0.0f) {}
+
+void SpriteBatch::begin(float viewWidth, float viewHeight) {
+    _quads.clear();
+    _viewWidth = viewWidth;
+    _viewHeight = viewHeight;
+}
+
+void SpriteBatch::add(ESprite sprite, Rectangle dest) {
+    if (dest.x + dest.width < 0 || dest.y + dest.height < 0 || dest.x > _viewWidth || dest.y > _viewHeight) {
+        return;
+    }
+    _quads.push_back(Quad{_atlas.getSource(sprite), dest});
+}
+
+void SpriteBatch::flush() {
+    const Texture2D& texture = _atlas.getTexture();
+    if (_quads.empty() || texture.id == 0) {
+        _quads.clear();
+        return;
+    }
+    const float width = (float)texture.width;
+    const float height = (float)texture.height;
+
+    // Same vertex order as DrawTexturePro, without its per-call setup.
+    rlSetTexture(texture.id);
+    for (size_t first = 0; first < _quads.size(); first += QuadsPerRun) {
+        size_t last = std::min(_quads.size(), first + QuadsPerRun);
+        rlCheckRenderBatchLimit(static_cast<int>(4 * (last - first)));
+        rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (size_t i = first; i < last; ++i) {
+            const Rectangle& src = _quads[i].source;
+            const Rectangle& dst = _quads[i].dest;
+            float left = src.x / width;
+            float right = (src.x + src.width) / width;
+            float top = src.y / height;
+            float bottom = (src.y + src.height) / height;
+
+            rlTexCoord2f(left, top);
+            rlVertex2f(dst.x, dst.y);
+            rlTexCoord2f(left, bottom);
+            rlVertex2f(dst.x, dst.y + dst.height);
+            rlTexCoord2f(right, bottom);
+            rlVertex2f(dst.x + dst.width, dst.y + dst.height);
+            rlTexCoord2f(right, top);
+            rlVertex2f(dst.x + dst.width, dst.y);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+    _quads.clear();
+}